@@ -0,0 +1,179 @@
+// Benchmark: work-precision data for every integrator of hamzstlab_ode.h and
+// hamzstlab_stiff.h over a catalogue of reference problems.
+//
+//   make
+//   ./main [ode_benchmark.csv]     runs the suite, writes the CSV
+//   ./viewer [ode_benchmark.csv]   log-log plots of the CSV
+//
+// Fixed-step methods sweep h, adaptive ones sweep the tolerance. Each run
+// reports the error at the end time against the exact solution (or a tight
+// reference solve), f evaluations and the best wall time of a few repeats.
+// Runs that do not reach the end (explicit methods on the stiff problem), or
+// reach it with an error larger than the solution, are written with success = 0.
+
+#include "hamzstlab_ode.h"
+#include "hamzstlab_stiff.h"
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static double Seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// y' = 3 - 2t - 0.5y, y(0) = 1
+struct Ivp {
+    void operator()(double t, const double* y, double* dydt) const { dydt[0] = 3 - 2 * t - 0.5 * y[0]; }
+};
+
+// y' = r y (1 - y/K) with r = 0.8, K = 5, y(0) = 1
+struct Logistic {
+    void operator()(double, const double* y, double* dydt) const { dydt[0] = 0.8 * y[0] * (1 - y[0] / 5); }
+};
+
+// x'' = -x as x' = v, v' = -x, (x, v)(0) = (0, 1)
+struct Harmonic {
+    void operator()(double, const double* y, double* dydt) const { dydt[0] = y[1]; dydt[1] = -y[0]; }
+};
+
+struct Lorenz {
+    void operator()(double, const double* y, double* dydt) const {
+        dydt[0] = 10 * (y[1] - y[0]);
+        dydt[1] = y[0] * (28 - y[2]) - y[1];
+        dydt[2] = y[0] * y[1] - 8.0 / 3 * y[2];
+    }
+};
+
+// Robertson's chemical kinetics
+struct Robertson {
+    void operator()(double, const double* y, double* dydt) const {
+        dydt[0] = -0.04 * y[0] + 1e4 * y[1] * y[2];
+        dydt[2] = 3e7 * y[1] * y[1];
+        dydt[1] = -dydt[0] - dydt[2];
+    }
+};
+
+struct Problem {
+    const char*         Name;
+    int                 Dim;
+    double              T1;
+    std::vector<double> Y0, Exact;   // Exact: state at T1
+    bool                Stiff;
+};
+
+// Relative error beyond which a run counts as failed (Lorenz with Euler at
+// h = 0.2 ends at 5.7e22).
+static const double MaxError = 1;
+
+// Methods are numbered explicit first, then implicit.
+static const int MethodCount = Hamzstlab::OdeMethod_COUNT + Hamzstlab::StiffMethod_COUNT;
+
+static const char* MethodName(int m) {
+    return m < Hamzstlab::OdeMethod_COUNT ? Hamzstlab::OdeMethodName(m) : Hamzstlab::StiffMethodName(m - Hamzstlab::OdeMethod_COUNT);
+}
+
+template <class F>
+static Hamzstlab::OdeResult Solve(int m, const F& f, const Problem& p, const Hamzstlab::OdeOptions& opt) {
+    if (m < Hamzstlab::OdeMethod_COUNT)
+        return Hamzstlab::SolveOde(m, f, 0.0, p.Y0.data(), p.Dim, p.T1, opt);
+    return Hamzstlab::SolveStiff(m - Hamzstlab::OdeMethod_COUNT, f, 0.0, p.Y0.data(), p.Dim, p.T1, opt);
+}
+
+// One row per (method, h or tol): repeats until 20 ms have passed (at most 50 times) and keeps the fastest.
+template <class F>
+static void Run(FILE* csv, const F& f, const Problem& p) {
+    for (int m = 0; m < MethodCount; ++m) {
+        const bool fixed = m < Hamzstlab::OdeMethod_COUNT && !Hamzstlab::OdeMethodAdaptive(m);
+        for (int k = 0; k < 10; ++k) {
+            Hamzstlab::OdeOptions opt;
+            double param;
+            if (fixed) {
+                param = p.T1 / (10.0 * pow(2.0, k));        // h = T1/10 ... T1/5120
+                opt.H = param;
+            }
+            else {
+                param = pow(10.0, -2.0 - k);                // tol = 1e-2 ... 1e-11
+                opt.H = 0;
+                opt.RelTol = param;
+                opt.AbsTol = p.Stiff ? 1e-6 * param : param;
+            }
+            opt.MaxSteps = 200000;
+            Hamzstlab::OdeResult r;
+            double best = 1e300, spent = 0;
+            for (int rep = 0; rep < 50 && spent < 0.02; ++rep) {
+                Clock::time_point t0 = Clock::now();
+                r = Solve(m, f, p, opt);
+                double s = Seconds(t0);
+                best = s < best ? s : best;
+                spent += s;
+                if (!r.Success) break;
+            }
+            double err = 0;
+            const double* y = r.Y(r.Size() - 1);
+            for (int i = 0; i < p.Dim; ++i) {
+                double e = fabs(y[i] - p.Exact[i]) / (1 + fabs(p.Exact[i]));
+                err = e > err || e != e ? e : err;   // keeps NaN, unlike fmax
+            }
+            // a fixed-step method that blew up did not finish either, and an
+            // error above the scale of the solution itself is no answer
+            const bool ok = r.Success && std::isfinite(err) && err <= MaxError;
+            const double shown = err;
+            if (!ok)
+                err = NAN;
+            fprintf(csv, "%s,%s,%.3e,%d,%d,%d,%d,%d,%.6e,%.6e,%d\n", p.Name, MethodName(m), param, r.Steps, r.Rejected,
+                    r.Evaluations, r.Jacobians, r.Factorizations, best, err, ok ? 1 : 0);
+            printf("%-10s %-24s %s %9.2e  evals %9d  %10.3f ms  error %9.2e%s\n", p.Name, MethodName(m), fixed ? "h  " : "tol", param,
+                   r.Evaluations, best * 1e3, shown, ok ? "" : (r.Success ? "  (failed)" : "  (did not finish)"));
+            // finer settings of an adaptive method that already fails only cost time
+            if (!r.Success) break;
+        }
+    }
+}
+
+int main(int argc, char const* argv[]) {
+    const char* path = argc > 1 ? argv[1] : "ode_benchmark.csv";
+    FILE* csv = fopen(path, "w");
+    if (!csv) {
+        printf("cannot write %s\n", path);
+        return 1;
+    }
+    fprintf(csv, "problem,method,param,steps,rejected,evaluations,jacobians,factorizations,seconds,error,success\n");
+
+    Problem ivp = { "IVP", 1, 10, std::vector<double>(1, 1.0), std::vector<double>(1, 14 - 40 - 13 * exp(-5.0)), false };
+    Run(csv, Ivp(), ivp);
+
+    Problem logistic = { "Logistic", 1, 10, std::vector<double>(1, 1.0), std::vector<double>(1, 5 / (1 + 4 * exp(-8.0))), false };
+    Run(csv, Logistic(), logistic);
+
+    Problem harmonic = { "Harmonic", 2, 20, std::vector<double>(), std::vector<double>(), false };
+    harmonic.Y0.push_back(0); harmonic.Y0.push_back(1);
+    harmonic.Exact.push_back(sin(20.0)); harmonic.Exact.push_back(cos(20.0));
+    Run(csv, Harmonic(), harmonic);
+
+    // no closed form: a tight RK45 solve; kept short since errors grow like exp(0.9 t)
+    Problem lorenz = { "Lorenz", 3, 2, std::vector<double>(3, 1.0), std::vector<double>(), false };
+    {
+        Hamzstlab::OdeOptions opt;
+        opt.H = 0; opt.RelTol = 1e-14; opt.AbsTol = 1e-14;
+        Hamzstlab::OdeResult r = Hamzstlab::SolveOde(Hamzstlab::OdeMethod_RK45, Lorenz(), 0.0, lorenz.Y0.data(), 3, lorenz.T1, opt);
+        lorenz.Exact.assign(r.Y(r.Size() - 1), r.Y(r.Size() - 1) + 3);
+    }
+    Run(csv, Lorenz(), lorenz);
+
+    Problem robertson = { "Robertson", 3, 40, std::vector<double>(), std::vector<double>(), true };
+    robertson.Y0.push_back(1); robertson.Y0.push_back(0); robertson.Y0.push_back(0);
+    // the published reference state at t = 40 rather than a solve by one of the
+    // methods under test; Rosenbrock at RelTol 1e-13 reproduces it to 1e-12
+    robertson.Exact.push_back(0.7158270687193135);
+    robertson.Exact.push_back(9.185534764529788e-06);
+    robertson.Exact.push_back(0.2841637457459220);
+    Run(csv, Robertson(), robertson);
+
+    fclose(csv);
+    printf("wrote %s\n", path);
+    return 0;
+}
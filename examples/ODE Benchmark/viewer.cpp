@@ -0,0 +1,143 @@
+// Work-precision viewer for the CSV written by ./main: error against f
+// evaluations and against wall time on log-log axes, one line per method.
+//
+//   ./viewer [ode_benchmark.csv]
+
+#include "App.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct BenchmarkRow {
+    std::string Problem, Method;
+    double      Param, Seconds, Error;
+    int         Steps, Evaluations;
+    bool        Success;
+};
+
+static bool LoadBenchmark(const char* path, std::vector<BenchmarkRow>& rows) {
+    FILE* f = fopen(path, "r");
+    if (!f)
+        return false;
+    rows.clear();
+    char line[512];
+    if (!fgets(line, sizeof(line), f)) { fclose(f); return false; }   // header
+    while (fgets(line, sizeof(line), f)) {
+        // problem,method,param,steps,rejected,evaluations,jacobians,factorizations,seconds,error,success
+        char* fields[11];
+        int n = 0;
+        for (char* p = strtok(line, ",\r\n"); p && n < 11; p = strtok(nullptr, ",\r\n"))
+            fields[n++] = p;
+        if (n < 11)
+            continue;
+        BenchmarkRow r;
+        r.Problem     = fields[0];
+        r.Method      = fields[1];
+        r.Param       = atof(fields[2]);
+        r.Steps       = atoi(fields[3]);
+        r.Evaluations = atoi(fields[5]);
+        r.Seconds     = atof(fields[8]);
+        r.Error       = atof(fields[9]);
+        r.Success     = atoi(fields[10]) != 0;
+        rows.push_back(r);
+    }
+    fclose(f);
+    return true;
+}
+
+struct BenchmarkViewer : App {
+    using App::App;
+    char                      Path[256];
+    std::vector<BenchmarkRow> Rows;
+    std::vector<std::string>  Problems, Methods;
+    int                       Problem;
+    bool                      Loaded;
+
+    void Load() {
+        Loaded = LoadBenchmark(Path, Rows);
+        Problems.clear();
+        Methods.clear();
+        for (size_t i = 0; i < Rows.size(); ++i) {
+            if (std::find(Problems.begin(), Problems.end(), Rows[i].Problem) == Problems.end()) Problems.push_back(Rows[i].Problem);
+            if (std::find(Methods.begin(), Methods.end(), Rows[i].Method) == Methods.end())    Methods.push_back(Rows[i].Method);
+        }
+        if (Problem >= (int)Problems.size()) Problem = 0;
+    }
+
+    // Successful runs of one method on the selected problem, in file order.
+    void Series(const std::string& method, bool time, ImVector<double>& xs, ImVector<double>& ys) const {
+        xs.resize(0);
+        ys.resize(0);
+        for (size_t i = 0; i < Rows.size(); ++i) {
+            const BenchmarkRow& r = Rows[i];
+            if (!r.Success || r.Problem != Problems[Problem] || r.Method != method || !(r.Error > 0))
+                continue;
+            xs.push_back(time ? r.Seconds * 1e3 : (double)r.Evaluations);
+            ys.push_back(r.Error);
+        }
+    }
+
+    void Plot(const char* title, const char* xlabel, bool time) const {
+        if (ImPlot::BeginPlot(title, ImVec2(-1, 0))) {
+            ImPlot::SetupAxes(xlabel, "error at end time", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+            ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+            ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+            ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
+            ImVector<double> xs, ys;
+            for (size_t m = 0; m < Methods.size(); ++m) {
+                Series(Methods[m], time, xs, ys);
+                ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
+                ImPlot::PlotLine(Methods[m].c_str(), xs.Data, ys.Data, xs.Size);
+            }
+            ImPlot::EndPlot();
+        }
+    }
+
+    void Start() override {
+        Problem = 0;
+        Load();
+    }
+
+    void Update() override {
+        ImGui::SetNextWindowPos(ImVec2(0, 0));
+        ImGui::SetNextWindowSize(GetWindowSize());
+        ImGui::Begin("ODE Work-Precision", nullptr, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoTitleBar);
+        ImGui::SetNextItemWidth(400);
+        ImGui::InputText("CSV", Path, sizeof(Path));
+        ImGui::SameLine();
+        if (ImGui::Button("Reload"))
+            Load();
+        if (!Loaded) {
+            ImGui::Text("Cannot read %s; run ./main first.", Path);
+            ImGui::End();
+            return;
+        }
+        ImGui::SetNextItemWidth(200);
+        if (ImGui::BeginCombo("Problem", Problems.empty() ? "" : Problems[Problem].c_str())) {
+            for (int i = 0; i < (int)Problems.size(); ++i)
+                if (ImGui::Selectable(Problems[i].c_str(), i == Problem))
+                    Problem = i;
+            ImGui::EndCombo();
+        }
+        ImGui::SameLine();
+        ImGui::Text("%d runs", (int)Rows.size());
+        if (!Problems.empty()) {
+            Plot("Error vs RHS evaluations", "f evaluations", false);
+            Plot("Error vs wall time", "time (ms)", true);
+        }
+        ImGui::End();
+    }
+};
+
+int main(int argc, char const *argv[])
+{
+    BenchmarkViewer app("ODE Benchmark", 1600, 1000, argc, argv);
+    snprintf(app.Path, sizeof(app.Path), "%s", argc > 1 ? argv[1] : "ode_benchmark.csv");
+    app.Run();
+
+    return 0;
+}
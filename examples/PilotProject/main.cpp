@@ -14,6 +14,7 @@
 #include <stdio.h>
 
 #include "implot.h"
+#include "hamzstlab_random.h"
 
 #define CHECKBOX_FLAG(flags, flag) ImGui::CheckboxFlags(#flag, (unsigned int*)&flags, flag)
 
@@ -33,30 +34,13 @@
 #endif
 
 double RandomGauss() {
-	static double V1, V2, S;
-	static int phase = 0;
-	double X;
-	if(phase == 0) {
-		do {
-			double U1 = (double)rand() / RAND_MAX;
-			double U2 = (double)rand() / RAND_MAX;
-			V1 = 2 * U1 - 1;
-			V2 = 2 * U2 - 1;
-			S = V1 * V1 + V2 * V2;
-			} while(S >= 1 || S == 0);
-
-		X = V1 * sqrt(-2 * log(S) / S);
-	} else
-		X = V2 * sqrt(-2 * log(S) / S);
-	phase = 1 - phase;
-	return X;
+	return Hamzstlab::Normal(Hamzstlab::ThreadEngine());
 }
 
 template <int N>
 struct NormalDistribution {
     NormalDistribution(double mean, double sd) {
-        for (int i = 0; i < N; ++i)
-            Data[i] = RandomGauss()*sd + mean;
+        Hamzstlab::FillNormal(Hamzstlab::ThreadEngine(), Data, N, mean, sd);
     }
     double Data[N];
 };
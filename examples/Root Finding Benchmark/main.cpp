@@ -0,0 +1,158 @@
+// Benchmark: evaluating SymbolicC++ expressions by substitution (f[x==v])
+// against the compiled evaluator in hamzstlab_compiledexpr.h, and symbolic
+// df() against the dual numbers of hamzstlab_autodiff.h for Newton's method.
+//
+//   make
+//   ./main
+
+#include "symintegrationc++.h"
+#include "hamzstlab_compiledexpr.h"
+#include "hamzstlab_autodiff.h"
+
+#include <chrono>
+#include <stdio.h>
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static double Seconds(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// Runs both evaluation paths over the same points and prints ns/evaluation.
+static void Compare(const char* name, const Symbolic& f, const Symbolic& x, int n_sub, int n_comp) {
+    Hamzstlab::CompiledExpr F(f, x);
+    double sink = 0;
+
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < n_sub; ++i)
+        sink += double(f[x == Symbolic(0.5 + i * 1e-6)]);
+    double t_sub = Seconds(t0) / n_sub;
+
+    t0 = Clock::now();
+    for (int i = 0; i < n_comp; ++i)
+        sink += F(0.5 + i * 1e-6);
+    double t_comp = Seconds(t0) / n_comp;
+
+    std::vector<double> xs(n_comp), ys(n_comp);
+    for (int i = 0; i < n_comp; ++i)
+        xs[i] = 0.5 + i * 1e-6;
+    t0 = Clock::now();
+    F.Eval(xs.data(), ys.data(), n_comp);
+    double t_batch = Seconds(t0) / n_comp;
+    sink += ys[n_comp / 2];
+
+    double err = std::fabs(double(f[x == Symbolic(0.75)]) - F(0.75));
+    printf("%-28s substitution %10.1f ns | compiled %7.2f ns (%7.0fx) | batch %6.2f ns (%7.0fx) | |diff| %.1e | ops %d, %d substituted%s\n",
+           name, t_sub * 1e9, t_comp * 1e9, t_sub / t_comp, t_batch * 1e9, t_sub / t_batch, err, F.Size(), F.SubstituteCount(),
+           t_sub / t_comp < 50 ? " | BELOW 50x" : "");
+    if (sink == 12345.678)
+        printf(" ");
+}
+
+struct CosMinusX {
+    template <typename T> T operator()(const T& x) const { using std::cos; return cos(x) - x; }
+};
+
+// f and f' of cos(x) - x: symbolic df() by substitution, compiled f and df(),
+// dual numbers and hyper-dual numbers (f, f', f''); then full Newton/Halley solves.
+static void CompareDerivatives(int n_sub, int n_ad) {
+    Symbolic x("x");
+    Symbolic f = cos(x) - x, fd = df(f, x);
+    Hamzstlab::CompiledExpr F, FD;
+    Hamzstlab::CompileWithDerivative(f, x, F, FD);
+    CosMinusX g;
+    double sink = 0;
+
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < n_sub; ++i) {
+        Equation e = (x == Symbolic(0.5 + i * 1e-6));
+        sink += double(f[e]) / double(fd[e]);
+    }
+    double t_sub = Seconds(t0) / n_sub;
+
+    t0 = Clock::now();
+    for (int i = 0; i < n_ad; ++i) {
+        double v = 0.5 + i * 1e-6;
+        sink += F(v) / FD(v);
+    }
+    double t_comp = Seconds(t0) / n_ad;
+
+    t0 = Clock::now();
+    for (int i = 0; i < n_ad; ++i) {
+        Hamzstlab::Dual<double> d = g(Hamzstlab::Dual<double>(0.5 + i * 1e-6, 1.0));
+        sink += d.Val / d.Der;
+    }
+    double t_dual = Seconds(t0) / n_ad;
+
+    t0 = Clock::now();
+    for (int i = 0; i < n_ad; ++i)
+        sink += g(0.5 + i * 1e-6);
+    double t_plain = Seconds(t0) / n_ad;
+
+    t0 = Clock::now();
+    for (int i = 0; i < n_ad; ++i) {
+        Hamzstlab::HyperDual<double> h = g(Hamzstlab::HyperDual<double>(0.5 + i * 1e-6, 1.0, 1.0, 0.0));
+        sink += h.E12;
+    }
+    double t_hyper = Seconds(t0) / n_ad;
+
+    printf("\nf(x)/f'(x) for cos(x) - x, per point\n");
+    printf("  symbolic df(), substitution %10.1f ns\n", t_sub * 1e9);
+    printf("  compiled f and df()         %10.2f ns (%7.0fx)\n", t_comp * 1e9, t_sub / t_comp);
+    printf("  dual numbers                %10.2f ns (%7.0fx, %.1f plain evaluations)\n", t_dual * 1e9, t_sub / t_dual, t_dual / t_plain);
+    printf("  hyper-dual (f, f', f'')     %10.2f ns (%7.0fx, %.1f plain evaluations)\n", t_hyper * 1e9, t_sub / t_hyper, t_hyper / t_plain);
+
+    // complete solves from p0 = pi/4 to 1e-15
+    const int n_solve = 20000;
+    Hamzstlab::RootOptions opt(1e-15);
+    Hamzstlab::RootResult r;
+    t0 = Clock::now();
+    for (int i = 0; i < n_solve / 100; ++i) {
+        double p = 0.785398 + i * 1e-9;
+        for (int k = 0; k < 6; ++k) {
+            Equation e = (x == Symbolic(p));
+            p -= double(f[e]) / double(fd[e]);
+        }
+        sink += p;
+    }
+    double s_sub = Seconds(t0) / (n_solve / 100);
+    t0 = Clock::now();
+    for (int i = 0; i < n_solve; ++i) { r = Hamzstlab::Newton(F, FD, 0.785398 + i * 1e-9, opt); sink += r.Root; }
+    double s_comp = Seconds(t0) / n_solve;
+    t0 = Clock::now();
+    for (int i = 0; i < n_solve; ++i) { r = Hamzstlab::NewtonAD(g, 0.785398 + i * 1e-9, opt); sink += r.Root; }
+    double s_dual = Seconds(t0) / n_solve;
+    int it_dual = r.Iterations;
+    t0 = Clock::now();
+    for (int i = 0; i < n_solve; ++i) { r = Hamzstlab::HalleyAD(g, 0.785398 + i * 1e-9, opt); sink += r.Root; }
+    double s_hyper = Seconds(t0) / n_solve;
+
+    printf("\nNewton solve of cos(x) - x = 0 from pi/4\n");
+    printf("  symbolic df(), 6 steps      %10.2f us\n", s_sub * 1e6);
+    printf("  compiled f and df()         %10.3f us (%7.0fx)\n", s_comp * 1e6, s_sub / s_comp);
+    printf("  NewtonAD, %d steps           %10.3f us (%7.0fx)\n", it_dual, s_dual * 1e6, s_sub / s_dual);
+    printf("  HalleyAD, %d steps           %10.3f us (%7.0fx), root %.16f\n", r.Iterations, s_hyper * 1e6, s_sub / s_hyper, r.Root);
+    if (sink == 12345.678)
+        printf(" ");
+}
+
+int main() {
+    Symbolic x("x");
+    const int n_sub  = 20000;
+    const int n_comp = 2000000;
+
+    Symbolic f1 = cos(x) - x;
+    Symbolic f2 = pow(x,Symbolic(3)) + 4*pow(x,Symbolic(2)) - 10;
+    Symbolic f3 = exp(-x) * sin(3*x) + sqrt(x) - ln(x + 2);
+
+    printf("Per-evaluation cost, %d substitutions vs %d compiled evaluations\n", n_sub, n_comp);
+    Compare("cos(x) - x", f1, x, n_sub, n_comp);
+    Compare("d/dx [cos(x) - x]", df(f1, x), x, n_sub, n_comp);
+    Compare("x^3 + 4x^2 - 10", f2, x, n_sub, n_comp);
+    Compare("d/dx [x^3 + 4x^2 - 10]", df(f2, x), x, n_sub, n_comp);
+    Compare("exp(-x)sin(3x)+sqrt(x)-ln(x+2)", f3, x, n_sub, n_comp);
+    Compare("d/dx of the above", df(f3, x), x, n_sub, n_comp);
+
+    CompareDerivatives(n_sub, n_comp);
+    return 0;
+}
@@ -0,0 +1,527 @@
+// MIT License
+
+// Copyright (c) 2023 Evan Pezent
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// ImPlot v0.17
+
+// We define this so that the demo does not accidentally use deprecated API
+#ifndef IMPLOT_DISABLE_OBSOLETE_FUNCTIONS
+#define IMPLOT_DISABLE_OBSOLETE_FUNCTIONS
+#endif
+
+#include "implot.h"
+#ifndef IMGUI_DISABLE
+#include <math.h>
+#include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hamzstlab_fourier.h"
+#include "hamzstlab_interpolation.h"
+#include "hamzstlab_random.h"
+#include <algorithm>
+#include <chrono>
+
+#ifdef _MSC_VER
+#define sprintf sprintf_s
+#endif
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+#if !defined(IMGUI_DISABLE_DEMO_WINDOWS)
+
+namespace ImPlot {
+
+//-----------------------------------------------------------------------------
+// [SECTION] Demo Functions
+//-----------------------------------------------------------------------------
+
+void Demo_Help() {
+    ImGui::Text("ABOUT THIS DEMO:");
+    ImGui::BulletText("We are demonstrating approximation of functions and data with cubic splines, Lagrange interpolation and Fourier series");
+    ImGui::Separator();
+    ImGui::Text("PROGRAMMER GUIDE:");
+    ImGui::BulletText("See the ShowApproximationWindow() code in hamzstlab_approximation.cpp. <- you are here!");
+    ImGui::BulletText("If you see visual artifacts, do one of the following:");
+    ImGui::Indent();
+    ImGui::BulletText("Handle ImGuiBackendFlags_RendererHasVtxOffset for 16-bit indices in your backend.");
+    ImGui::BulletText("Or, enable 32-bit indices in imconfig.h.");
+    ImGui::BulletText("Your current configuration is:");
+    ImGui::Indent();
+    ImGui::BulletText("ImDrawIdx: %d-bit", (int)(sizeof(ImDrawIdx) * 8));
+    ImGui::BulletText("ImGuiBackendFlags_RendererHasVtxOffset: %s", (ImGui::GetIO().BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset) ? "True" : "False");
+    ImGui::Unindent();
+    ImGui::Unindent();
+    ImGui::Separator();
+    ImGui::Text("USER GUIDE:");
+    ShowUserGuide();
+}
+
+//-----------------------------------------------------------------------------
+
+void Demo_Config() {
+    ImGui::ShowFontSelector("Font");
+    ImGui::ShowStyleSelector("ImGui Style");
+    ImPlot::ShowStyleSelector("ImPlot Style");
+    ImPlot::ShowColormapSelector("ImPlot Colormap");
+    ImPlot::ShowInputMapSelector("Input Map");
+}
+
+
+//-----------------------------------------------------------------------------
+
+static const char* ApproxFunctionNames[] = { "f(x) = 1 / (1 + 25x^2)", "f(x) = sin(2 pi x)", "f(x) = |x|", "f(x) = exp(x) cos(6x)" };
+
+double ApproxFunction(int func, double x) {
+    switch (func) {
+        case 1:  return sin(2 * PI * x);
+        case 2:  return fabs(x);
+        case 3:  return exp(x) * cos(6 * x);
+        default: return 1 / (1 + 25 * x * x);
+    }
+}
+
+struct ApproxFunctor {
+    int Func;
+    double operator()(double x) const { return ApproxFunction(Func, x); }
+};
+
+// f(x) on a fixed grid over [-1,1], for the reference curves and the error.
+static void ApproxReference(int func, ImVector<double>& xs, ImVector<double>& ys) {
+	xs.resize(1001);
+	ys.resize(1001);
+	for (int i = 0; i < xs.Size; ++i) {
+		xs[i] = -1 + 2.0 * i / (xs.Size - 1);
+		ys[i] = ApproxFunction(func, xs[i]);
+	}
+}
+
+void Demo_CubicSplines() {
+	static int func = 0;
+	static int knots = 9;
+	static int boundary = Hamzstlab::SplineBoundary_Natural;
+	static ImVector<double> kx, ky, fx, fy, sy;
+	static Hamzstlab::CubicSpline spline;
+	static int key_func = -1, key_knots = 0;
+	static bool dragged = false;
+	static bool dirty = true;
+
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("f(x)", &func, ApproxFunctionNames, IM_ARRAYSIZE(ApproxFunctionNames));
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderInt("Knots", &knots, 2, 40);
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::Combo("End condition", &boundary, "Natural\0Clamped\0Not-a-knot\0");
+	ImGui::SameLine();
+	const bool reset = ImGui::Button("Reset knots");
+
+	if (func != key_func || knots != key_knots || reset) {
+		kx.resize(knots);
+		ky.resize(knots);
+		for (int i = 0; i < knots; ++i) {
+			kx[i] = -1 + 2.0 * i / (knots - 1);
+			ky[i] = ApproxFunction(func, kx[i]);
+		}
+		ApproxReference(func, fx, fy);
+		key_func = func; key_knots = knots;
+		dragged = false;
+		dirty = true;
+	}
+	if (dirty) {
+		// clamped ends take the slopes of f, by central differences
+		const double d = 1e-6;
+		const double dy0 = (ApproxFunction(func, -1 + d) - ApproxFunction(func, -1 - d)) / (2 * d);
+		const double dyn = (ApproxFunction(func, 1 + d) - ApproxFunction(func, 1 - d)) / (2 * d);
+		spline.Build(kx.Data, ky.Data, knots, boundary, dy0, dyn);
+		sy.resize(fx.Size);
+		spline.Evaluate(fx.Data, sy.Data, fx.Size);
+		dirty = false;
+	}
+	double err = 0;
+	for (int i = 0; i < fx.Size; ++i)
+		err = fmax(err, fabs(sy[i] - fy[i]));
+	if (dragged) ImGui::Text("Knots moved by hand; Reset knots to compare with f(x) again");
+	else         ImGui::Text("max |s(x) - f(x)| = %.3e with %d knots", err, knots);
+
+	if (ImPlot::BeginPlot("Cubic Spline")) {
+	ImPlot::SetupAxes("x", "y");
+	ImPlot::SetupAxesLimits(-1.1, 1.1, -1.5, 2.5);
+	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
+	if (!dragged)
+		ImPlot::PlotLine(ApproxFunctionNames[func], fx.Data, fy.Data, fx.Size);
+	ImPlot::PlotLine(Hamzstlab::SplineBoundaryName(boundary), fx.Data, sy.Data, fx.Size);
+	for (int i = 0; i < knots; ++i) {
+		double x = kx[i];
+		// the knots move vertically only, so x stays increasing
+		if (ImPlot::DragPoint(i, &x, &ky[i], ImVec4(1, 0.5f, 0, 1), 5)) {
+			dragged = true;
+			dirty = true;
+		}
+	}
+	ImPlot::EndPlot();
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+void Demo_Lagrange() {
+	static int func = 0;
+	static int n = 11;
+	static int key_func = -1, key_n = 0;
+	static ImVector<double> fx, fy, ey, cy, ns, errs[2];
+	static Hamzstlab::BarycentricLagrange equi, cheb;
+
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("f(x)", &func, ApproxFunctionNames, IM_ARRAYSIZE(ApproxFunctionNames));
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderInt("Points", &n, 2, 100);
+
+	if (func != key_func) {
+		// maximum error against n, for both node sets
+		ApproxReference(func, fx, fy);
+		ns.resize(0);
+		errs[0].resize(0);
+		errs[1].resize(0);
+		std::vector<double> y(fx.Size);
+		for (int k = 2; k <= 100; ++k) {
+			ns.push_back(k);
+			for (int s = 0; s < 2; ++s) {
+				Hamzstlab::BarycentricLagrange p;
+				if (s == 0) p.Equispaced(ApproxFunctor{ func }, -1, 1, k);
+				else        p.Chebyshev(ApproxFunctor{ func }, -1, 1, k);
+				p.Evaluate(fx.Data, y.data(), fx.Size);
+				double e = 0;
+				for (int i = 0; i < fx.Size; ++i)
+					e = fmax(e, fabs(y[i] - fy[i]));
+				errs[s].push_back(fmax(e, 1e-17));
+			}
+		}
+	}
+	if (func != key_func || n != key_n) {
+		equi.Equispaced(ApproxFunctor{ func }, -1, 1, n);
+		cheb.Chebyshev(ApproxFunctor{ func }, -1, 1, n);
+		ey.resize(fx.Size);
+		cy.resize(fx.Size);
+		equi.Evaluate(fx.Data, ey.Data, fx.Size);
+		cheb.Evaluate(fx.Data, cy.Data, fx.Size);
+		key_func = func; key_n = n;
+	}
+	ImGui::Text("max error: equispaced %.3e, Chebyshev %.3e", errs[0][n - 2], errs[1][n - 2]);
+
+	if (ImPlot::BeginSubplots("##Lagrange", 1, 2, ImVec2(-1, 400))) {
+	if (ImPlot::BeginPlot("Interpolants")) {
+		ImPlot::SetupAxes("x", "y");
+		ImPlot::SetupAxesLimits(-1.05, 1.05, -1.5, 2.5);
+		ImPlot::PlotLine(ApproxFunctionNames[func], fx.Data, fy.Data, fx.Size);
+		ImPlot::PlotLine("Equispaced", fx.Data, ey.Data, fx.Size);
+		ImPlot::PlotLine("Chebyshev", fx.Data, cy.Data, fx.Size);
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 3);
+		ImPlot::PlotScatter("Equispaced", equi.X.data(), equi.Y.data(), equi.Size());
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Square, 3);
+		ImPlot::PlotScatter("Chebyshev", cheb.X.data(), cheb.Y.data(), cheb.Size());
+		ImPlot::EndPlot();
+	}
+	if (ImPlot::BeginPlot("Maximum Error")) {
+		ImPlot::SetupAxes("Points", "max |p(x) - f(x)|", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+		ImPlot::PlotLine("Equispaced", ns.Data, errs[0].Data, ns.Size);
+		ImPlot::PlotLine("Chebyshev", ns.Data, errs[1].Data, ns.Size);
+		double at = n;
+		ImPlot::PlotInfLines("##n", &at, 1);
+		ImPlot::EndPlot();
+	}
+	ImPlot::EndSubplots();
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+// A noisy signal of `count` samples at jittered x, and its interpolating spline.
+struct ResampleData {
+    std::vector<double> Xs, Ys;
+    Hamzstlab::CubicSpline Spline;
+    double BuildMs;
+    void Generate(int count) {
+        Hamzstlab::Xoshiro256ppx4 rng(42);
+        std::vector<double> u(count), noise(count);
+        Hamzstlab::FillUniform(rng, u.data(), count, 0.5, 1.5);
+        Hamzstlab::FillNormal(rng, noise.data(), count, 0, 0.05);
+        Xs.resize(count);
+        Ys.resize(count);
+        double x = 0;
+        for (int i = 0; i < count; ++i) {
+            x += u[i];
+            Xs[i] = x;
+            Ys[i] = sin(x / 5000) + 0.3 * sin(x / 70) + 0.1 * sin(x / 3) + noise[i];
+        }
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        Spline.Build(Xs.data(), Ys.data(), count, Hamzstlab::SplineBoundary_NotAKnot);
+        BuildMs = 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+};
+
+void Demo_SplineResampling() {
+	static int count = 1000000;
+	static int key_count = 0;
+	static int oversample = 2;
+	static ResampleData data;
+	static ImVector<double> qx, qy;
+	static double resample_ms = 0;
+
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderInt("Samples", &count, 1000, 4000000, "%d", ImGuiSliderFlags_Logarithmic);
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderInt("Points per pixel", &oversample, 1, 8);
+	// a new data set only once the slider is released
+	if (key_count == 0 || (count != key_count && !ImGui::IsMouseDown(ImGuiMouseButton_Left))) {
+		data.Generate(count);
+		key_count = count;
+	}
+	ImGui::Text("Spline through %d samples built in %.1f ms; %d points resampled in %.3f ms per frame",
+		data.Spline.Size(), data.BuildMs, qx.Size, resample_ms);
+
+	if (ImPlot::BeginPlot("##Resampling", ImVec2(-1, 400))) {
+		ImPlot::SetupAxes("x", "y");
+		ImPlot::SetupAxesLimits(0, 20000, -2, 2);
+		// the spline is sampled at the resolution of the plot, over the visible range only
+		ImPlotRect lims = ImPlot::GetPlotLimits();
+		const double x0 = fmax(lims.X.Min, data.Xs.front()), x1 = fmin(lims.X.Max, data.Xs.back());
+		const int m = x1 > x0 ? (int)(ImPlot::GetPlotSize().x * oversample) : 0;
+		qx.resize(m);
+		qy.resize(m);
+		for (int i = 0; i < m; ++i)
+			qx[i] = x0 + (x1 - x0) * i / (m > 1 ? m - 1 : 1);
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		data.Spline.Evaluate(qx.Data, qy.Data, m);
+		resample_ms = 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		ImPlot::PlotLine("Spline", qx.Data, qy.Data, m);
+		// the samples themselves once few enough of them are visible
+		const int lo = (int)(std::lower_bound(data.Xs.begin(), data.Xs.end(), x0) - data.Xs.begin());
+		const int hi = (int)(std::upper_bound(data.Xs.begin(), data.Xs.end(), x1) - data.Xs.begin());
+		if (hi - lo > 0 && hi - lo <= 2000) {
+			ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 2);
+			ImPlot::PlotScatter("Samples", &data.Xs[lo], &data.Ys[lo], hi - lo);
+		}
+		ImPlot::EndPlot();
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+static const char* FourierFunctionNames[] = { "Square wave", "Sawtooth f(x) = x",
+                                              ApproxFunctionNames[0], ApproxFunctionNames[1], ApproxFunctionNames[2], ApproxFunctionNames[3] };
+
+// The square wave and the sawtooth, then the functions of the other demos, on one period [-1,1).
+struct FourierFunctor {
+    int Func;
+    double operator()(double x) const {
+        switch (Func) {
+            case 0:  return (x > 0) - (x < 0);
+            case 1:  return x;
+            default: return ApproxFunction(Func - 2, x);
+        }
+    }
+};
+
+void Demo_FourierSeries() {
+	static const int max_terms = 4096;
+	static int func = 0;
+	static int terms = 1;
+	static bool animate = false;
+	static float speed = 30;
+	static double animated = 1;
+	static int key_func = -1;
+	static Hamzstlab::FourierSeries series;
+	static Hamzstlab::FourierPartialSum sum;
+	static ImVector<double> fx, fy, ks, amps;
+	static double build_ms = 0, update_us = 0;
+
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("f(x)", &func, FourierFunctionNames, IM_ARRAYSIZE(FourierFunctionNames));
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::SliderInt("Terms N", &terms, 1, max_terms, "%d", ImGuiSliderFlags_Logarithmic))
+		animated = terms;
+	ImGui::SameLine();
+	ImGui::Checkbox("Animate", &animate);
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderFloat("Terms per second", &speed, 1, 2000, "%.0f", ImGuiSliderFlags_Logarithmic);
+
+	if (func != key_func) {
+		// every coefficient up to max_terms from one real FFT
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		series.Build(FourierFunctor{ func }, -1, 1, max_terms);
+		build_ms = 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		fx.resize(2001);
+		fy.resize(2001);
+		for (int i = 0; i < fx.Size; ++i) {
+			fx[i] = -1 + 2.0 * i / (fx.Size - 1);
+			fy[i] = FourierFunctor{ func }(fx[i]);
+		}
+		ks.resize(max_terms);
+		amps.resize(max_terms);
+		for (int k = 1; k <= max_terms; ++k) {
+			ks[k - 1] = k;
+			amps[k - 1] = fmax(series.Amplitude(k), 1e-17);
+		}
+		key_func = func;
+	}
+	if (animate) {
+		animated += speed * ImGui::GetIO().DeltaTime;
+		if (animated >= max_terms + 1)
+			animated = 1;
+		terms = (int)animated;
+	}
+
+	ImGui::Text("%d coefficients from %d samples in %.2f ms; RMS error of S_N %.3e (Parseval)",
+		max_terms, series.Samples, build_ms, sqrt(series.TailEnergy(terms)));
+	if (sum.LastTransform) ImGui::Text("S_N on %d points by inverse FFT in %.1f us", sum.Points, update_us);
+	else                   ImGui::Text("S_N on %d points updated by %d term(s) in %.1f us", sum.Points, sum.LastTerms, update_us);
+
+	if (ImPlot::BeginSubplots("##Fourier", 1, 2, ImVec2(-1, 400))) {
+	if (ImPlot::BeginPlot("Partial Sum")) {
+		ImPlot::SetupAxes("x", "y");
+		ImPlot::SetupAxesLimits(-1.05, 1.05, -1.5, 2.5);
+		// at least one point per pixel, and 2N + 2 so the top harmonic is resolved
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		sum.SetTerms(series, terms, (int)ImPlot::GetPlotSize().x);
+		update_us = 1e6 * std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		ImPlot::PlotLine(FourierFunctionNames[func], fx.Data, fy.Data, fx.Size);
+		ImPlot::PlotLine("S_N", sum.Xs.data(), sum.Ys.data(), sum.Size());
+		ImPlot::EndPlot();
+	}
+	if (ImPlot::BeginPlot("Spectrum")) {
+		ImPlot::SetupAxes("k", "|a_k|", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+		ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+		ImPlot::PlotLine("Amplitude", ks.Data, amps.Data, ks.Size);
+		double at = terms;
+		ImPlot::PlotInfLines("##N", &at, 1);
+		ImPlot::EndPlot();
+	}
+	ImPlot::EndSubplots();
+	}
+	// the square wave and the sawtooth jump from -1 to 1; nothing to measure
+	// until the plot has been drawn once
+	if (func < 2 && sum.Size() > 0) {
+		double peak = -HUGE_VAL;
+		for (int j = 0; j < sum.Size(); ++j)
+			peak = fmax(peak, sum.Ys[j]);
+		ImGui::Text("Gibbs overshoot: max S_N - 1 = %.4f, %.2f%% of the jump (tends to 8.95%%)", peak - 1, 50 * (peak - 1));
+	}
+}
+
+//-----------------------------------------------------------------------------
+// DEMO WINDOW
+//-----------------------------------------------------------------------------
+
+void DemoHeader(const char* label, void(*demo)()) {
+    if (ImGui::TreeNodeEx(label)) {
+        demo();
+        ImGui::TreePop();
+    }
+}
+
+void ShowApproximationWindow(bool* p_open) {
+    static bool show_implot_metrics      = false;
+    static bool show_implot_style_editor = false;
+    static bool show_imgui_metrics       = false;
+    static bool show_imgui_style_editor  = false;
+    static bool show_imgui_demo          = false;
+
+    if (show_implot_metrics) {
+        ImPlot::ShowMetricsWindow(&show_implot_metrics);
+    }
+    if (show_implot_style_editor) {
+        ImGui::SetNextWindowSize(ImVec2(415,762), ImGuiCond_Appearing);
+        ImGui::Begin("Style Editor (ImPlot)", &show_implot_style_editor);
+        ImPlot::ShowStyleEditor();
+        ImGui::End();
+    }
+    if (show_imgui_style_editor) {
+        ImGui::Begin("Style Editor (ImGui)", &show_imgui_style_editor);
+        ImGui::ShowStyleEditor();
+        ImGui::End();
+    }
+    if (show_imgui_metrics) {
+        ImGui::ShowMetricsWindow(&show_imgui_metrics);
+    }
+    if (show_imgui_demo) {
+        ImGui::ShowDemoWindow(&show_imgui_demo);
+    }
+    ImGui::SetNextWindowPos(ImVec2(50, 50), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(600, 750), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Approximation", p_open, ImGuiWindowFlags_MenuBar);
+    if (ImGui::BeginMenuBar()) {
+        if (ImGui::BeginMenu("Tools")) {
+            ImGui::MenuItem("Metrics",      nullptr, &show_implot_metrics);
+            ImGui::MenuItem("Style Editor", nullptr, &show_implot_style_editor);
+            ImGui::Separator();
+            ImGui::MenuItem("ImGui Metrics",       nullptr, &show_imgui_metrics);
+            ImGui::MenuItem("ImGui Style Editor",  nullptr, &show_imgui_style_editor);
+            ImGui::MenuItem("ImGui Demo",          nullptr, &show_imgui_demo);
+            ImGui::EndMenu();
+        }
+        ImGui::EndMenuBar();
+    }
+    //-------------------------------------------------------------------------
+    ImGui::Text("with ImPlot (v%s)", IMPLOT_VERSION);
+    // display warning about 16-bit indices
+    static bool showWarning = sizeof(ImDrawIdx)*8 == 16 && (ImGui::GetIO().BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset) == false;
+    if (showWarning) {
+        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1,1,0,1));
+        ImGui::TextWrapped("WARNING: ImDrawIdx is 16-bit and ImGuiBackendFlags_RendererHasVtxOffset is false. Expect visual glitches and artifacts! See README for more information.");
+        ImGui::PopStyleColor();
+    }
+
+    ImGui::Spacing();
+
+    if (ImGui::BeginTabBar("ImPlotDemoTabs")) {
+        if (ImGui::BeginTabItem("Plots")) {
+            DemoHeader("Cubic Splines", Demo_CubicSplines);
+            DemoHeader("Lagrange Interpolation", Demo_Lagrange);
+            DemoHeader("Million-Point Resampling", Demo_SplineResampling);
+            DemoHeader("Fourier Series", Demo_FourierSeries);
+            ImGui::EndTabItem();
+        }
+        if (ImGui::BeginTabItem("Config")) {
+            Demo_Config();
+            ImGui::EndTabItem();
+        }
+        if (ImGui::BeginTabItem("Help")) {
+            Demo_Help();
+            ImGui::EndTabItem();
+        }
+        ImGui::EndTabBar();
+    }
+    ImGui::End();
+}
+
+} // namespace ImPlot
+
+#else
+
+namespace ImPlot { void ShowApproximationWindow(bool* p_open) {} }
+
+#endif
+
+#endif // #ifndef IMGUI_DISABLE
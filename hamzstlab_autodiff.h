@@ -0,0 +1,215 @@
+// Hamzstlab Mathematics: forward-mode automatic differentiation
+//
+// Write the function once as a template and evaluate it on doubles, on
+// Dual<double> for f and f', or on HyperDual<double> for f, f' and f''.
+//
+//   struct CosMinusX {
+//       template <typename T> T operator()(const T& x) const { using std::cos; return cos(x) - x; }
+//   };
+//   Hamzstlab::Dual<double> d = CosMinusX()(Hamzstlab::Dual<double>(0.5, 1)); // d.Val, d.Der
+//
+// NewtonAD and HalleyAD use these to get exact derivatives at the cost of a
+// few extra multiplications per operation, with no symbolic expression swell.
+
+#pragma once
+
+#include "hamzstlab_roots.h"
+#include <cmath>
+
+namespace Hamzstlab {
+
+//-----------------------------------------------------------------------------
+// Dual numbers: Val + Der e, e^2 = 0
+//-----------------------------------------------------------------------------
+
+template <typename T>
+struct Dual {
+    T Val, Der;
+    Dual() : Val(0), Der(0) { }
+    Dual(const T& v, const T& d = T(0)) : Val(v), Der(d) { }
+    Dual& operator+=(const Dual& o) { Val += o.Val; Der += o.Der; return *this; }
+    Dual& operator-=(const Dual& o) { Val -= o.Val; Der -= o.Der; return *this; }
+    Dual& operator*=(const Dual& o) { Der = Der * o.Val + Val * o.Der; Val *= o.Val; return *this; }
+    Dual& operator/=(const Dual& o) { Der = (Der * o.Val - Val * o.Der) / (o.Val * o.Val); Val /= o.Val; return *this; }
+};
+
+// f(x) with f(x.Val) = f0 and f'(x.Val) = f1
+template <typename T> inline Dual<T> DualChain(const Dual<T>& x, const T& f0, const T& f1) { return Dual<T>(f0, f1 * x.Der); }
+
+template <typename T> inline Dual<T> operator+(const Dual<T>& a) { return a; }
+template <typename T> inline Dual<T> operator-(const Dual<T>& a) { return Dual<T>(-a.Val, -a.Der); }
+template <typename T> inline Dual<T> operator+(Dual<T> a, const Dual<T>& b) { return a += b; }
+template <typename T> inline Dual<T> operator-(Dual<T> a, const Dual<T>& b) { return a -= b; }
+template <typename T> inline Dual<T> operator*(Dual<T> a, const Dual<T>& b) { return a *= b; }
+template <typename T> inline Dual<T> operator/(Dual<T> a, const Dual<T>& b) { return a /= b; }
+template <typename T> inline Dual<T> operator+(const Dual<T>& a, double b) { return Dual<T>(a.Val + b, a.Der); }
+template <typename T> inline Dual<T> operator+(double a, const Dual<T>& b) { return Dual<T>(a + b.Val, b.Der); }
+template <typename T> inline Dual<T> operator-(const Dual<T>& a, double b) { return Dual<T>(a.Val - b, a.Der); }
+template <typename T> inline Dual<T> operator-(double a, const Dual<T>& b) { return Dual<T>(a - b.Val, -b.Der); }
+template <typename T> inline Dual<T> operator*(const Dual<T>& a, double b) { return Dual<T>(a.Val * b, a.Der * b); }
+template <typename T> inline Dual<T> operator*(double a, const Dual<T>& b) { return Dual<T>(a * b.Val, a * b.Der); }
+template <typename T> inline Dual<T> operator/(const Dual<T>& a, double b) { return Dual<T>(a.Val / b, a.Der / b); }
+template <typename T> inline Dual<T> operator/(double a, const Dual<T>& b) { return Dual<T>(a / b.Val, -a * b.Der / (b.Val * b.Val)); }
+template <typename T> inline bool operator<(const Dual<T>& a, const Dual<T>& b) { return a.Val < b.Val; }
+template <typename T> inline bool operator>(const Dual<T>& a, const Dual<T>& b) { return a.Val > b.Val; }
+
+template <typename T> inline Dual<T> sin(const Dual<T>& x)  { using std::sin; using std::cos; return DualChain(x, sin(x.Val), cos(x.Val)); }
+template <typename T> inline Dual<T> cos(const Dual<T>& x)  { using std::sin; using std::cos; return DualChain(x, cos(x.Val), -sin(x.Val)); }
+template <typename T> inline Dual<T> tan(const Dual<T>& x)  { using std::tan; T t = tan(x.Val); return DualChain(x, t, T(1) + t * t); }
+template <typename T> inline Dual<T> exp(const Dual<T>& x)  { using std::exp; T e = exp(x.Val); return DualChain(x, e, e); }
+template <typename T> inline Dual<T> log(const Dual<T>& x)  { using std::log; return DualChain(x, log(x.Val), T(1) / x.Val); }
+template <typename T> inline Dual<T> sqrt(const Dual<T>& x) { using std::sqrt; T s = sqrt(x.Val); return DualChain(x, s, T(0.5) / s); }
+template <typename T> inline Dual<T> atan(const Dual<T>& x) { using std::atan; return DualChain(x, atan(x.Val), T(1) / (T(1) + x.Val * x.Val)); }
+template <typename T> inline Dual<T> sinh(const Dual<T>& x) { using std::sinh; using std::cosh; return DualChain(x, sinh(x.Val), cosh(x.Val)); }
+template <typename T> inline Dual<T> cosh(const Dual<T>& x) { using std::sinh; using std::cosh; return DualChain(x, cosh(x.Val), sinh(x.Val)); }
+template <typename T> inline Dual<T> tanh(const Dual<T>& x) { using std::tanh; T t = tanh(x.Val); return DualChain(x, t, T(1) - t * t); }
+template <typename T> inline Dual<T> fabs(const Dual<T>& x) { return x.Val < T(0) ? -x : x; }
+template <typename T> inline Dual<T> abs(const Dual<T>& x)  { return fabs(x); }
+template <typename T> inline Dual<T> pow(const Dual<T>& x, double p) { using std::pow; return DualChain(x, pow(x.Val, T(p)), T(p) * pow(x.Val, T(p - 1))); }
+template <typename T> inline Dual<T> pow(const Dual<T>& x, const Dual<T>& y) { return exp(y * log(x)); }
+
+//-----------------------------------------------------------------------------
+// Hyper-dual numbers: Val + E1 e1 + E2 e2 + E12 e1e2, e1^2 = e2^2 = 0.
+// Seeding E1 = E2 = 1 gives f' in E1 (and E2) and f'' in E12, exactly.
+//-----------------------------------------------------------------------------
+
+template <typename T>
+struct HyperDual {
+    T Val, E1, E2, E12;
+    HyperDual() : Val(0), E1(0), E2(0), E12(0) { }
+    HyperDual(const T& v, const T& e1 = T(0), const T& e2 = T(0), const T& e12 = T(0)) : Val(v), E1(e1), E2(e2), E12(e12) { }
+    HyperDual& operator+=(const HyperDual& o) { Val += o.Val; E1 += o.E1; E2 += o.E2; E12 += o.E12; return *this; }
+    HyperDual& operator-=(const HyperDual& o) { Val -= o.Val; E1 -= o.E1; E2 -= o.E2; E12 -= o.E12; return *this; }
+    HyperDual& operator*=(const HyperDual& o) {
+        E12 = Val * o.E12 + E1 * o.E2 + E2 * o.E1 + E12 * o.Val;
+        E1  = Val * o.E1 + E1 * o.Val;
+        E2  = Val * o.E2 + E2 * o.Val;
+        Val = Val * o.Val;
+        return *this;
+    }
+    HyperDual& operator/=(const HyperDual& o) {
+        // a / b = a * (1/b), with 1/b from the chain rule
+        T inv = T(1) / o.Val;
+        HyperDual r(inv, -o.E1 * inv * inv, -o.E2 * inv * inv, T(2) * o.E1 * o.E2 * inv * inv * inv - o.E12 * inv * inv);
+        return *this *= r;
+    }
+};
+
+// f(x) with f(x.Val) = f0, f'(x.Val) = f1, f''(x.Val) = f2
+template <typename T> inline HyperDual<T> HyperDualChain(const HyperDual<T>& x, const T& f0, const T& f1, const T& f2) {
+    return HyperDual<T>(f0, f1 * x.E1, f1 * x.E2, f1 * x.E12 + f2 * x.E1 * x.E2);
+}
+
+template <typename T> inline HyperDual<T> operator+(const HyperDual<T>& a) { return a; }
+template <typename T> inline HyperDual<T> operator-(const HyperDual<T>& a) { return HyperDual<T>(-a.Val, -a.E1, -a.E2, -a.E12); }
+template <typename T> inline HyperDual<T> operator+(HyperDual<T> a, const HyperDual<T>& b) { return a += b; }
+template <typename T> inline HyperDual<T> operator-(HyperDual<T> a, const HyperDual<T>& b) { return a -= b; }
+template <typename T> inline HyperDual<T> operator*(HyperDual<T> a, const HyperDual<T>& b) { return a *= b; }
+template <typename T> inline HyperDual<T> operator/(HyperDual<T> a, const HyperDual<T>& b) { return a /= b; }
+template <typename T> inline HyperDual<T> operator+(const HyperDual<T>& a, double b) { HyperDual<T> r = a; r.Val += b; return r; }
+template <typename T> inline HyperDual<T> operator+(double a, const HyperDual<T>& b) { return b + a; }
+template <typename T> inline HyperDual<T> operator-(const HyperDual<T>& a, double b) { HyperDual<T> r = a; r.Val -= b; return r; }
+template <typename T> inline HyperDual<T> operator-(double a, const HyperDual<T>& b) { return -b + a; }
+template <typename T> inline HyperDual<T> operator*(const HyperDual<T>& a, double b) { return HyperDual<T>(a.Val * b, a.E1 * b, a.E2 * b, a.E12 * b); }
+template <typename T> inline HyperDual<T> operator*(double a, const HyperDual<T>& b) { return b * a; }
+template <typename T> inline HyperDual<T> operator/(const HyperDual<T>& a, double b) { return a * (1.0 / b); }
+template <typename T> inline HyperDual<T> operator/(double a, const HyperDual<T>& b) { return HyperDual<T>(a) / b; }
+template <typename T> inline bool operator<(const HyperDual<T>& a, const HyperDual<T>& b) { return a.Val < b.Val; }
+template <typename T> inline bool operator>(const HyperDual<T>& a, const HyperDual<T>& b) { return a.Val > b.Val; }
+
+template <typename T> inline HyperDual<T> sin(const HyperDual<T>& x)  { using std::sin; using std::cos; T s = sin(x.Val); return HyperDualChain(x, s, cos(x.Val), -s); }
+template <typename T> inline HyperDual<T> cos(const HyperDual<T>& x)  { using std::sin; using std::cos; T c = cos(x.Val); return HyperDualChain(x, c, -sin(x.Val), -c); }
+template <typename T> inline HyperDual<T> tan(const HyperDual<T>& x)  { using std::tan; T t = tan(x.Val), d = T(1) + t * t; return HyperDualChain(x, t, d, T(2) * t * d); }
+template <typename T> inline HyperDual<T> exp(const HyperDual<T>& x)  { using std::exp; T e = exp(x.Val); return HyperDualChain(x, e, e, e); }
+template <typename T> inline HyperDual<T> log(const HyperDual<T>& x)  { using std::log; T inv = T(1) / x.Val; return HyperDualChain(x, log(x.Val), inv, -inv * inv); }
+template <typename T> inline HyperDual<T> sqrt(const HyperDual<T>& x) { using std::sqrt; T s = sqrt(x.Val); return HyperDualChain(x, s, T(0.5) / s, T(-0.25) / (s * x.Val)); }
+template <typename T> inline HyperDual<T> atan(const HyperDual<T>& x) { using std::atan; T d = T(1) / (T(1) + x.Val * x.Val); return HyperDualChain(x, atan(x.Val), d, T(-2) * x.Val * d * d); }
+template <typename T> inline HyperDual<T> sinh(const HyperDual<T>& x) { using std::sinh; using std::cosh; T s = sinh(x.Val); return HyperDualChain(x, s, cosh(x.Val), s); }
+template <typename T> inline HyperDual<T> cosh(const HyperDual<T>& x) { using std::sinh; using std::cosh; T c = cosh(x.Val); return HyperDualChain(x, c, sinh(x.Val), c); }
+template <typename T> inline HyperDual<T> tanh(const HyperDual<T>& x) { using std::tanh; T t = tanh(x.Val), d = T(1) - t * t; return HyperDualChain(x, t, d, T(-2) * t * d); }
+template <typename T> inline HyperDual<T> fabs(const HyperDual<T>& x) { return x.Val < T(0) ? -x : x; }
+template <typename T> inline HyperDual<T> abs(const HyperDual<T>& x)  { return fabs(x); }
+template <typename T> inline HyperDual<T> pow(const HyperDual<T>& x, double p) {
+    using std::pow;
+    return HyperDualChain(x, pow(x.Val, T(p)), T(p) * pow(x.Val, T(p - 1)), T(p * (p - 1)) * pow(x.Val, T(p - 2)));
+}
+template <typename T> inline HyperDual<T> pow(const HyperDual<T>& x, const HyperDual<T>& y) { return exp(y * log(x)); }
+
+//-----------------------------------------------------------------------------
+// Derivative helpers and root finders
+//-----------------------------------------------------------------------------
+
+// f(x) and f'(x) in one pass.
+template <class F>
+inline double Derivative(const F& f, double x, double* fx = nullptr) {
+    Dual<double> d = f(Dual<double>(x, 1.0));
+    if (fx) *fx = d.Val;
+    return d.Der;
+}
+
+// f(x), f'(x) and f''(x) in one pass.
+template <class F>
+inline double SecondDerivative(const F& f, double x, double* fx = nullptr, double* dfx = nullptr) {
+    HyperDual<double> h = f(HyperDual<double>(x, 1.0, 1.0, 0.0));
+    if (fx)  *fx  = h.Val;
+    if (dfx) *dfx = h.E1;
+    return h.E12;
+}
+
+// Newton's method with f' from dual numbers. Each iteration is one Dual evaluation,
+// counted as one evaluation in the result.
+template <class F>
+RootResult NewtonAD(const F& f, double x0, const RootOptions& opt = RootOptions()) {
+    RootResult res;
+    detail::RootClock::time_point t0 = detail::RootClock::now();
+    double x = x0;
+    Dual<double> d = f(Dual<double>(x, 1.0));
+    res.Evaluations = 1;
+    res.Xs.push_back(x); res.Fs.push_back(d.Val);
+    bool converged = d.Val == 0;
+    for (int i = 0; i < opt.MaxIter && !converged; ++i) {
+        if (std::fabs(d.Val) <= opt.FTol) { converged = true; break; }
+        if (d.Der == 0 || !std::isfinite(d.Der)) break;
+        double step = d.Val / d.Der;
+        x -= step;
+        d = f(Dual<double>(x, 1.0));
+        res.Evaluations++;
+        res.Iterations = i + 1;
+        res.Xs.push_back(x); res.Fs.push_back(d.Val);
+        if (!std::isfinite(x)) break;
+        converged = d.Val == 0 || detail::RootXConverged(step, x, opt);
+    }
+    res.Root = x; res.FRoot = d.Val; res.Converged = converged;
+    res.Seconds = std::chrono::duration<double>(detail::RootClock::now() - t0).count();
+    return res;
+}
+
+// Halley's method (cubic convergence) with f' and f'' from hyper-dual numbers.
+template <class F>
+RootResult HalleyAD(const F& f, double x0, const RootOptions& opt = RootOptions()) {
+    RootResult res;
+    detail::RootClock::time_point t0 = detail::RootClock::now();
+    double x = x0;
+    HyperDual<double> h = f(HyperDual<double>(x, 1.0, 1.0, 0.0));
+    res.Evaluations = 1;
+    res.Xs.push_back(x); res.Fs.push_back(h.Val);
+    bool converged = h.Val == 0;
+    for (int i = 0; i < opt.MaxIter && !converged; ++i) {
+        if (std::fabs(h.Val) <= opt.FTol) { converged = true; break; }
+        double den = 2 * h.E1 * h.E1 - h.Val * h.E12;
+        if (den == 0 || !std::isfinite(den)) break;
+        double step = 2 * h.Val * h.E1 / den;
+        x -= step;
+        h = f(HyperDual<double>(x, 1.0, 1.0, 0.0));
+        res.Evaluations++;
+        res.Iterations = i + 1;
+        res.Xs.push_back(x); res.Fs.push_back(h.Val);
+        if (!std::isfinite(x)) break;
+        converged = h.Val == 0 || detail::RootXConverged(step, x, opt);
+    }
+    res.Root = x; res.FRoot = h.Val; res.Converged = converged;
+    res.Seconds = std::chrono::duration<double>(detail::RootClock::now() - t0).count();
+    return res;
+}
+
+} // namespace Hamzstlab
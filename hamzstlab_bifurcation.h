@@ -0,0 +1,103 @@
+// Hamzstlab Mathematics: bifurcation diagram of the logistic map
+//
+// Every column of the image is one value of r in the discrete logistic map
+//
+//   x <- r x (1 - x),
+//
+// iterated from x0 past Transient steps, then for Iterations more steps whose
+// states are counted into the rows they fall in. A pixel's value is the log of
+// its count relative to the busiest pixel of its column, so the fixed points
+// and cycles of the period-doubling cascade are bright lines and the chaotic
+// bands a dim haze:
+//
+//   Hamzstlab::BifurcationSpec s;
+//   s.Width = 800; s.Height = 600; s.RLim[0] = 2.8; s.RLim[1] = 4.0;
+//   Hamzstlab::RenderBifurcation(image.Data, s);
+//   ImPlot::PlotHeatmap("##Density", image.Data, s.Height, s.Width, 0, 1, NULL, ImPlotPoint(2.8, 0), ImPlotPoint(4.0, 1));
+//
+// Only the rows in XLim are stored, so a zoomed view spends its resolution on
+// the visible part of the attractor. Columns are independent: four of them
+// share the lanes of a Vec4d, which hides the latency of the serial map
+// iteration, and tiles of columns go to the thread pool.
+
+#pragma once
+
+#include "hamzstlab_parallel.h"
+#include "hamzstlab_simd.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Hamzstlab {
+
+struct BifurcationSpec {
+    /* Image Specification */
+    int    Width;
+    int    Height;
+    /* Map Specification */
+    double RLim[2];     // r, first column to last column
+    double XLim[2];     // x, first row to last row
+    double X0;
+    int    Transient;   // iterations discarded before counting
+    int    Iterations;  // iterations counted per column
+    BifurcationSpec() {
+        Width = Height = 512;
+        RLim[0] = 2.5; RLim[1] = 4.0;
+        XLim[0] = 1.0; XLim[1] = 0.0;
+        X0 = 0.5;
+        Transient = 1000; Iterations = 1000;
+    }
+};
+
+// Renders columns [begin,end) of the image (Width*Height floats, row-major),
+// iterating four columns at a time in the lanes of a Vec4d.
+inline void BifurcationColumns(float* image, const BifurcationSpec& s, int begin, int end) {
+    const double dr = (s.RLim[1] - s.RLim[0]) / s.Width;
+    const double rows_per_x = s.Height / (s.XLim[1] - s.XLim[0]);
+    std::vector<int> counts((size_t)4 * s.Height);
+    // log(1 + n) for every possible count, instead of one log per pixel
+    std::vector<float> log1(s.Iterations + 1);
+    for (int n = 0; n <= s.Iterations; ++n)
+        log1[n] = std::log(1.0f + n);
+    for (int c = begin; c < end; c += 4) {
+        double rs[4], xs[4];
+        for (int i = 0; i < 4; ++i)
+            rs[i] = s.RLim[0] + (c + i + 0.5) * dr;
+        const Vec4d r = Vec4d::Load(rs);
+        Vec4d x(s.X0);
+        // an orbit that leaves [0, 1] runs off to -inf, so no test is needed here
+        for (int k = 0; k < s.Transient; ++k)
+            x = r * x * (1 - x);
+        std::fill(counts.begin(), counts.end(), 0);
+        int peak[4] = { 0, 0, 0, 0 };
+        for (int k = 0; k < s.Iterations; ++k) {
+            x = r * x * (1 - x);
+            x.Store(xs);
+            for (int i = 0; i < 4; ++i) {
+                const double row = (xs[i] - s.XLim[0]) * rows_per_x;
+                if (row >= 0 && row < s.Height) {
+                    const int n = ++counts[(size_t)i * s.Height + (int)row];
+                    peak[i] = n > peak[i] ? n : peak[i];
+                }
+            }
+        }
+        x.Store(xs);
+        for (int i = 0; i < 4 && c + i < end; ++i) {
+            // r outside (0, 4] escapes [0, 1]: leave the column empty
+            const bool bounded = xs[i] >= 0 && xs[i] <= 1;
+            const float scale = bounded && peak[i] > 0 ? 1.0f / log1[peak[i]] : 0.0f;
+            const int* col = &counts[(size_t)i * s.Height];
+            for (int y = 0; y < s.Height; ++y)
+                image[(size_t)y * s.Width + c + i] = scale * log1[col[y]];
+        }
+    }
+}
+
+// Renders the whole image with columns split into tiles of `tile_cols`.
+inline void RenderBifurcation(float* image, const BifurcationSpec& s, int threads = 0, int tile_cols = 16) {
+    ParallelFor(s.Width, tile_cols, [&](int begin, int end) {
+        BifurcationColumns(image, s, begin, end);
+    }, threads);
+}
+
+} // namespace Hamzstlab
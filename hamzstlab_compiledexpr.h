@@ -0,0 +1,294 @@
+// Hamzstlab Mathematics: compiled numeric evaluator for SymbolicC++ expressions
+//
+// Lowers a Symbolic expression in one variable into a flat postfix program over
+// doubles, so that iterative methods and plotting can evaluate f(x) without
+// going through SymbolicC++ tree substitution (f[x==v]) on every call.
+//
+//   Symbolic x("x"), f = cos(x) - x;
+//   Hamzstlab::CompiledExpr F, DF;
+//   Hamzstlab::CompileWithDerivative(f, x, F, DF);
+//   double y = F(0.5), dy = DF(0.5);
+//
+// Node types that the compiler does not know are kept as a Substitute
+// instruction which falls back to f[x==v] for that subtree only.
+
+#pragma once
+
+#include "symintegrationc++.h"
+#include <cmath>
+#include <vector>
+
+namespace Hamzstlab {
+
+enum ExprOp {
+    ExprOp_Const,       // push Value
+    ExprOp_Var,         // push x
+    ExprOp_Add,         // a b -> a+b
+    ExprOp_Mul,         // a b -> a*b
+    ExprOp_Div,         // a b -> a/b
+    ExprOp_Neg,         // a -> -a
+    ExprOp_AddConst,    // a -> a+Value
+    ExprOp_MulConst,    // a -> a*Value
+    ExprOp_Square,      // a -> a*a
+    ExprOp_PowInt,      // a -> a^Arg
+    ExprOp_Pow,         // a b -> a^b
+    ExprOp_Sqrt,        // a -> sqrt(a)
+    ExprOp_Exp,         // a -> e^a
+    ExprOp_Ln,          // a -> ln(a)
+    ExprOp_Sin,
+    ExprOp_Cos,
+    ExprOp_Sinh,
+    ExprOp_Cosh,
+    ExprOp_Substitute   // push double(Opaque[Arg][var==x])
+};
+
+struct ExprInstr {
+    int    Op;
+    int    Arg;
+    double Value;
+    ExprInstr(int op, int arg = 0, double value = 0) { Op = op; Arg = arg; Value = value; }
+};
+
+class CompiledExpr {
+public:
+    CompiledExpr() { MaxDepth = 0; }
+    CompiledExpr(const Symbolic& expr, const Symbolic& var) { Compile(expr, var); }
+
+    void Compile(const Symbolic& expr, const Symbolic& var) {
+        Code.clear();
+        Opaque.clear();
+        Var = var;
+        MaxDepth = 0;
+        int depth = 0;
+        Emit(expr, depth);
+    }
+
+    bool   Empty() const         { return Code.empty(); }
+    int    Size() const          { return (int)Code.size(); }
+    int    SubstituteCount() const { return (int)Opaque.size(); }
+
+    double operator()(double x) const { return Eval(x); }
+
+    double Eval(double x) const {
+        double local[32];
+        std::vector<double> heap;
+        double* st = local;
+        if (MaxDepth > 32) {
+            heap.resize(MaxDepth);
+            st = heap.data();
+        }
+        int sp = -1;
+        for (size_t i = 0; i < Code.size(); ++i) {
+            const ExprInstr& in = Code[i];
+            switch (in.Op) {
+                case ExprOp_Const:      st[++sp] = in.Value; break;
+                case ExprOp_Var:        st[++sp] = x; break;
+                case ExprOp_Add:        --sp; st[sp] += st[sp+1]; break;
+                case ExprOp_Mul:        --sp; st[sp] *= st[sp+1]; break;
+                case ExprOp_Div:        --sp; st[sp] /= st[sp+1]; break;
+                case ExprOp_Neg:        st[sp] = -st[sp]; break;
+                case ExprOp_AddConst:   st[sp] += in.Value; break;
+                case ExprOp_MulConst:   st[sp] *= in.Value; break;
+                case ExprOp_Square:     st[sp] *= st[sp]; break;
+                case ExprOp_PowInt:     st[sp] = PowInt(st[sp], in.Arg); break;
+                case ExprOp_Pow:        --sp; st[sp] = std::pow(st[sp], st[sp+1]); break;
+                case ExprOp_Sqrt:       st[sp] = std::sqrt(st[sp]); break;
+                case ExprOp_Exp:        st[sp] = std::exp(st[sp]); break;
+                case ExprOp_Ln:         st[sp] = std::log(st[sp]); break;
+                case ExprOp_Sin:        st[sp] = std::sin(st[sp]); break;
+                case ExprOp_Cos:        st[sp] = std::cos(st[sp]); break;
+                case ExprOp_Sinh:       st[sp] = std::sinh(st[sp]); break;
+                case ExprOp_Cosh:       st[sp] = std::cosh(st[sp]); break;
+                case ExprOp_Substitute: st[++sp] = Opaque[in.Arg][Var == Symbolic(x)]; break;
+            }
+        }
+        return st[0];
+    }
+
+    // Evaluates ys[i] = f(xs[i]). Runs the program once per block of points so the
+    // inner loops are straight array arithmetic the compiler can vectorize.
+    void Eval(const double* xs, double* ys, int count) const {
+        const int B = 256;
+        std::vector<double> stack((size_t)(MaxDepth > 0 ? MaxDepth : 1) * B);
+        for (int off = 0; off < count; off += B) {
+            const int n = count - off < B ? count - off : B;
+            const double* x = xs + off;
+            int sp = -1;
+            for (size_t i = 0; i < Code.size(); ++i) {
+                const ExprInstr& in = Code[i];
+                // the top of the stack; pushes form their slot inside their case,
+                // since sp + 1 may be MaxDepth for every other op
+                double* a = sp >= 0 ? &stack[(size_t)sp * B] : nullptr;
+                double* b;
+                switch (in.Op) {
+                    case ExprOp_Const:      b = &stack[(size_t)(sp + 1) * B]; for (int k = 0; k < n; ++k) b[k] = in.Value; ++sp; break;
+                    case ExprOp_Var:        b = &stack[(size_t)(sp + 1) * B]; for (int k = 0; k < n; ++k) b[k] = x[k]; ++sp; break;
+                    case ExprOp_Add:        a = &stack[(size_t)(sp-1) * B]; b = &stack[(size_t)sp * B]; for (int k = 0; k < n; ++k) a[k] += b[k]; --sp; break;
+                    case ExprOp_Mul:        a = &stack[(size_t)(sp-1) * B]; b = &stack[(size_t)sp * B]; for (int k = 0; k < n; ++k) a[k] *= b[k]; --sp; break;
+                    case ExprOp_Div:        a = &stack[(size_t)(sp-1) * B]; b = &stack[(size_t)sp * B]; for (int k = 0; k < n; ++k) a[k] /= b[k]; --sp; break;
+                    case ExprOp_Pow:        a = &stack[(size_t)(sp-1) * B]; b = &stack[(size_t)sp * B]; for (int k = 0; k < n; ++k) a[k] = std::pow(a[k], b[k]); --sp; break;
+                    case ExprOp_Neg:        for (int k = 0; k < n; ++k) a[k] = -a[k]; break;
+                    case ExprOp_AddConst:   for (int k = 0; k < n; ++k) a[k] += in.Value; break;
+                    case ExprOp_MulConst:   for (int k = 0; k < n; ++k) a[k] *= in.Value; break;
+                    case ExprOp_Square:     for (int k = 0; k < n; ++k) a[k] *= a[k]; break;
+                    case ExprOp_PowInt:     for (int k = 0; k < n; ++k) a[k] = PowInt(a[k], in.Arg); break;
+                    case ExprOp_Sqrt:       for (int k = 0; k < n; ++k) a[k] = std::sqrt(a[k]); break;
+                    case ExprOp_Exp:        for (int k = 0; k < n; ++k) a[k] = std::exp(a[k]); break;
+                    case ExprOp_Ln:         for (int k = 0; k < n; ++k) a[k] = std::log(a[k]); break;
+                    case ExprOp_Sin:        for (int k = 0; k < n; ++k) a[k] = std::sin(a[k]); break;
+                    case ExprOp_Cos:        for (int k = 0; k < n; ++k) a[k] = std::cos(a[k]); break;
+                    case ExprOp_Sinh:       for (int k = 0; k < n; ++k) a[k] = std::sinh(a[k]); break;
+                    case ExprOp_Cosh:       for (int k = 0; k < n; ++k) a[k] = std::cosh(a[k]); break;
+                    case ExprOp_Substitute: b = &stack[(size_t)(sp + 1) * B]; for (int k = 0; k < n; ++k) b[k] = Opaque[in.Arg][Var == Symbolic(x[k])]; ++sp; break;
+                }
+            }
+            for (int k = 0; k < n; ++k)
+                ys[off + k] = stack[k];
+        }
+    }
+
+    std::vector<ExprInstr> Code;
+
+private:
+    static double PowInt(double a, int n) {
+        bool inv = n < 0;
+        unsigned int e = inv ? -n : n;
+        double r = 1;
+        while (e) {
+            if (e & 1) r *= a;
+            a *= a;
+            e >>= 1;
+        }
+        return inv ? 1 / r : r;
+    }
+
+    static bool IsNumeric(const Symbolic& s) { return s.type() == typeid(Numeric); }
+
+    static bool IsSymbolNamed(const Symbolic& s, const char* name) {
+        return s.type() == typeid(Symbol) && CastPtr<const Symbol>(s)->name == name && CastPtr<const Symbol>(s)->parameters.empty();
+    }
+
+    void Push(int d) { if (d > MaxDepth) MaxDepth = d; }
+
+    void EmitOp(int op, int& depth, int pops, int arg = 0, double value = 0) {
+        Code.push_back(ExprInstr(op, arg, value));
+        depth -= pops;
+    }
+
+    void EmitConst(double v, int& depth) {
+        Code.push_back(ExprInstr(ExprOp_Const, 0, v));
+        Push(++depth);
+    }
+
+    void EmitSubstitute(const Symbolic& s, int& depth) {
+        Code.push_back(ExprInstr(ExprOp_Substitute, (int)Opaque.size()));
+        Opaque.push_back(s);
+        Push(++depth);
+    }
+
+    void Emit(const Symbolic& s, int& depth) {
+        if (IsNumeric(s)) {
+            EmitConst(double(s), depth);
+        }
+        else if (s.type() == typeid(Symbol)) {
+            if (s.compare(Var) != 0) {
+                Code.push_back(ExprInstr(ExprOp_Var));
+                Push(++depth);
+            }
+            else if (IsSymbolNamed(s, "pi"))
+                EmitConst(3.14159265358979323846, depth);
+            else if (IsSymbolNamed(s, "e"))
+                EmitConst(2.71828182845904523536, depth);
+            else
+                EmitSubstitute(s, depth);
+        }
+        else if (s.type() == typeid(Sum)) {
+            const std::list<Symbolic>& terms = CastPtr<const Sum>(s)->summands;
+            double c = 0;
+            int emitted = 0;
+            for (std::list<Symbolic>::const_iterator it = terms.begin(); it != terms.end(); ++it) {
+                if (IsNumeric(*it)) { c += double(*it); continue; }
+                Emit(*it, depth);
+                if (emitted++ > 0) EmitOp(ExprOp_Add, depth, 1);
+            }
+            if (emitted == 0)
+                EmitConst(c, depth);
+            else if (c != 0)
+                EmitOp(ExprOp_AddConst, depth, 0, 0, c);
+        }
+        else if (s.type() == typeid(Product)) {
+            const std::list<Symbolic>& factors = CastPtr<const Product>(s)->factors;
+            double c = 1;
+            int emitted = 0;
+            for (std::list<Symbolic>::const_iterator it = factors.begin(); it != factors.end(); ++it) {
+                if (IsNumeric(*it)) { c *= double(*it); continue; }
+                Emit(*it, depth);
+                if (emitted++ > 0) EmitOp(ExprOp_Mul, depth, 1);
+            }
+            if (emitted == 0)
+                EmitConst(c, depth);
+            else if (c == -1)
+                EmitOp(ExprOp_Neg, depth, 0);
+            else if (c != 1)
+                EmitOp(ExprOp_MulConst, depth, 0, 0, c);
+        }
+        else if (s.type() == typeid(Power)) {
+            const Symbolic& base = CastPtr<const Power>(s)->parameters.front();
+            const Symbolic& expo = CastPtr<const Power>(s)->parameters.back();
+            if (IsSymbolNamed(base, "e")) {
+                Emit(expo, depth);
+                EmitOp(ExprOp_Exp, depth, 0);
+            }
+            else if (IsNumeric(expo)) {
+                double p = double(expo);
+                Emit(base, depth);
+                if (p == 2)
+                    EmitOp(ExprOp_Square, depth, 0);
+                else if (p == 0.5)
+                    EmitOp(ExprOp_Sqrt, depth, 0);
+                else if (p == std::floor(p) && std::fabs(p) <= 64)
+                    EmitOp(ExprOp_PowInt, depth, 0, (int)p);
+                else {
+                    EmitConst(p, depth);
+                    EmitOp(ExprOp_Pow, depth, 1);
+                }
+            }
+            else {
+                Emit(base, depth);
+                Emit(expo, depth);
+                EmitOp(ExprOp_Pow, depth, 1);
+            }
+        }
+        else if (s.type() == typeid(Sin))  { Emit(CastPtr<const Sin>(s)->parameters.front(), depth);  EmitOp(ExprOp_Sin, depth, 0); }
+        else if (s.type() == typeid(Cos))  { Emit(CastPtr<const Cos>(s)->parameters.front(), depth);  EmitOp(ExprOp_Cos, depth, 0); }
+        else if (s.type() == typeid(Sinh)) { Emit(CastPtr<const Sinh>(s)->parameters.front(), depth); EmitOp(ExprOp_Sinh, depth, 0); }
+        else if (s.type() == typeid(Cosh)) { Emit(CastPtr<const Cosh>(s)->parameters.front(), depth); EmitOp(ExprOp_Cosh, depth, 0); }
+        else if (s.type() == typeid(Log)) {
+            // Log(a,b) = log_a(b); ln(b) is Log(e,b)
+            const Symbolic& a = CastPtr<const Log>(s)->parameters.front();
+            const Symbolic& b = CastPtr<const Log>(s)->parameters.back();
+            Emit(b, depth);
+            EmitOp(ExprOp_Ln, depth, 0);
+            if (!IsSymbolNamed(a, "e")) {
+                Emit(a, depth);
+                EmitOp(ExprOp_Ln, depth, 0);
+                EmitOp(ExprOp_Div, depth, 1);
+            }
+        }
+        else {
+            EmitSubstitute(s, depth);
+        }
+    }
+
+    Symbolic              Var;
+    std::vector<Symbolic> Opaque;
+    int                   MaxDepth;
+};
+
+// Compiles f and its symbolic derivative df(f,x).
+inline void CompileWithDerivative(const Symbolic& f, const Symbolic& x, CompiledExpr& F, CompiledExpr& DF) {
+    F.Compile(f, x);
+    DF.Compile(df(f, x), x);
+}
+
+} // namespace Hamzstlab
@@ -0,0 +1,117 @@
+// Hamzstlab Mathematics: direction field of y' = f(x, y) sized to the plot
+//
+// DirectionField places one slope segment every Spacing pixels over the visible
+// part of the current plot and draws them all with one segmented PlotLine:
+//
+//   struct Slope { template <typename T> T operator()(const T& x, const T& y) const { return 3.0 - 2.0 * x - 0.5 * y; } };
+//   static Hamzstlab::DirectionField field;
+//   if (ImPlot::BeginPlot("Field")) {
+//       ImPlot::SetupAxes("x","y");
+//       field.Update(Slope(), params_changed);   // after Setup*, before plotting
+//       field.Plot("y'");
+//       ImPlot::EndPlot();
+//   }
+//
+// Slopes are evaluated four grid points at a time with Vec4d. Every segment is
+// Length pixels long on screen whatever the aspect ratio of the axes, so the
+// field stays readable at any zoom. The grid is anchored to multiples of the
+// spacing in plot units, so panning moves the segments with the data instead of
+// resampling them under the cursor. Nothing is recomputed while the limits, the
+// plot size and f stay the same.
+
+#pragma once
+
+#include "implot.h"
+#include "hamzstlab_simd.h"
+#include <cmath>
+
+namespace Hamzstlab {
+
+struct DirectionFieldOptions {
+    double Spacing;   // distance between grid points in pixels
+    double Length;    // segment length in pixels
+    DirectionFieldOptions() { Spacing = 24; Length = 16; }
+};
+
+class DirectionField {
+public:
+    ImVector<double>      Xs, Ys;     // segment end points, two per grid point
+    int                   Points;     // grid points of the last generation
+    DirectionFieldOptions Options;
+
+    DirectionField() { Points = 0; X0 = X1 = Y0 = Y1 = 0; W = H = 0; }
+
+    // Builds the field over [x0,x1] x [y0,y1] for a view that is w x h pixels.
+    template <class F>
+    void Generate(const F& f, double x0, double x1, double y0, double y1, double w, double h) {
+        Xs.resize(0);
+        Ys.resize(0);
+        Points = 0;
+        if (!(x1 > x0) || !(y1 > y0) || w <= 0 || h <= 0 || Options.Spacing <= 0)
+            return;
+        const double px_per_x = w / (x1 - x0), px_per_y = h / (y1 - y0);
+        const double sx = Options.Spacing / px_per_x, sy = Options.Spacing / px_per_y;
+        const double gx = std::ceil(x0 / sx) * sx, gy = std::ceil(y0 / sy) * sy;
+        const int nx = (int)std::floor((x1 - gx) / sx) + 1, ny = (int)std::floor((y1 - gy) / sy) + 1;
+        if (nx <= 0 || ny <= 0)
+            return;
+        Points = nx * ny;
+        Xs.resize(2 * Points);
+        Ys.resize(2 * Points);
+        // In pixels the direction (1, m) is (px_per_x, m px_per_y). Scaling it to
+        // Length pixels and mapping back to plot units gives half extents
+        // hx = L/2 / n and hy = m L/2 / n with n = |(px_per_x, m px_per_y)| / px_per_x.
+        const Vec4d half(Options.Length / 2), ratio(px_per_y / px_per_x);
+        double lx[4], ly[4], lm[4], hx[4], hy[4];
+        int at = 0;
+        for (int j = 0; j < ny; ++j) {
+            const Vec4d y(gy + j * sy);
+            for (int i = 0; i < nx; i += 4) {
+                const Vec4d x = Vec4d::Ramp(gx + i * sx, sx);
+                const Vec4d m = f(x, y);
+                const Vec4d my = m * ratio;
+                const Vec4d s = half / (px_per_x * sqrt(1.0 + my * my));
+                s.Store(hx);
+                (s * m).Store(hy);
+                m.Store(lm);
+                x.Store(lx);
+                y.Store(ly);
+                const int lanes = nx - i < 4 ? nx - i : 4;
+                for (int l = 0; l < lanes; ++l, at += 2) {
+                    // vertical segment where the slope is infinite; NaN slopes
+                    // give NaN end points, which PlotLine skips
+                    if (std::isinf(lm[l])) {
+                        hx[l] = 0;
+                        hy[l] = Options.Length / 2 / px_per_y;
+                    }
+                    Xs[at] = lx[l] - hx[l]; Xs[at + 1] = lx[l] + hx[l];
+                    Ys[at] = ly[l] - hy[l]; Ys[at + 1] = ly[l] + hy[l];
+                }
+            }
+        }
+    }
+
+    // Regenerates the field for the current plot when its limits, its size or
+    // f itself (changed = true) differ from the last call. Call inside
+    // BeginPlot/EndPlot after the Setup calls. Returns true if it regenerated.
+    template <class F>
+    bool Update(const F& f, bool changed = false) {
+        ImPlotRect lims = ImPlot::GetPlotLimits();
+        ImVec2     size = ImPlot::GetPlotSize();
+        if (!changed && lims.X.Min == X0 && lims.X.Max == X1 && lims.Y.Min == Y0 && lims.Y.Max == Y1 && size.x == W && size.y == H)
+            return false;
+        X0 = lims.X.Min; X1 = lims.X.Max; Y0 = lims.Y.Min; Y1 = lims.Y.Max; W = size.x; H = size.y;
+        Generate(f, X0, X1, Y0, Y1, W, H);
+        return true;
+    }
+
+    void Plot(const char* label, ImPlotLineFlags flags = 0) const {
+        ImPlot::PlotLine(label, Xs.Data, Ys.Data, Xs.Size, flags | ImPlotLineFlags_Segments);
+    }
+
+private:
+    double X0, X1, Y0, Y1;
+    float  W, H;
+};
+
+} // namespace Hamzstlab
@@ -0,0 +1,152 @@
+// Hamzstlab Mathematics: ensembles of solutions of a scalar ODE y' = f(t, y)
+//
+// IntegrateEnsemble advances many initial conditions together with classical
+// RK4. States are kept as separate t and y arrays (structure of arrays) and four
+// trajectories share one Vec4d, so f is written once as a template:
+//
+//   struct Slope { template <typename T> T operator()(const T& t, const T& y) const { return 3.0 - 2.0 * t - 0.5 * y; } };
+//
+// Blocks of trajectories are spread over the thread pool. TraceEnsemble builds
+// ready-to-plot solution curves through seed points, integrating backward to
+// t_min and forward to t_max, one curve after another separated by NaN so a
+// single PlotLine draws the whole family. EnsembleFirstEvent finds where each
+// trajectory first crosses g(t, y) = 0, with g written as a template like f.
+
+#pragma once
+
+#include "hamzstlab_simd.h"
+#include "hamzstlab_parallel.h"
+#include "hamzstlab_roots.h"
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace Hamzstlab {
+
+// Integrates trajectory i from (t0[i], y0[i]) with `steps` RK4 steps of size h[i].
+// Point k of trajectory i is written to ts/ys[i * stride + k * step_stride],
+// k = 0..steps. Values with |y| > ylimit become NaN.
+template <class F>
+void IntegrateEnsemble(const F& f, const double* t0, const double* y0, const double* h, int count, int steps,
+                       double* ts, double* ys, int stride, int step_stride = 1, double ylimit = 1e12, int threads = 0) {
+    const int blocks = (count + 3) / 4;
+    ParallelFor(blocks, 16, [&](int begin, int end) {
+        const Vec4d nan(std::numeric_limits<double>::quiet_NaN()), lim(ylimit);
+        for (int b = begin; b < end; ++b) {
+            const int base = b * 4;
+            const int lanes = count - base < 4 ? count - base : 4;
+            double lt[4], ly[4], lh[4];
+            for (int l = 0; l < 4; ++l) {
+                int i = base + (l < lanes ? l : lanes - 1);
+                lt[l] = t0[i]; ly[l] = y0[i]; lh[l] = h[i];
+            }
+            Vec4d t = Vec4d::Load(lt), y = Vec4d::Load(ly), dt = Vec4d::Load(lh), half = dt * 0.5;
+            for (int k = 0; ; ++k) {
+                t.Store(lt);
+                y.Store(ly);
+                for (int l = 0; l < lanes; ++l) {
+                    // signed: a negative step_stride walks back from the trajectory's origin
+                    const ptrdiff_t at = (ptrdiff_t)(base + l) * stride + (ptrdiff_t)k * step_stride;
+                    ts[at] = lt[l];
+                    ys[at] = ly[l];
+                }
+                if (k == steps)
+                    break;
+                Vec4d k1 = f(t, y);
+                Vec4d k2 = f(t + half, y + half * k1);
+                Vec4d k3 = f(t + half, y + half * k2);
+                Vec4d k4 = f(t + dt, y + dt * k3);
+                y = y + dt * (k1 + 2.0 * (k2 + k3) + k4) / 6.0;
+                t = t + dt;
+                y = Select(fabs(y) > lim, nan, y);
+            }
+        }
+    }, threads);
+}
+
+// Solution curves through (seed_t[i], seed_y[i]) over [t_min, t_max] with `steps`
+// steps on each side of the seed. xs/ys receive count * (2 * steps + 2) values.
+template <class F>
+void TraceEnsemble(const F& f, const double* seed_t, const double* seed_y, int count, double t_min, double t_max, int steps,
+                   std::vector<double>& xs, std::vector<double>& ys, double ylimit = 1e12, int threads = 0) {
+    const int stride = 2 * steps + 2;
+    xs.resize((size_t)count * stride);
+    ys.resize((size_t)count * stride);
+    std::vector<double> hb(count), hf(count);
+    for (int i = 0; i < count; ++i) {
+        hb[i] = (t_min - seed_t[i]) / steps;
+        hf[i] = (t_max - seed_t[i]) / steps;
+        xs[(size_t)i * stride + stride - 1] = ys[(size_t)i * stride + stride - 1] = std::numeric_limits<double>::quiet_NaN();
+    }
+    // backward half, stored right to left so each curve runs from t_min to t_max
+    IntegrateEnsemble(f, seed_t, seed_y, hb.data(), count, steps, xs.data() + steps, ys.data() + steps, stride, -1, ylimit, threads);
+    IntegrateEnsemble(f, seed_t, seed_y, hf.data(), count, steps, xs.data() + steps, ys.data() + steps, stride, 1, ylimit, threads);
+}
+
+// First zero crossing of g(t, y) along trajectory i from (t0[i], y0[i]) over at
+// most `steps` RK4 steps of size h[i]. Lanes are integrated four at a time and
+// stop once all four have crossed; a crossing is located by Brent's method on
+// the cubic Hermite interpolant of the step, so h is never reduced for it.
+// event_t/event_y[i] are NaN when trajectory i does not cross.
+template <class F, class G>
+void EnsembleFirstEvent(const F& f, const G& g, const double* t0, const double* y0, const double* h, int count, int steps,
+                        double* event_t, double* event_y, int threads = 0) {
+    const int blocks = (count + 3) / 4;
+    ParallelFor(blocks, 16, [&](int begin, int end) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for (int b = begin; b < end; ++b) {
+            const int base = b * 4;
+            const int lanes = count - base < 4 ? count - base : 4;
+            double lt[4], ly[4], lh[4], ga[4], gb[4], ta[4], ya[4], fa[4], tb[4], yb[4], fb[4];
+            bool done[4];
+            for (int l = 0; l < 4; ++l) {
+                int i = base + (l < lanes ? l : lanes - 1);
+                lt[l] = t0[i]; ly[l] = y0[i]; lh[l] = h[i];
+                done[l] = l >= lanes;
+                if (l < lanes) event_t[i] = event_y[i] = nan;
+            }
+            Vec4d t = Vec4d::Load(lt), y = Vec4d::Load(ly), dt = Vec4d::Load(lh), half = dt * 0.5;
+            Vec4d k1 = f(t, y), gv = g(t, y);
+            gv.Store(ga);
+            for (int k = 0; k < steps; ++k) {
+                Vec4d k2 = f(t + half, y + half * k1);
+                Vec4d k3 = f(t + half, y + half * k2);
+                Vec4d k4 = f(t + dt, y + dt * k3);
+                Vec4d y1 = y + dt * (k1 + 2.0 * (k2 + k3) + k4) / 6.0;
+                Vec4d t1 = t + dt;
+                Vec4d f1 = f(t1, y1), g1 = g(t1, y1);
+                g1.Store(gb);
+                int active = 0;
+                for (int l = 0; l < 4; ++l) {
+                    if (done[l]) continue;
+                    if (!std::isfinite(gb[l])) { done[l] = true; continue; }
+                    ++active;
+                    if (ga[l] == 0 || (gb[l] != 0 && (ga[l] < 0) == (gb[l] < 0))) continue;
+                    t.Store(ta); y.Store(ya); k1.Store(fa); t1.Store(tb); y1.Store(yb); f1.Store(fb);
+                    const double a = ta[l], step = tb[l] - ta[l], y_a = ya[l], y_b = yb[l], f_a = fa[l], f_b = fb[l];
+                    struct Hermite {
+                        double A, H, Y0, Y1, F0, F1;
+                        double operator()(double tt) const {
+                            double s = (tt - A) / H, s2 = s * s, s3 = s2 * s;
+                            return (2 * s3 - 3 * s2 + 1) * Y0 + (s3 - 2 * s2 + s) * H * F0 + (3 * s2 - 2 * s3) * Y1 + (s3 - s2) * H * F1;
+                        }
+                    } y_of = { a, step, y_a, y_b, f_a, f_b };
+                    double te = tb[l];
+                    if (gb[l] != 0)
+                        te = Brent([&](double tt) { return g(tt, y_of(tt)); }, std::fmin(a, tb[l]), std::fmax(a, tb[l]), RootOptions(1e-13)).Root;
+                    event_t[base + l] = te;
+                    event_y[base + l] = y_of(te);
+                    done[l] = true;
+                    --active;
+                }
+                if (active == 0)
+                    break;
+                t = t1; y = y1; k1 = f1;
+                for (int l = 0; l < 4; ++l) ga[l] = gb[l];
+            }
+        }
+    }, threads);
+}
+
+} // namespace Hamzstlab
@@ -0,0 +1,157 @@
+// Hamzstlab Mathematics: event detection for the ODE integrators
+//
+// Events are zero crossings of functions g_k(t, y), all filled by one callable
+//
+//   struct Events { void operator()(double t, const double* y, double* g) const; };
+//
+// with one OdeEventSpec per g_k giving the direction of the crossing and
+// whether it ends the integration:
+//
+//   std::vector<Hamzstlab::OdeEventSpec> specs(1, Hamzstlab::OdeEventSpec(+1, true));
+//   std::vector<Hamzstlab::OdeEvent> events;
+//   Hamzstlab::OdeResult r = Hamzstlab::SolveOdeEvents(Hamzstlab::OdeMethod_RK45, Rhs(), Events(), specs, 0.0, y0, n, 100.0, opt, events);
+//
+// After every accepted step the signs of g at both ends are compared, and a
+// crossing is located with Brent's method on g(t, y(t)) where y(t) is the
+// step's dense-output interpolant, so the solver never shortens its steps to
+// find an event. A terminal event cuts the last step at the event and stops.
+// SolveStiffEvents does the same for the implicit methods.
+
+#pragma once
+
+#include "hamzstlab_ode.h"
+#include "hamzstlab_stiff.h"
+#include "hamzstlab_roots.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Hamzstlab {
+
+struct OdeEventSpec {
+    int  Direction;   // +1 only rising crossings, -1 only falling ones, 0 both
+    bool Terminal;    // stop at the first occurrence
+    OdeEventSpec(int direction = 0, bool terminal = false) { Direction = direction; Terminal = terminal; }
+};
+
+struct OdeEvent {
+    int    Index;     // which g_k crossed zero
+    int    Direction; // +1 rising, -1 falling
+    double T;
+    std::vector<double> Y;
+};
+
+// Shortens the last step of r so that it ends at t with state y and f(t, y) = fy,
+// keeping the dense output of the remaining part of the step valid.
+inline void OdeTruncateLastStep(OdeResult& r, double t, const double* y, const double* fy) {
+    const int last = r.Size() - 1, n = r.Dim;
+    if (last < 1) return;
+    const double h = r.Ts[last] - r.Ts[last - 1], h2 = t - r.Ts[last - 1];
+    if (r.DenseDegree > 0 && h != 0 && r.Q.size() >= (size_t)last * n * r.DenseDegree) {
+        // y0 + h sum q_j s^(j+1) with s = sigma h2 / h: q_j -> q_j (h2 / h)^j
+        double* q = &r.Q[(size_t)(last - 1) * n * r.DenseDegree];
+        for (int c = 0; c < n; ++c) {
+            double scale = 1;
+            for (int j = 0; j < r.DenseDegree; ++j, scale *= h2 / h)
+                q[c * r.DenseDegree + j] *= scale;
+        }
+    }
+    r.Ts[last] = t;
+    std::copy(y, y + n, r.Ys.begin() + (size_t)last * n);
+    if (r.Dys.size() == r.Ys.size())
+        std::copy(fy, fy + n, r.Dys.begin() + (size_t)last * n);
+}
+
+namespace detail {
+
+// Orders events along the direction of integration.
+struct EventBefore {
+    bool Forward;
+    bool operator()(const OdeEvent& a, const OdeEvent& b) const { return Forward ? a.T < b.T : a.T > b.T; }
+};
+
+template <class F, class G>
+struct EventObserver {
+    const F& Rhs;
+    const G& Fn;
+    const std::vector<OdeEventSpec>& Specs;
+    std::vector<OdeEvent>& Events;
+    std::vector<double> G0, G1, GT, Y;
+    RootOptions Root;
+
+    EventObserver(const F& f, const G& g, const std::vector<OdeEventSpec>& specs, std::vector<OdeEvent>& events)
+        : Rhs(f), Fn(g), Specs(specs), Events(events) { Root.XTol = 1e-13; }
+
+    void Start(double t0, const double* y0, int n) {
+        G0.resize(Specs.size());
+        G1.resize(Specs.size());
+        GT.resize(Specs.size());
+        Y.resize(n);
+        if (!Specs.empty()) Fn(t0, y0, G0.data());
+    }
+
+    bool operator()(OdeResult& r) {
+        if (Specs.empty()) return true;
+        const int last = r.Size() - 1, n = r.Dim;
+        const double ta = r.Ts[last - 1], tb = r.Ts[last];
+        Fn(tb, r.Y(last), G1.data());
+        const size_t first = Events.size();
+        for (size_t k = 0; k < Specs.size(); ++k) {
+            const double a = G0[k], b = G1[k];
+            // a zero at ta was reported by the previous step
+            if (a == 0 || (b != 0 && (a < 0) == (b < 0))) continue;
+            const int dir = b > a ? 1 : -1;
+            if (Specs[k].Direction != 0 && Specs[k].Direction != dir) continue;
+            double te = tb;
+            if (b != 0)
+                te = Brent([&](double t) { r.Eval(t, Y.data()); Fn(t, Y.data(), GT.data()); return GT[k]; },
+                           std::fmin(ta, tb), std::fmax(ta, tb), Root).Root;
+            OdeEvent e;
+            e.Index = (int)k;
+            e.Direction = dir;
+            e.T = te;
+            e.Y.resize(n);
+            r.Eval(te, e.Y.data());
+            Events.push_back(e);
+        }
+        // in the order they happen; a terminal event drops everything after it
+        EventBefore before = { tb >= ta };
+        std::stable_sort(Events.begin() + first, Events.end(), before);
+        for (size_t i = first; i < Events.size(); ++i)
+            if (Specs[Events[i].Index].Terminal) {
+                Events.resize(i + 1);
+                std::vector<double> fy(n);
+                Rhs(Events[i].T, Events[i].Y.data(), fy.data());
+                ++r.Evaluations;
+                OdeTruncateLastStep(r, Events[i].T, Events[i].Y.data(), fy.data());
+                return false;
+            }
+        G0.swap(G1);
+        return true;
+    }
+};
+
+} // namespace detail
+
+// SolveOde with event detection; forces dense output. Events are appended to
+// `events` in the order they occur.
+template <class F, class G>
+OdeResult SolveOdeEvents(int method, const F& f, const G& g, const std::vector<OdeEventSpec>& specs, double t0, const double* y0, int n, double t1,
+                         OdeOptions opt, std::vector<OdeEvent>& events) {
+    opt.Dense = true;
+    detail::EventObserver<F, G> observe(f, g, specs, events);
+    observe.Start(t0, y0, n);
+    OdeWorkspace ws;
+    return SolveOde(method, f, t0, y0, n, t1, opt, ws, observe);
+}
+
+template <class F, class G>
+OdeResult SolveStiffEvents(int method, const F& f, const G& g, const std::vector<OdeEventSpec>& specs, double t0, const double* y0, int n, double t1,
+                           OdeOptions opt, std::vector<OdeEvent>& events) {
+    opt.Dense = true;
+    detail::EventObserver<F, G> observe(f, g, specs, events);
+    observe.Start(t0, y0, n);
+    return SolveStiff(method, f, t0, y0, n, t1, opt, observe);
+}
+
+} // namespace Hamzstlab
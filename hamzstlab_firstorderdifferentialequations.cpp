@@ -44,6 +44,17 @@
 #endif
 
 #include <iostream>
+#include "hamzstlab_sampling.h"
+#include "hamzstlab_ode.h"
+#include "hamzstlab_stiff.h"
+#include "hamzstlab_events.h"
+#include "hamzstlab_jobs.h"
+#include "hamzstlab_ensemble.h"
+#include "hamzstlab_directionfield.h"
+#include "hamzstlab_symplectic.h"
+#include "hamzstlab_bifurcation.h"
+#include "hamzstlab_sde.h"
+#include <chrono>
 #define CHECKBOX_FLAG(flags, flag) ImGui::CheckboxFlags(#flag, (unsigned int*)&flags, flag)
 
 #if !defined(IMGUI_DISABLE_DEMO_WINDOWS)
@@ -95,30 +106,13 @@ ImVec4 RandomColor() {
 }
 
 double RandomGauss() {
-	static double V1, V2, S;
-	static int phase = 0;
-	double X;
-	if(phase == 0) {
-		do {
-			double U1 = (double)rand() / RAND_MAX;
-			double U2 = (double)rand() / RAND_MAX;
-			V1 = 2 * U1 - 1;
-			V2 = 2 * U2 - 1;
-			S = V1 * V1 + V2 * V2;
-			} while(S >= 1 || S == 0);
-
-		X = V1 * sqrt(-2 * log(S) / S);
-	} else
-		X = V2 * sqrt(-2 * log(S) / S);
-	phase = 1 - phase;
-	return X;
+	return Hamzstlab::Normal(Hamzstlab::ThreadEngine());
 }
 
 template <int N>
 struct NormalDistribution {
     NormalDistribution(double mean, double sd) {
-        for (int i = 0; i < N; ++i)
-            Data[i] = RandomGauss()*sd + mean;
+        Hamzstlab::FillNormal(Hamzstlab::ThreadEngine(), Data, N, mean, sd);
     }
     double Data[N];
 };
@@ -291,161 +285,748 @@ double df(double x, double y)
 return 3-2*x-0.5*y;
 }
 
+// y(t) = 14 - 4t - 13exp(-t/2), the exact solution of y' = df(t,y), y(0) = 1
+struct ExactSolution {
+    double operator()(double t) const { return 14.0 - 4.0 * t - 13.0 * exp(-0.5 * t); }
+};
+
+// Right-hand side of y' = df(t,y) for hamzstlab_ode.h.
+struct IvpRhs {
+    void operator()(double t, const double* y, double* dydt) const { dydt[0] = df(t, y[0]); }
+};
+
 void Demo_LinePlots() {
-    static float xs1[1001], ys1[1001];
-    for (int i = 0; i < 1001; ++i) {
-        xs1[i] = i * 0.001f;
-        ys1[i] = 14.0f - (4.0f * (xs1[i]) ) - 13.0f*(exp(-0.5f*xs1[i]));
-    }
-   float x0 = 0;
-   float y0 = 1;
-   float h = 0.2;
-   float x = 1;
-   float c;
-   int n = x / 0.2;
-   
-   static double xs2[6], ys2[6];
-   xs2[0] = x0;
-   ys2[0] = y0;
-   for (int i = 1; i <= n+1; ++i) 
-   {    
-        c = ys2[i-1];
-	xs2[i] = xs2[i-1] + h;
-	ys2[i] = c + df(xs2[i-1],ys2[i-1])*h;	
-   }
+    static Hamzstlab::CurveSampler curve;
+    static Hamzstlab::CurveSampler dense;   // the solver's interpolant between its steps
+	static int method = Hamzstlab::OdeMethod_Euler;
+	static float h = 0.2f;
+	static float t_end = 1.0f;
+	static float tol = -6.0f;   // log10 of RelTol = AbsTol
+	static Hamzstlab::OdeResult res;
+	static double max_err = 0;
+	static bool dirty = true;
+
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::BeginCombo("Method", Hamzstlab::OdeMethodName(method))) {
+		for (int m = 0; m < Hamzstlab::OdeMethod_COUNT; ++m)
+			if (ImGui::Selectable(Hamzstlab::OdeMethodName(m), m == method)) { method = m; dirty = true; }
+		ImGui::EndCombo();
+	}
+	ImGui::SetNextItemWidth(200);
+	if (Hamzstlab::OdeMethodAdaptive(method))
+		dirty |= ImGui::SliderFloat("log10(tolerance)", &tol, -12.0f, -2.0f, "%.1f");
+	else
+		dirty |= ImGui::SliderFloat("Step size h", &h, 0.001f, 0.5f, "%.3f", ImGuiSliderFlags_Logarithmic);
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderFloat("End time", &t_end, 0.5f, 20.0f, "%.1f");
+
+	const bool solved = dirty;
+	if (dirty) {
+		Hamzstlab::OdeOptions opt;
+		opt.Dense = true;
+		opt.H = Hamzstlab::OdeMethodAdaptive(method) ? 0 : h;
+		opt.RelTol = opt.AbsTol = pow(10.0, (double)tol);
+		double y0 = 1;
+		res = Hamzstlab::SolveOde(method, IvpRhs(), 0.0, &y0, 1, t_end, opt);
+		max_err = 0;
+		for (int i = 0; i < res.Size(); ++i)
+			max_err = fmax(max_err, fabs(res.Y(i)[0] - ExactSolution()(res.Ts[i])));
+		dirty = false;
+	}
+	ImGui::Text("%d steps (%d rejected), %d RHS evaluations, max error %.3e", res.Steps, res.Rejected, res.Evaluations, max_err);
+
     if (ImPlot::BeginPlot("Initial value Problem with dy/dt = 3 - 2t - 0.5y and y(0)=1")) {
         ImPlot::SetupAxes("t","y");
 	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
         
-        ImPlot::PlotLine("y(t) = 14 - 4t - 13exp(-t/2)", xs1, ys1, 1001);
+        curve.Update(ExactSolution());
+        curve.Plot("y(t) = 14 - 4t - 13exp(-t/2)");
+        dense.Update(Hamzstlab::OdeComponent(res, 0), solved);
+        dense.Plot(Hamzstlab::OdeMethodName(method));
         ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
-        ImPlot::PlotScatter("Euler's Approximation", xs2, ys2, n+1);
+        ImPlot::PlotScatter(Hamzstlab::OdeMethodName(method), res.Ts.data(), res.Ys.data(), res.Size());
+	ImPlot::EndPlot();
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Van der Pol oscillator y'' - mu (1 - y^2) y' + y = 0, stiff for large mu.
+struct VanDerPol {
+    double Mu;
+    void operator()(double, const double* y, double* dydt) const {
+        dydt[0] = y[1];
+        dydt[1] = Mu * (1 - y[0] * y[0]) * y[1] - y[0];
+    }
+};
+
+// Robertson's chemical kinetics, reaction rates 0.04, 3e7 and 1e4.
+struct Robertson {
+    void operator()(double, const double* y, double* dydt) const {
+        dydt[0] = -0.04 * y[0] + 1e4 * y[1] * y[2];
+        dydt[2] = 3e7 * y[1] * y[1];
+        dydt[1] = -dydt[0] - dydt[2];
+    }
+};
+
+// Implicit methods of hamzstlab_stiff.h against RK45 on a stiff problem: the
+// explicit method's step is bounded by stability, not by accuracy.
+void Demo_StiffEquations() {
+	const int count = Hamzstlab::StiffMethod_COUNT + 1;   // last entry is RK45
+	static int problem = 0;
+	static float mu = 1000;
+	static float tol = -6;      // log10 of RelTol
+	static int component = 0;
+	static bool explicit_rk = true;
+	static Hamzstlab::OdeResult res[count];
+	static ImVector<double> comp[count];
+	static int shown = -1;      // component copied into comp
+	static bool dirty = true;
+
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::Combo("Problem", &problem, "Van der Pol\0Robertson\0");
+	if (problem == 0) {
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(200);
+		// every method, RK45 included, is re-solved only once the slider is released
+		ImGui::SliderFloat("mu", &mu, 1, 10000, "%.0f", ImGuiSliderFlags_Logarithmic);
+		dirty |= ImGui::IsItemDeactivatedAfterEdit();
+	}
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderFloat("log10(RelTol)", &tol, -10, -2, "%.1f");
+	dirty |= ImGui::IsItemDeactivatedAfterEdit();
+	ImGui::SameLine();
+	dirty |= ImGui::Checkbox("Compare with RK45", &explicit_rk);
+	const int dim = problem == 0 ? 2 : 3;
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderInt("Component", &component, 0, dim - 1);
+	if (component >= dim) component = dim - 1;
+
+	if (dirty) {
+		Hamzstlab::OdeOptions opt;
+		opt.H = 0;
+		opt.RelTol = pow(10.0, (double)tol);
+		opt.AbsTol = problem == 0 ? opt.RelTol : 1e-4 * opt.RelTol;
+		const double vdp0[] = { 2, 0 }, rob0[] = { 1, 0, 0 };
+		const double t_end = problem == 0 ? fmax(20.0, 3.0 * mu) : 1e5;
+		for (int m = 0; m < count; ++m) {
+			const bool rk = m == count - 1;
+			if (rk && !explicit_rk) { res[m] = Hamzstlab::OdeResult(); comp[m].resize(0); continue; }
+			Hamzstlab::OdeOptions o = opt;
+			if (rk) o.MaxSteps = 200000;   // enough to show where RK45 gives up
+			if (problem == 0) {
+				VanDerPol vdp = { mu };
+				res[m] = rk ? Hamzstlab::SolveOde(Hamzstlab::OdeMethod_RK45, vdp, 0.0, vdp0, 2, t_end, o) : Hamzstlab::SolveStiff(m, vdp, 0.0, vdp0, 2, t_end, o);
+			}
+			else
+				res[m] = rk ? Hamzstlab::SolveOde(Hamzstlab::OdeMethod_RK45, Robertson(), 0.0, rob0, 3, t_end, o) : Hamzstlab::SolveStiff(m, Robertson(), 0.0, rob0, 3, t_end, o);
+		}
+		dirty = false;
+		shown = -1;
+	}
+	if (shown != component) {
+		for (int m = 0; m < count; ++m) {
+			comp[m].resize(res[m].Size());
+			for (int i = 0; i < res[m].Size(); ++i)
+				comp[m][i] = res[m].Y(i)[component];
+		}
+		shown = component;
+	}
+
+	if (ImGui::BeginTable("##Stiff", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+		ImGui::TableSetupColumn("Method");
+		ImGui::TableSetupColumn("Steps");
+		ImGui::TableSetupColumn("Rejected");
+		ImGui::TableSetupColumn("f evals");
+		ImGui::TableSetupColumn("Jacobians");
+		ImGui::TableSetupColumn("LU");
+		ImGui::TableSetupColumn("Time (ms)");
+		ImGui::TableHeadersRow();
+		for (int m = 0; m < count; ++m) {
+			const Hamzstlab::OdeResult& r = res[m];
+			if (r.Size() == 0) continue;
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			if (r.Success) ImGui::TextUnformatted(m == count - 1 ? "RK45" : Hamzstlab::StiffMethodName(m));
+			else           ImGui::Text("%s (stopped at t = %.4g)", m == count - 1 ? "RK45" : Hamzstlab::StiffMethodName(m), r.Ts.back());
+			ImGui::TableNextColumn(); ImGui::Text("%d", r.Steps);
+			ImGui::TableNextColumn(); ImGui::Text("%d", r.Rejected);
+			ImGui::TableNextColumn(); ImGui::Text("%d", r.Evaluations);
+			ImGui::TableNextColumn(); ImGui::Text("%d", r.Jacobians);
+			ImGui::TableNextColumn(); ImGui::Text("%d", r.Factorizations);
+			ImGui::TableNextColumn(); ImGui::Text("%.2f", r.Seconds * 1e3);
+		}
+		ImGui::EndTable();
+	}
+
+	if (ImPlot::BeginPlot(problem == 0 ? "Van der Pol" : "Robertson")) {
+	ImPlot::SetupAxes("t", "y", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+	if (problem == 1)
+		ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
+	for (int m = 0; m < count; ++m) {
+		// Robertson starts at t = 0, which has no place on a log axis
+		const int skip = problem == 1 && comp[m].Size > 0 ? 1 : 0;
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 2);
+		ImPlot::PlotLine(m == count - 1 ? "RK45" : Hamzstlab::StiffMethodName(m), res[m].Ts.data() + skip, comp[m].Data + skip, comp[m].Size - skip);
+	}
 	ImPlot::EndPlot();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Lorenz system x' = sigma (y - x), y' = x (rho - z) - y, z' = x y - beta z.
+struct Lorenz {
+    double Sigma, Rho, Beta;
+    void operator()(double, const double* y, double* dydt) const {
+        dydt[0] = Sigma * (y[1] - y[0]);
+        dydt[1] = y[0] * (Rho - y[2]) - y[1];
+        dydt[2] = y[0] * y[1] - Beta * y[2];
     }
+};
+
+// A long, tight-tolerance integration on the background worker of
+// hamzstlab_jobs.h. The plot grows chunk by chunk while the UI stays
+// responsive; moving a slider cancels the running solve and starts over.
+void Demo_LorenzAttractor() {
+	static Hamzstlab::ProgressiveOde solve;
+	const int max_steps = 1000000;  // keeps the UI-side copy of the solution to 32 MB
+	static float sigma = 10, rho = 28, beta = 8.0f / 3;
+	static float t_end = 1000;
+	static float tol = -10;     // log10 of RelTol
+	static bool dirty = true;
+
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderFloat("sigma", &sigma, 0.1f, 30.0f);
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderFloat("rho", &rho, 0.1f, 100.0f);
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderFloat("beta", &beta, 0.1f, 10.0f);
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderFloat("End time", &t_end, 10.0f, 10000.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderFloat("log10(RelTol)", &tol, -13.0f, -3.0f, "%.1f");
+
+	if (dirty) {
+		Hamzstlab::OdeOptions opt;
+		opt.H = 0;
+		opt.RelTol = pow(10.0, (double)tol);
+		opt.AbsTol = 1e-3 * opt.RelTol;
+		opt.MaxSteps = max_steps;
+		const double y0[] = { 1, 1, 1 };
+		Lorenz f = { sigma, rho, beta };
+		solve.Start(Hamzstlab::OdeMethod_RK45, f, 0.0, y0, 3, t_end, opt);
+		dirty = false;
+	}
+	solve.Poll();
+
+	const Hamzstlab::OdeResult& r = solve.Result;
+	const double t_now = r.Size() > 0 ? r.Ts.back() : 0;
+	char overlay[64];
+	sprintf(overlay, "t = %.1f / %.0f", t_now, t_end);
+	ImGui::ProgressBar((float)(t_now / t_end), ImVec2(400, 0), overlay);
+	ImGui::SameLine();
+	if (solve.Done)
+		ImGui::Text("%d steps, %d RHS evaluations in %.2f s%s", r.Steps, r.Evaluations, r.Seconds,
+			r.Success ? "" : (r.Steps + r.Rejected >= max_steps ? " (step limit reached; loosen the tolerance)" : " (stopped)"));
+	else
+		ImGui::Text("%d steps so far", r.Steps);
+
+	if (ImPlot::BeginPlot("Lorenz Attractor", ImVec2(-1, 500))) {
+	ImPlot::SetupAxes("x", "z");
+	ImPlot::SetupAxesLimits(-30, 30, 0, 60);
+	// x and z read straight from the interleaved states; very long solutions
+	// draw every k-th state to keep the frame time bounded
+	if (r.Size() > 0) {
+		const int k = 1 + r.Size() / 250000;
+		ImPlot::PlotLine("(x(t), z(t))", &r.Ys[0], &r.Ys[2], (r.Size() + k - 1) / k, 0, 0, k * 3 * sizeof(double));
+	}
+	ImPlot::EndPlot();
+	}
 }
 
 //-----------------------------------------------------------------------------
+// H = p^2 / 2 - cos q
+struct Pendulum {
+    void   Velocity(const double* p, double* dq) const { dq[0] = p[0]; }
+    void   Force(const double* q, double* dp) const { dp[0] = -sin(q[0]); }
+    double Energy(const double* q, const double* p) const { return 0.5 * p[0] * p[0] - cos(q[0]); }
+};
+
+// H = |p|^2 / 2 - 1 / |q|, a planet around a unit mass
+struct KeplerOrbit {
+    void Velocity(const double* p, double* dq) const { dq[0] = p[0]; dq[1] = p[1]; }
+    void Force(const double* q, double* dp) const {
+        const double r2 = q[0] * q[0] + q[1] * q[1], r3 = r2 * sqrt(r2);
+        dp[0] = -q[0] / r3;
+        dp[1] = -q[1] / r3;
+    }
+    double Energy(const double* q, const double* p) const { return 0.5 * (p[0] * p[0] + p[1] * p[1]) - 1 / sqrt(q[0] * q[0] + q[1] * q[1]); }
+};
+
+// Largest energy error in each time bin, so that 1e7 steps fit in one plot.
+struct DriftEnvelope {
+    double          Bin, Next, Max;
+    ScrollingBuffer Data;
+    DriftEnvelope() : Data(4096) { Bin = Next = 1; Max = 0; }
+    void Reset(double bin) { Bin = Next = bin; Max = 0; Data.Erase(); }
+    void Add(double t, double drift) {
+        if (drift > Max) Max = drift;
+        if (t >= Next) {
+            Data.AddPoint((float)t, (float)(Max > 1e-17 ? Max : 1e-17));
+            Max = 0;
+            Next += Bin;
+        }
+    }
+};
+
+// Steps s one step at a time, streaming (x, y) into the phase portrait. Stops
+// after `count` steps or once `budget_ms` has passed, checking the clock every
+// 1024 steps, so a slow method or a large count cannot stall the frame.
+template <class S>
+void AdvanceHamiltonian(Hamzstlab::SymplecticIntegrator<S>& s, double h, int count, double budget_ms, const double* x, const double* y,
+                        ScrollingBuffer& phase, DriftEnvelope& drift) {
+    const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now() + std::chrono::microseconds((long long)(1000 * budget_ms));
+    for (int i = 0; i < count; ++i) {
+        s.Step(h);
+        phase.AddPoint((float)*x, (float)*y);
+        drift.Add(s.T, fabs(s.Energy() - s.Energy0));
+        if ((i & 1023) == 1023 && std::chrono::steady_clock::now() >= stop)
+            break;
+    }
+}
+
+// Long fixed-step runs of the symplectic integrators of hamzstlab_symplectic.h,
+// up to "Steps per frame" steps in at most 4 ms of each frame. The phase
+// portrait keeps the last steps in a ring buffer; the energy plot compares the
+// bounded error of the symplectic method with RK45 solving the same system on
+// the background worker.
+void Demo_HamiltonianSystems() {
+	static Hamzstlab::SymplecticIntegrator<Pendulum> pendulum;
+	static Hamzstlab::SymplecticIntegrator<KeplerOrbit> kepler;
+	static Hamzstlab::ProgressiveOde reference;
+	static ScrollingBuffer phase(4000);
+	static DriftEnvelope drift, rk_drift;
+	static int system = 0, method = Hamzstlab::SymplecticMethod_Yoshida4;
+	static float h = 0.01f, ecc = 0.6f, q0 = 2.0f;
+	static int total = 10000000, per_frame = 100000;
+	static bool compare = true;
+	static float tol = -8;      // log10 of RK45 RelTol
+	static int rk_seen = 0;     // reference points already in rk_drift
+	static bool dirty = true;
+	const double frame_ms = 4;  // stepping budget per frame
+
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::Combo("System", &system, "Pendulum\0Kepler orbit\0");
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	if (system == 0)
+		dirty |= ImGui::SliderFloat("q(0)", &q0, 0.1f, 3.1f, "%.2f");
+	else
+		dirty |= ImGui::SliderFloat("Eccentricity", &ecc, 0.0f, 0.9f, "%.2f");
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::BeginCombo("Method", Hamzstlab::SymplecticMethodName(method))) {
+		for (int m = 0; m < Hamzstlab::SymplecticMethod_COUNT; ++m)
+			if (ImGui::Selectable(Hamzstlab::SymplecticMethodName(m), m == method)) { method = m; dirty = true; }
+		ImGui::EndCombo();
+	}
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderFloat("Step size h", &h, 0.001f, 0.5f, "%.3f", ImGuiSliderFlags_Logarithmic);
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderInt("Steps", &total, 10000, 10000000, "%d", ImGuiSliderFlags_Logarithmic);
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderInt("Steps per frame", &per_frame, 1000, 1000000, "%d", ImGuiSliderFlags_Logarithmic);
+	dirty |= ImGui::Checkbox("Compare with RK45", &compare);
+	if (compare) {
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderFloat("log10(RelTol)", &tol, -12.0f, -4.0f, "%.1f");
+	}
+
+	const double t_end = (double)total * h;
+	if (dirty) {
+		const double pendulum0[] = { q0, 0 };
+		const double kepler0[] = { 1 - ecc, 0, 0, sqrt((1 + ecc) / (1 - ecc)) };
+		const double* y0 = system == 0 ? pendulum0 : kepler0;
+		const int n = system == 0 ? 1 : 2;
+		if (system == 0) pendulum.Init(method, Pendulum(), y0, y0 + n, n);
+		else             kepler.Init(method, KeplerOrbit(), y0, y0 + n, n);
+		phase.Erase();
+		drift.Reset(t_end / 2000);
+		rk_drift.Reset(t_end / 2000);
+		rk_seen = 0;
+		if (compare) {
+			Hamzstlab::OdeOptions opt;
+			opt.H = 0;
+			opt.RelTol = pow(10.0, (double)tol);
+			opt.AbsTol = 1e-2 * opt.RelTol;
+			opt.MaxSteps = 100000000;
+			if (system == 0) { Hamzstlab::SymplecticRhs<Pendulum> f = { Pendulum(), 1 }; reference.Start(Hamzstlab::OdeMethod_RK45, f, 0.0, y0, 2, t_end, opt); }
+			else             { Hamzstlab::SymplecticRhs<KeplerOrbit> f = { KeplerOrbit(), 2 }; reference.Start(Hamzstlab::OdeMethod_RK45, f, 0.0, y0, 4, t_end, opt); }
+		}
+		else
+			reference.Cancel();
+		dirty = false;
+	}
+
+	// symplectic run: a slice of the steps every frame, cut short by the time budget
+	long long steps, evals;
+	if (system == 0) {
+		const int count = (int)std::min<long long>(per_frame, total - pendulum.Steps);
+		AdvanceHamiltonian(pendulum, h, count, frame_ms, &pendulum.Q[0], &pendulum.P[0], phase, drift);
+		steps = pendulum.Steps; evals = pendulum.Evaluations;
+	}
+	else {
+		const int count = (int)std::min<long long>(per_frame, total - kepler.Steps);
+		AdvanceHamiltonian(kepler, h, count, frame_ms, &kepler.Q[0], &kepler.Q[1], phase, drift);
+		steps = kepler.Steps; evals = kepler.Evaluations;
+	}
+
+	// reference run: energy of the states that arrived since the last frame,
+	// which are then dropped so the UI holds one chunk, not the trajectory
+	if (compare) {
+		reference.Poll();
+		const Hamzstlab::OdeResult& r = reference.Result;
+		const int n = r.Dim / 2;
+		for (; rk_seen < r.Size(); ++rk_seen) {
+			const double* y = r.Y(rk_seen);
+			const double e = system == 0 ? Pendulum().Energy(y, y + n) : KeplerOrbit().Energy(y, y + n);
+			const double e0 = system == 0 ? pendulum.Energy0 : kepler.Energy0;
+			rk_drift.Add(r.Ts[rk_seen], fabs(e - e0));
+		}
+		reference.Trim();
+		rk_seen = r.Size();
+	}
+
+	char overlay[64];
+	sprintf(overlay, "%lld / %d steps", steps, total);
+	ImGui::ProgressBar((float)steps / total, ImVec2(400, 0), overlay);
+	ImGui::SameLine();
+	ImGui::Text("%s: %lld force evaluations", Hamzstlab::SymplecticMethodName(method), evals);
+	if (compare) {
+		const Hamzstlab::OdeResult& r = reference.Result;
+		ImGui::SameLine();
+		ImGui::Text("| RK45: t = %.0f, %d RHS evaluations%s", r.Size() > 0 ? r.Ts.back() : 0.0, r.Evaluations, reference.Done ? "" : " ...");
+	}
+
+	if (ImPlot::BeginPlot("Phase portrait", ImVec2(500, 500), ImPlotFlags_Equal)) {
+		ImPlot::SetupAxes(system == 0 ? "q" : "x", system == 0 ? "p" : "y", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		if (phase.Data.size() > 0)
+			ImPlot::PlotLine("last steps", &phase.Data[0].x, &phase.Data[0].y, phase.Data.size(), 0, phase.Offset, 2 * sizeof(float));
+		ImPlot::EndPlot();
+	}
+	ImGui::SameLine();
+	if (ImPlot::BeginPlot("Energy drift", ImVec2(-1, 500))) {
+		ImPlot::SetupAxes("t", "max |H - H(0)|", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+		if (drift.Data.Data.size() > 0)
+			ImPlot::PlotLine(Hamzstlab::SymplecticMethodName(method), &drift.Data.Data[0].x, &drift.Data.Data[0].y, drift.Data.Data.size(), 0, drift.Data.Offset, 2 * sizeof(float));
+		if (compare && rk_drift.Data.Data.size() > 0)
+			ImPlot::PlotLine("RK45", &rk_drift.Data.Data[0].x, &rk_drift.Data.Data[0].y, rk_drift.Data.Data.size(), 0, rk_drift.Data.Offset, 2 * sizeof(float));
+		ImPlot::EndPlot();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Monte Carlo bands of a stochastic process; the worker hands back one
+// SdeBands per simulation, tagged with the job that produced it.
+struct SdeJobResult {
+    unsigned            Generation;
+    Hamzstlab::SdeBands Bands;
+    SdeJobResult() { Generation = 0; }
+};
+
+// Geometric Brownian motion and the Ornstein-Uhlenbeck process simulated with
+// hamzstlab_sde.h on a background worker that spreads the paths over the
+// background thread pool, so the other demos' ParallelFor calls never wait for
+// it. Only the quantile bands come back, a few times a second while the paths
+// run and once at the end, so a million paths take no more memory than a
+// thousand, and the counter-based random numbers give the same bands with or
+// without threads.
+void Demo_StochasticDE() {
+	static Hamzstlab::SpscQueue<SdeJobResult, 4> results;
+	static Hamzstlab::JobRunner runner;   // after results: joins its thread first
+	static Hamzstlab::SdeBands bands;
+	static unsigned generation = 0;
+	static int process = 0, method = Hamzstlab::SdeMethod_EulerMaruyama;
+	static float mu = 0.05f, sigma = 0.2f, theta = 2.0f, level = 1.0f, x0 = 1.0f, t_end = 1.0f;
+	static int steps = 250, paths = 100000, seed = 0;
+	static bool mt = true;
+	static ImVector<double> ts, samples, mean;
+	static bool dirty = true;
+	const int sample_count = 8;
+
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::Combo("Process", &process, "Geometric Brownian motion\0Ornstein-Uhlenbeck\0");
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::BeginCombo("Method", Hamzstlab::SdeMethodName(method))) {
+		for (int m = 0; m < Hamzstlab::SdeMethod_COUNT; ++m)
+			if (ImGui::Selectable(Hamzstlab::SdeMethodName(m), m == method)) { method = m; dirty = true; }
+		ImGui::EndCombo();
+	}
+	if (process == 0) {
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderFloat("mu", &mu, -1.0f, 1.0f, "%.2f");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderFloat("sigma", &sigma, 0.0f, 1.0f, "%.2f");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderFloat("X(0)", &x0, 0.1f, 5.0f, "%.2f");
+	}
+	else {
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderFloat("theta", &theta, 0.1f, 10.0f, "%.2f");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderFloat("mean level", &level, -2.0f, 2.0f, "%.2f");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderFloat("sigma", &sigma, 0.0f, 2.0f, "%.2f");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderFloat("X(0)", &x0, -2.0f, 5.0f, "%.2f");
+	}
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderFloat("End time", &t_end, 0.1f, 10.0f, "%.1f");
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderInt("Steps", &steps, 10, 2000, "%d", ImGuiSliderFlags_Logarithmic);
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderInt("Paths", &paths, 1000, 10000000, "%d", ImGuiSliderFlags_Logarithmic);
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::InputInt("Seed", &seed);
+	ImGui::SameLine();
+	dirty |= ImGui::Checkbox("Multithreaded", &mt);
+
+	const Hamzstlab::GeometricBrownianMotion gbm = { (double)mu, (double)sigma };
+	const Hamzstlab::OrnsteinUhlenbeck ou = { (double)theta, (double)level, (double)sigma };
+	if (dirty) {
+		Hamzstlab::SdeOptions opt;
+		opt.Steps = steps;
+		opt.Paths = paths;
+		opt.Seed = (uint64_t)(unsigned)seed;
+		opt.Threads = mt ? 0 : 1;
+		const double start = x0, t1 = t_end;
+		const int proc = process, meth = method;
+		Hamzstlab::SpscQueue<SdeJobResult, 4>* queue = &results;
+		generation = runner.Submit([=](const Hamzstlab::JobToken& token) {
+			static const double levels[] = { 0.05, 0.25, 0.5, 0.75, 0.95 };
+			std::vector<double> lv(levels, levels + 5);
+			std::function<bool()> cancelled = [&token]() { return token.Cancelled(); };
+			// partial bands as blocks finish; dropped when the UI is behind
+			std::function<void(const Hamzstlab::SdeBands&)> progress = [&token, queue](const Hamzstlab::SdeBands& b) {
+				SdeJobResult p;
+				p.Generation = token.Generation;
+				p.Bands = b;
+				queue->Push(p);
+			};
+			SdeJobResult r;
+			r.Generation = token.Generation;
+			r.Bands = proc == 0 ? Hamzstlab::SimulateSde(meth, gbm, 0.0, start, t1, opt, lv, cancelled, progress)
+			                    : Hamzstlab::SimulateSde(meth, ou, 0.0, start, t1, opt, lv, cancelled, progress);
+			while (!token.Cancelled() && !queue->Push(r))
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		});
+		// a few members of the ensemble, drawn with the same random numbers
+		std::vector<double> xs;
+		samples.resize(sample_count * (steps + 1));
+		for (int i = 0; i < sample_count; ++i) {
+			if (process == 0) Hamzstlab::SdePath(method, gbm, 0.0, (double)x0, (double)t_end, opt, i, xs);
+			else              Hamzstlab::SdePath(method, ou, 0.0, (double)x0, (double)t_end, opt, i, xs);
+			std::copy(xs.begin(), xs.end(), samples.Data + i * (steps + 1));
+		}
+		ts.resize(steps + 1);
+		mean.resize(steps + 1);
+		for (int k = 0; k <= steps; ++k) {
+			ts[k] = (double)t_end * k / steps;
+			mean[k] = process == 0 ? gbm.Mean(ts[k], x0) : ou.Mean(ts[k], x0);
+		}
+		dirty = false;
+	}
+	SdeJobResult r;
+	while (results.Pop(r))
+		if (r.Generation == generation)
+			bands = r.Bands;
+
+	if (bands.Size() > 0) {
+		ImGui::Text("%lld paths in %.3f s (%d threads), median X(T) = %.10f%s", bands.Paths, bands.Seconds, mt ? Hamzstlab::ThreadCount() : 1,
+		            bands.Band(2)[bands.Size() - 1], bands.Complete ? "" : (runner.Busy() ? "  [simulating...]" : "  [stopped]"));
+	}
+	else
+		ImGui::Text("simulating...");
+
+	if (ImPlot::BeginPlot("Quantile bands", ImVec2(-1, 500))) {
+		ImPlot::SetupAxes("t", "X(t)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		const int n = bands.Size();
+		if (n > 0) {
+			const ImVec4 col = ImPlot::GetColormapColor(0);
+			ImPlot::SetNextFillStyle(col, 0.2f);
+			ImPlot::PlotShaded("5% - 95%", bands.Ts.data(), bands.Band(0), bands.Band(4), n);
+			ImPlot::SetNextFillStyle(col, 0.4f);
+			ImPlot::PlotShaded("25% - 75%", bands.Ts.data(), bands.Band(1), bands.Band(3), n);
+			ImPlot::SetNextLineStyle(col, 2);
+			ImPlot::PlotLine("median", bands.Ts.data(), bands.Band(2), n);
+		}
+		ImPlot::SetNextLineStyle(ImVec4(1, 1, 1, 1));
+		ImPlot::PlotLine("E[X(t)] exact", ts.Data, mean.Data, ts.Size);
+		for (int i = 0; i < sample_count; ++i) {
+			ImPlot::SetNextLineStyle(ImVec4(0.8f, 0.8f, 0.8f, 0.35f));
+			ImPlot::PlotLine("sample paths", ts.Data, samples.Data + i * ts.Size, ts.Size);
+		}
+		ImPlot::EndPlot();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// y' = 3 - 2t - 0.5y written once for doubles and four-lane vectors.
+struct DirectionFieldSlope {
+    template <typename T> T operator()(const T& t, const T& y) const { return 3.0 - 2.0 * t - 0.5 * y; }
+};
+
+// g(t, y) = y - C: the solution reaches the level y = C.
+struct LevelCrossing {
+    double C;
+    template <typename T> T operator()(const T&, const T& y) const { return y - C; }
+};
+
+// Families of solution curves through seed points, integrated together by
+// hamzstlab_ensemble.h. Seeds come from a grid over the view or from clicks on the
+// plot; the curves are traced again only when the seeds or the plot limits change.
 void Demo_DirectionFields() {
-	// y' = 3 - 2t - 0.5y
-	static double xs[50], ys[50], xs2[50], ys2[50], xs3[50], ys3[50], xs4[50], ys4[50], xs5[50], ys5[50], xs6[50], ys6[50];
+	static int mode = 0;
+	static int grid = 20;
+	static int steps = 200;
+	static ImVector<double> click_t, click_y;
+	static std::vector<double> xs, ys;
+	static ImPlotRect last;
+	static bool dirty = true;
+	static double ms = 0;
+	static int curves = 0;
+	static bool events = false;
+	static float level = 1.0f;
+	static std::vector<double> event_t, event_y;
 
-	xs[0] = 0;
-	ys[0] = 0;
-	double m = 3 - 2*(xs[0]) - 0.5*(ys[0]);
-	for (int i = 1; i < 50; ++i) 
-	{
-		xs[i] = (i * 1/19.0f) ;
-		ys[i] = ys[i-1] + m*(xs[i] - xs[i-1]);
-		m = 3 - 2*xs[i] - 0.5*ys[i]; // y' = 3 - 2t - 0.5y
-	}
-	xs2[0] = 0;
-	ys2[0] = 0.82;
-	m = 3 - 2*(xs2[0]) - 0.5*(ys2[0]);
-	for (int i = 1; i < 50; ++i) 
-	{
-		xs2[i] = (i * 1/19.0f) ;
-		ys2[i] = ys2[i-1] + m*(xs2[i] - xs2[i-1]);
-		m = 3 - 2*xs2[i] - 0.5*ys2[i]; // y' = 3 - 2t - 0.5y
-	}
-	xs3[0] = 0;
-	ys3[0] = -0.82;
-	m = 3 - 2*(xs3[0]) - 0.5*(ys3[0]);
-	for (int i = 1; i < 50; ++i) 
-	{
-		xs3[i] = (i * 1/19.0f) ;
-		ys3[i] = ys3[i-1] + m*(xs3[i] - xs3[i-1]);
-		m = 3 - 2*xs3[i] - 0.5*ys3[i]; // y' = 3 - 2t - 0.5y
-	}
-	xs4[0] = 0;
-	ys4[0] = -1.42;
-	m = 3 - 2*(xs4[0]) - 0.5*(ys4[0]);
-	for (int i = 1; i < 50; ++i) 
-	{
-		xs4[i] = (i * 1/19.0f) ;
-		ys4[i] = ys4[i-1] + m*(xs4[i] - xs4[i-1]);
-		m = 3 - 2*xs4[i] - 0.5*ys4[i]; // y' = 3 - 2t - 0.5y
-	}
-	xs5[0] = 0;
-	ys5[0] = -1.8;
-	m = 3 - 2*(xs5[0]) - 0.5*(ys5[0]);
-	for (int i = 1; i < 50; ++i) 
-	{
-		xs5[i] = (i * 1/19.0f) ;
-		ys5[i] = ys5[i-1] + m*(xs5[i] - xs5[i-1]);
-		m = 3 - 2*xs5[i] - 0.5*ys5[i]; // y' = 3 - 2t - 0.5y
-	}
-	xs6[0] = 0;
-	ys6[0] = -2.1;
-	m = 3 - 2*(xs6[0]) - 0.5*(ys6[0]);
-	for (int i = 1; i < 50; ++i) 
-	{
-		xs6[i] = (i * 1/19.0f) ;
-		ys6[i] = ys6[i-1] + m*(xs6[i] - xs6[i-1]);
-		m = 3 - 2*xs6[i] - 0.5*ys6[i]; // y' = 3 - 2t - 0.5y
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::Combo("Seeds", &mode, "Grid over the view\0Click on the plot\0");
+	ImGui::SameLine();
+	if (mode == 0) {
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderInt("Grid", &grid, 2, 60);
+	}
+	else if (ImGui::Button("Clear")) {
+		click_t.resize(0);
+		click_y.resize(0);
+		dirty = true;
+	}
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderInt("RK4 steps per side", &steps, 20, 1000);
+	dirty |= ImGui::Checkbox("Mark where each curve first reaches y =", &events);
+	if (events) {
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(200);
+		dirty |= ImGui::SliderFloat("##Level", &level, -5.0f, 5.0f, "%.2f");
 	}
+	ImGui::Text("%d solution curves, %d points, traced in %.2f ms", curves, (int)xs.size(), ms);
+
 	if (ImPlot::BeginPlot("Direction Fields")) 
 	{
 	ImPlot::SetupAxes("x","y");
 	ImPlot::SetupAxesLimits(0,2,0,2.3);
-	//ImPlot::SetNextMarkerStyle(ImPlotMarker_Right, 4, ImPlot::GetColormapColor(2), IMPLOT_AUTO, ImPlot::GetColormapColor(2));
-	ImPlot::PlotLine("", xs, ys, 50,ImPlotLineFlags_Segments);
-	//ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(0.6f,0.6f,0.3f,0.8f));
-        
-	ImPlot::PlotLine("", xs2, ys2, 50,ImPlotLineFlags_Segments);
-	ImPlot::PlotLine("", xs3, ys3, 50,ImPlotLineFlags_Segments);
-	ImPlot::PlotLine("", xs4, ys4, 50,ImPlotLineFlags_Segments);
-	ImPlot::PlotLine("", xs5, ys5, 50,ImPlotLineFlags_Segments);
-	ImPlot::PlotLine("", xs6, ys6, 50,ImPlotLineFlags_Segments);
+	ImPlotRect lims = ImPlot::GetPlotLimits();
+	// a click that did not drag adds a seed
+	if (mode == 1 && ImPlot::IsPlotHovered() && ImGui::IsMouseReleased(ImGuiMouseButton_Left) && ImGui::GetIO().MouseDragMaxDistanceSqr[ImGuiMouseButton_Left] < 4.0f) {
+		ImPlotPoint p = ImPlot::GetPlotMousePos();
+		click_t.push_back(p.x);
+		click_y.push_back(p.y);
+		dirty = true;
+	}
+	if (dirty || lims.X.Min != last.X.Min || lims.X.Max != last.X.Max || lims.Y.Min != last.Y.Min || lims.Y.Max != last.Y.Max) {
+		ImVector<double> seed_t, seed_y;
+		if (mode == 0) {
+			for (int i = 0; i < grid; ++i)
+				for (int j = 0; j < grid; ++j) {
+					seed_t.push_back(lims.X.Min + (lims.X.Max - lims.X.Min) * (i + 0.5) / grid);
+					seed_y.push_back(lims.Y.Min + (lims.Y.Max - lims.Y.Min) * (j + 0.5) / grid);
+				}
+		}
+		else {
+			seed_t = click_t;
+			seed_y = click_y;
+		}
+		std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		// curves leaving the view by more than its height are cut off
+		double ylimit = fmax(fabs(lims.Y.Min), fabs(lims.Y.Max)) + (lims.Y.Max - lims.Y.Min);
+		Hamzstlab::TraceEnsemble(DirectionFieldSlope(), seed_t.Data, seed_y.Data, seed_t.Size, lims.X.Min, lims.X.Max, steps, xs, ys, ylimit);
+		event_t.resize(events ? seed_t.Size : 0);
+		event_y.resize(event_t.size());
+		if (events) {
+			// forward from every seed to the right edge of the view
+			std::vector<double> h(seed_t.Size);
+			for (int i = 0; i < seed_t.Size; ++i)
+				h[i] = (lims.X.Max - seed_t[i]) / steps;
+			LevelCrossing g = { level };
+			Hamzstlab::EnsembleFirstEvent(DirectionFieldSlope(), g, seed_t.Data, seed_y.Data, h.data(), seed_t.Size, steps, event_t.data(), event_y.data());
+		}
+		ms = 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		curves = seed_t.Size;
+		last = lims;
+		dirty = false;
+	}
+	ImPlot::SetNextLineStyle(IMPLOT_AUTO_COL, 1.0f);
+	ImPlot::PlotLine("Solutions of y' = 3 - 2t - 0.5y", xs.data(), ys.data(), (int)xs.size());
+	if (mode == 1) {
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 3);
+		ImPlot::PlotScatter("Seeds", click_t.Data, click_y.Data, click_t.Size);
+	}
+	if (events) {
+		ImPlot::PlotInfLines("##Level", &level, 1, ImPlotInfLinesFlags_Horizontal);
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Diamond, 4);
+		ImPlot::PlotScatter("First crossing", event_t.data(), event_y.data(), (int)event_t.size());
+	}
 	ImPlot::EndPlot();
 	}
 }
 
 //-----------------------------------------------------------------------------
-double f(double x, double y) {
-	return 3 - 2*x - 0.5*y ;// Example : y' = 3 - 2t - 0.5y
+// Define your differential equation once as a template so the field can
+// evaluate it four grid points at a time.
+template <typename T> T f(const T& x, const T& y) {
+	return 3.0 - 2.0*x - 0.5*y ;// Example : y' = 3 - 2t - 0.5y
 	//return -x / y; // Example: dy/dx = -x/y
 }
+struct FieldSlope {
+    template <typename T> T operator()(const T& x, const T& y) const { return f(x, y); }
+};
+
+// Slope segments sized to the plot: one every few pixels over the visible
+// limits, rebuilt by hamzstlab_directionfield.h only when the view changes.
 void Demo_DirectionFields2() {
-	// y' = 3 - 2t - 0.5y
-	// Define your differential equation
-
-	static double xs[500], ys[500];
-	int i = 1;
-	double x_min = -3.0, x_max = 3.0;
-	double y_min = -3.0, y_max = 3.0;
-	double step_size = 0.5;
-	double dx, dy, magnitude;
-	xs[0] = x_min;
-	ys[0] = y_min;
-	for (double y = y_min; y <= y_max; y += step_size) {
-	for (double x = x_min; x <= x_max; x += step_size) {
-		if (std::abs(y) > 0.001) { // Avoid division by zero for this example
-		double slope = f(x, y);
-		// Calculate components of a unit vector in the direction of the slope
-		dx = 1.0;
-		dy = slope;
-		magnitude = sqrt(dx * dx + dy * dy);
-		dx = dx / magnitude;
-		dy = dy / magnitude;
+	static Hamzstlab::DirectionField field;
+	static float spacing = 24, length = 16;
+	bool changed = false;
 
-		}
-		xs[i] = x;
-		ys[i] = y;
-		i = i+1;
-		xs[i] = x+dx;
-		ys[i] = y+dy;
-		i = i+1;
-        }
-	
-	}
+	ImGui::SetNextItemWidth(200);
+	changed |= ImGui::SliderFloat("Spacing (px)", &spacing, 8, 80, "%.0f");
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	changed |= ImGui::SliderFloat("Length (px)", &length, 4, 80, "%.0f");
+	field.Options.Spacing = spacing;
+	field.Options.Length = length;
+	ImGui::Text("%d segments", field.Points);
 
 	if (ImPlot::BeginPlot("Direction Fields 2")) 
 	{
 	ImPlot::SetupAxes("x","y");
 	ImPlot::SetupAxesLimits(-3,3,-3,3);
-	//ImPlot::SetNextMarkerStyle(ImPlotMarker_Right, 4, ImPlot::GetColormapColor(2), IMPLOT_AUTO, ImPlot::GetColormapColor(2));
-	ImPlot::PlotLine(" ", xs, ys, 500,ImPlotLineFlags_Segments);
-	//ImPlot::PushStyleColor(ImPlotCol_Line, ImVec4(0.6f,0.6f,0.3f,0.8f));
+	field.Update(FieldSlope(), changed);
+	field.Plot("y' = 3 - 2t - 0.5y");
 	ImPlot::EndPlot();
 	}
 }
@@ -453,15 +1034,32 @@ void Demo_DirectionFields2() {
 
 //-----------------------------------------------------------------------------
 
+// S(t) = S0 exp(rt) + (k/r)(exp(rt) - 1)
+struct CompoundInterest {
+    double S0, r, k;
+    double operator()(double t) const { return S0 * exp(r*t) + (k/r)*(exp(r*t) - 1); }
+};
+
+// dS/dt = rS + k, integrated until the balance first reaches the target.
+struct CompoundInterestRhs {
+    double r, k;
+    void operator()(double, const double* S, double* dSdt) const { dSdt[0] = r * S[0] + k; }
+};
+struct BalanceTarget {
+    double Target;
+    void operator()(double, const double* S, double* g) const { g[0] = S[0] - Target; }
+};
+
 void Demo_CompoundInterest() {
-	static float xs1[1001], ys1[1001];
+	static Hamzstlab::CurveSampler curve;
 	static int S0 = 0;
 	static float r = 0.08;
 	static int k = 2000;
-	for (int i = 0; i < 1001; ++i) {
-	xs1[i] = i;
-	ys1[i] = S0 * exp(r*i) + (k/r)*(exp(r*i) - 1) ;
-	}
+	static int target = 1000000;
+	static std::vector<Hamzstlab::OdeEvent> hit;
+	static Hamzstlab::OdeResult res;
+	static bool solved = false;
+	bool changed = false;
 
 	static bool range = false;
 	ImGui::Checkbox("Change parameters", &range);
@@ -470,41 +1068,79 @@ void Demo_CompoundInterest() {
 	ImGui::SameLine();
 	ImGui::SetNextItemWidth(200);
 	ImGui::BulletText("Initial Deposit");
-	ImGui::SliderInt("##Initial Deposit", &S0, 0, 10000);
+	changed |= ImGui::SliderInt("##Initial Deposit", &S0, 0, 10000);
 	ImGui::SetNextItemWidth(200);
 	ImGui::BulletText("Annual Deposit");
-	ImGui::SliderInt("##Annual Deposit", &k, 1, 10000);
+	changed |= ImGui::SliderInt("##Annual Deposit", &k, 1, 10000);
 	ImGui::SetNextItemWidth(200);
 	ImGui::BulletText("Return Rate");
-	ImGui::DragFloat("##Return rate", &r, 0.01f, 0.2f);
+	changed |= ImGui::DragFloat("##Return rate", &r, 0.01f, 0.2f);
+	ImGui::BulletText("Target");
 	ImGui::SetNextItemWidth(200);
+	changed |= ImGui::SliderInt("##Target", &target, 10000, 10000000, "%d", ImGuiSliderFlags_Logarithmic);
+	}
+	if (changed || !solved) {
+		// RK45 runs until the balance reaches the target; the crossing is found
+		// on the dense output, not by shortening steps
+		std::vector<Hamzstlab::OdeEventSpec> specs(1, Hamzstlab::OdeEventSpec(+1, true));
+		CompoundInterestRhs rhs = { (double)r, (double)k };
+		BalanceTarget g = { (double)target };
+		double s0 = S0;
+		hit.clear();
+		res = Hamzstlab::SolveOdeEvents(Hamzstlab::OdeMethod_RK45, rhs, g, specs, 0.0, &s0, 1, 200.0, Hamzstlab::OdeOptions(), hit);
+		solved = true;
 	}
+	if (hit.empty())
+		ImGui::Text("USD %d is not reached within 200 years", target);
+	else
+		ImGui::Text("USD %d is reached after %.2f years (%d RK45 steps%s)", target, hit[0].T, res.Steps, res.Stopped ? ", stopped at the event" : "");
 	if (ImPlot::BeginPlot("How Long to Make USD 1 million with Annual Deposit?")) {
 	ImPlot::SetupAxes("t","S(t)");
-	ImPlot::SetupAxesLimits(0, 60, 0, 1000000);
+	// the axes follow the target so the event marker stays in view
+	const double t_max = hit.empty() ? 60 : fmax(60.0, 1.2 * hit[0].T);
+	ImPlot::SetupAxesLimits(0, t_max, 0, 1.2 * target, changed ? ImPlotCond_Always : ImPlotCond_Once);
 	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
         
-	ImPlot::PlotLine("S(t) = S_{0} exp(rt) + (k/r) (exp(rt) - 1)", xs1, ys1, 1001);
+	CompoundInterest S = { (double)S0, (double)r, (double)k };
+	curve.Update(S, changed);
+	curve.Plot("S(t) = S_{0} exp(rt) + (k/r) (exp(rt) - 1)");
+	if (!hit.empty()) {
+		ImPlot::PlotInfLines("Target reached", &hit[0].T, 1);
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 5);
+		ImPlot::PlotScatter("Target reached", &hit[0].T, &hit[0].Y[0], 1);
+		ImPlot::Annotation(hit[0].T, hit[0].Y[0], ImPlot::GetLastItemColor(), ImVec2(10,-10), true, "t = %.2f", hit[0].T);
+	}
 	ImPlot::EndPlot();
     }
 }
 
 //-----------------------------------------------------------------------------
 
+// y(t) = (y0 K) / (y0 + (K - y0) exp(-rt))
+struct LogisticSolution {
+    double y0, K, r;
+    double operator()(double t) const { return (y0*K) / (y0 + (K - y0)*(exp(-r*t)) ); }
+};
+
+// y' = r y (1 - y/K) and the crossings of the threshold y = Level.
+struct LogisticRhs {
+    double r, K;
+    void operator()(double, const double* y, double* dydt) const { dydt[0] = r * y[0] * (1 - y[0] / K); }
+};
+struct PopulationThreshold {
+    double Level;
+    void operator()(double, const double* y, double* g) const { g[0] = y[0] - Level; }
+};
+
 void Demo_LogisticGrowth() {
-	static float xs1[1001], ys1[1001],ys2[1001],ys3[1001],ys4[1001],ys5[1001];
-	static int y01 = 1, y02 = 2, y03 = 3, y04 = 6, y05 = 7;
+	static Hamzstlab::CurveSampler curves[5];
+	static int y0s[5] = { 1, 2, 3, 6, 7 };
 	static float r = 0.8;
 	static int K = 5;
-	for (int i = 0; i < 1001; ++i) {
-	xs1[i] = i;
-	ys1[i] = (y01*K) / (y01 + (K - y01)*(exp(-r*i)) ) ;
-	ys2[i] = (y02*K) / (y02 + (K - y02)*(exp(-r*i)) ) ;
-	ys3[i] = (y03*K) / (y03 + (K - y03)*(exp(-r*i)) ) ;
-	ys4[i] = (y04*K) / (y04 + (K - y04)*(exp(-r*i)) ) ;
-	ys5[i] = (y05*K) / (y05 + (K - y05)*(exp(-r*i)) ) ;
-	
-	}
+	static float threshold = 4.0f;
+	static ImVector<double> event_t, event_y;
+	static bool solved = false;
+	bool changed = false;
 
 	static bool range = false;
 	ImGui::Checkbox("Change parameters", &range);
@@ -513,27 +1149,103 @@ void Demo_LogisticGrowth() {
 	ImGui::SameLine();
 	ImGui::SetNextItemWidth(200);
 	ImGui::BulletText("K");
-	ImGui::SliderInt("##K", &K, 1, 100);
+	changed |= ImGui::SliderInt("##K", &K, 1, 100);
 	ImGui::SetNextItemWidth(200);
 	ImGui::BulletText("Rate");
-	ImGui::DragFloat("##Rate", &r, 0.01f, 0.99f);
+	changed |= ImGui::DragFloat("##Rate", &r, 0.01f, 0.99f);
+	ImGui::SetNextItemWidth(200);
+	}
 	ImGui::SetNextItemWidth(200);
+	changed |= ImGui::SliderFloat("Threshold", &threshold, 0.0f, 10.0f, "%.2f");
+	if (changed || !solved) {
+		// every crossing of the threshold in either direction is recorded
+		std::vector<Hamzstlab::OdeEventSpec> specs(1, Hamzstlab::OdeEventSpec(0, false));
+		LogisticRhs rhs = { (double)r, (double)K };
+		PopulationThreshold g = { (double)threshold };
+		event_t.resize(0);
+		event_y.resize(0);
+		for (int i = 0; i < 5; ++i) {
+			std::vector<Hamzstlab::OdeEvent> events;
+			double y0 = y0s[i];
+			Hamzstlab::SolveOdeEvents(Hamzstlab::OdeMethod_RK45, rhs, g, specs, 0.0, &y0, 1, 10.0, Hamzstlab::OdeOptions(), events);
+			for (size_t e = 0; e < events.size(); ++e) {
+				event_t.push_back(events[e].T);
+				event_y.push_back(events[e].Y[0]);
+			}
+		}
+		solved = true;
 	}
 	if (ImPlot::BeginPlot("Logistic Growth")) {
 	ImPlot::SetupAxes("t","y(t)");
 	ImPlot::SetupAxesLimits(0, 10, 0, 10);
 	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
         
-	ImPlot::PlotLine("y(t) = ( y_{0} * K ) / ( y_{0} + (K - y_{0})exp(-rt) )", xs1, ys1, 1001);
-	ImPlot::PlotLine("y(t) = ( y_{0} * K ) / ( y_{0} + (K - y_{0})exp(-rt) )", xs1, ys2, 1001);
-	ImPlot::PlotLine("y(t) = ( y_{0} * K ) / ( y_{0} + (K - y_{0})exp(-rt) )", xs1, ys3, 1001);
-	ImPlot::PlotLine("y(t) = ( y_{0} * K ) / ( y_{0} + (K - y_{0})exp(-rt) )", xs1, ys4, 1001);
-	ImPlot::PlotLine("y(t) = ( y_{0} * K ) / ( y_{0} + (K - y_{0})exp(-rt) )", xs1, ys5, 1001);
+	for (int i = 0; i < 5; ++i) {
+		LogisticSolution y = { (double)y0s[i], (double)K, (double)r };
+		curves[i].Update(y, changed);
+		curves[i].Plot("y(t) = ( y_{0} * K ) / ( y_{0} + (K - y_{0})exp(-rt) )");
+	}
+	ImPlot::PlotInfLines("Threshold", &threshold, 1, ImPlotInfLinesFlags_Horizontal);
+	ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 5);
+	ImPlot::PlotScatter("Threshold", event_t.Data, event_y.Data, event_t.Size);
 	ImPlot::EndPlot();
     }
 }
 //-----------------------------------------------------------------------------
 
+// Bifurcation diagram of the discrete logistic map x <- r x (1 - x): one
+// column of the heatmap per pixel and value of r, rendered again for the
+// visible r and x range whenever the view changes, so zooming into the
+// period-doubling cascade keeps the full resolution.
+void Demo_LogisticMap() {
+	static Hamzstlab::BifurcationSpec s, last;
+	static ImVector<float> image;
+	static bool mt = true;
+	static bool dirty = true;
+	static double ms = 0;
+
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderInt("Transient", &s.Transient, 0, 10000, "%d", ImGuiSliderFlags_Logarithmic);
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	dirty |= ImGui::SliderInt("Iterations", &s.Iterations, 100, 10000, "%d", ImGuiSliderFlags_Logarithmic);
+	ImGui::SameLine();
+	dirty |= ImGui::Checkbox("Multithreaded", &mt);
+	ImGui::SameLine();
+	if (ImGui::Button("Home"))
+		ImPlot::SetNextAxesLimits(2.5, 4.0, 0, 1, ImGuiCond_Always);
+	ImGui::Text("Render: %.2f ms (%d x %d, %d threads)", ms, s.Width, s.Height, mt ? Hamzstlab::ThreadCount() : 1);
+
+	ImPlot::PushColormap(ImPlotColormap_Hot);
+	if (ImPlot::BeginPlot("##LogisticMap", ImVec2(-1, 600))) {
+		ImPlot::SetupAxes("r", "x");
+		ImPlot::SetupAxesLimits(2.5, 4.0, 0, 1);
+		ImPlotRect lims = ImPlot::GetPlotLimits();
+		ImVec2 size = ImPlot::GetPlotSize();
+		s.Width  = size.x > 1 ? (int)size.x : 1;
+		s.Height = size.y > 1 ? (int)size.y : 1;
+		s.RLim[0] = lims.X.Min;
+		s.RLim[1] = lims.X.Max;
+		s.XLim[0] = lims.Y.Max;
+		s.XLim[1] = lims.Y.Min;
+		if (image.Size != s.Width * s.Height) {
+			image.resize(s.Width * s.Height);
+			dirty = true;
+		}
+		if (dirty || s.RLim[0] != last.RLim[0] || s.RLim[1] != last.RLim[1] || s.XLim[0] != last.XLim[0] || s.XLim[1] != last.XLim[1]) {
+			std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+			Hamzstlab::RenderBifurcation(image.Data, s, mt ? 0 : 1);
+			ms = 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+			last = s;
+			dirty = false;
+		}
+		ImPlot::PlotHeatmap("##Density", image.Data, s.Height, s.Width, 0, 1, NULL, lims.Min(), lims.Max());
+		ImPlot::EndPlot();
+	}
+	ImPlot::PopColormap();
+}
+//-----------------------------------------------------------------------------
+
 
 void Demo_ScatterPlots() {
     srand(0);
@@ -753,9 +1465,14 @@ void ShowFirstOrderDEWindow(bool* p_open) {
         if (ImGui::BeginTabItem("Plots")) {
 	    DemoHeader("Compound Interest", Demo_CompoundInterest);
             DemoHeader("Logistic Growth", Demo_LogisticGrowth);
+            DemoHeader("Logistic Map Bifurcation", Demo_LogisticMap);
             DemoHeader("Direction Fields", Demo_DirectionFields);
             DemoHeader("Direction Fields 2", Demo_DirectionFields2);
-            DemoHeader("Euler Method's", Demo_LinePlots);
+            DemoHeader("Euler Method's and Runge-Kutta", Demo_LinePlots);
+            DemoHeader("Stiff Equations", Demo_StiffEquations);
+            DemoHeader("Lorenz Attractor", Demo_LorenzAttractor);
+            DemoHeader("Hamiltonian Systems", Demo_HamiltonianSystems);
+            DemoHeader("Stochastic Differential Equations", Demo_StochasticDE);
             ImGui::EndTabItem();
         }
         if (ImGui::BeginTabItem("Custom")) {
@@ -0,0 +1,222 @@
+// Hamzstlab Mathematics: Fourier series by real FFT
+//
+// FourierSeries samples f at M equispaced points of one period [A, B) and
+// gets all its coefficients
+//
+//   c_k = 1/(B - A) \int_A^B f(x) e^{-2 pi i k (x - A)/(B - A)} dx,   k = 0..Terms
+//
+// from one kiss_fftr of the samples: c_k = F_k / M is the trapezoid rule for
+// every c_k at once, O(M log M) in total where quadrature would spend O(M) on
+// each coefficient. M defaults to 8 samples per term, so the aliasing of the
+// higher harmonics onto c_k stays small.
+//
+// FourierPartialSum holds the partial sum
+//
+//   S_N(x) = c_0 + 2 Re sum_{k=1..N} c_k e^{2 pi i k (x - A)/(B - A)}
+//
+// on an equispaced grid of Points (a power of two, at least the plot width and
+// at least 2N + 2 so no harmonic aliases on the grid):
+//
+//   Hamzstlab::FourierSeries s;
+//   s.Build(Square(), -1, 1, 4096);
+//   Hamzstlab::FourierPartialSum p;
+//   p.SetTerms(s, 25, 800);                   // grid of at least 800 points
+//   ImPlot::PlotLine("S_25", p.Xs.data(), p.Ys.data(), p.Size());
+//   p.SetTerms(s, 26, 800);                   // adds the one new harmonic
+//
+// SetTerms moves N incrementally: a few terms are added to (or taken off) the
+// grid directly, at O(Points) each with a table of twiddles, and a large
+// change of N runs one inverse kiss_fftr of the truncated coefficients, at
+// O(Points log Points). Animating N one term per frame therefore costs a few
+// microseconds instead of a transform per frame.
+//
+// kiss_fft_scalar is float unless the kissfft sources and this header are both
+// compiled with -Dkiss_fft_scalar=double; the coefficients and the grid are
+// kept in double either way.
+
+#pragma once
+
+#include "kissfft/kiss_fftr.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Hamzstlab {
+
+namespace detail {
+
+// A kiss_fftr plan that is rebuilt only when its size or direction changes.
+class KissFftrPlan {
+public:
+    KissFftrPlan() : Cfg(NULL), N(0), Inverse(0) { }
+    ~KissFftrPlan() { if (Cfg) kiss_fftr_free(Cfg); }
+    kiss_fftr_cfg Get(int n, int inverse) {
+        if (Cfg == NULL || n != N || inverse != Inverse) {
+            if (Cfg) kiss_fftr_free(Cfg);
+            Cfg = kiss_fftr_alloc(n, inverse, NULL, NULL);
+            N = n; Inverse = inverse;
+        }
+        return Cfg;
+    }
+private:
+    KissFftrPlan(const KissFftrPlan&);
+    KissFftrPlan& operator=(const KissFftrPlan&);
+    kiss_fftr_cfg Cfg;
+    int N, Inverse;
+};
+
+inline int NextPow2(int n) {
+    int p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace detail
+
+class FourierSeries {
+public:
+    double A, B;
+    std::vector<double> Re, Im;     // c_k, k = 0..Terms()
+    int Samples;
+    int Version;                    // bumped by every Build
+
+    FourierSeries() : A(0), B(1), Samples(0), Version(0) { }
+
+    // Coefficients 0..terms of the periodic extension of f from [a, b), from
+    // `samples` points (even, at least 2 terms + 2; 0 picks 8 per term). At a
+    // jump of the extension, x = a, the sample is the mean of f(a) and f(b).
+    template <class F>
+    void Build(const F& f, double a, double b, int terms, int samples = 0) {
+        A = a; B = b;
+        if (samples <= 0) samples = detail::NextPow2(8 * (terms + 1));
+        Samples = std::max(samples + (samples & 1), 2 * terms + 2);
+        Time.resize(Samples);
+        Freq.resize(Samples / 2 + 1);
+        Time[0] = (kiss_fft_scalar)(0.5 * (f(a) + f(b)));
+        for (int j = 1; j < Samples; ++j)
+            Time[j] = (kiss_fft_scalar)f(a + (b - a) * j / Samples);
+        kiss_fftr(Plan.Get(Samples, 0), Time.data(), Freq.data());
+        Re.resize(terms + 1);
+        Im.resize(terms + 1);
+        for (int k = 0; k <= terms; ++k) {
+            Re[k] = (double)Freq[k].r / Samples;
+            Im[k] = (double)Freq[k].i / Samples;
+        }
+        ++Version;
+    }
+
+    int Terms() const { return (int)Re.size() - 1; }
+
+    // Amplitude of the k-th harmonic, |c_0| or 2 |c_k|.
+    double Amplitude(int k) const { return (k > 0 ? 2 : 1) * std::sqrt(Re[k] * Re[k] + Im[k] * Im[k]); }
+
+    // ||f - S_n||^2 / (B - A) by Parseval, over the terms that were kept.
+    double TailEnergy(int n) const {
+        double e = 0;
+        for (int k = Terms(); k > n; --k)
+            e += 2 * (Re[k] * Re[k] + Im[k] * Im[k]);
+        return e;
+    }
+
+private:
+    std::vector<kiss_fft_scalar> Time;
+    std::vector<kiss_fft_cpx> Freq;
+    detail::KissFftrPlan Plan;
+};
+
+class FourierPartialSum {
+public:
+    std::vector<double> Xs, Ys;     // Points + 1 values, the last repeats the first
+    int Points;
+    int N;
+    // how the last SetTerms got there: terms added or removed, or a full transform
+    int LastTerms;
+    bool LastTransform;
+
+    FourierPartialSum() : Points(0), N(-1), LastTerms(0), LastTransform(false), Series(NULL), Version(0), Log2Points(0) { }
+
+    int Size() const { return (int)Xs.size(); }
+
+    // Makes Ys the partial sum S_n of `s` on a grid of at least `min_points`.
+    void SetTerms(const FourierSeries& s, int n, int min_points = 0) {
+        n = std::max(0, std::min(n, s.Terms()));
+        const int points = std::max(detail::NextPow2(std::max(min_points, 2)), detail::NextPow2(2 * n + 2));
+        LastTerms = 0;
+        LastTransform = false;
+        if (&s != Series || s.Version != Version || points != Points) {
+            Series = &s; Version = s.Version;
+            Resize(s, points);
+            Transform(s, n);
+            return;
+        }
+        // a term costs Points multiply-adds; a transform measured like log2(Points) / 3 terms
+        const int d = std::abs(n - N);
+        if (d == 0)
+            return;
+        if (3 * d > Log2Points) {
+            Transform(s, n);
+            return;
+        }
+        for (int k = N + 1; k <= n; ++k) AddTerm(s, k, 2.0);
+        for (int k = N; k > n; --k)      AddTerm(s, k, -2.0);
+        Ys[Points] = Ys[0];
+        N = n;
+        LastTerms = d;
+    }
+
+private:
+    void Resize(const FourierSeries& s, int points) {
+        Points = points;
+        Log2Points = 0;
+        while ((1 << Log2Points) < points) ++Log2Points;
+        Xs.resize(points + 1);
+        Ys.resize(points + 1);
+        Cos.resize(points);
+        Sin.resize(points);
+        for (int j = 0; j <= points; ++j)
+            Xs[j] = s.A + (s.B - s.A) * j / points;
+        for (int j = 0; j < points; ++j) {
+            Cos[j] = std::cos(2 * 3.14159265358979323846 * j / points);
+            Sin[j] = std::sin(2 * 3.14159265358979323846 * j / points);
+        }
+    }
+
+    // S_n = c_0 + sum_{0<|k|<=n} c_k e^{2 pi i k j / Points}, the inverse real
+    // transform of c_0..c_n padded with zeros up to the Nyquist frequency.
+    void Transform(const FourierSeries& s, int n) {
+        Freq.assign(Points / 2 + 1, kiss_fft_cpx());
+        for (int k = 0; k <= n; ++k) {
+            Freq[k].r = (kiss_fft_scalar)s.Re[k];
+            Freq[k].i = (kiss_fft_scalar)s.Im[k];
+        }
+        Time.resize(Points);
+        kiss_fftri(Plan.Get(Points, 1), Freq.data(), Time.data());
+        for (int j = 0; j < Points; ++j)
+            Ys[j] = (double)Time[j];
+        Ys[Points] = Ys[0];
+        N = n;
+        LastTransform = true;
+    }
+
+    // Ys += scale Re(c_k e^{2 pi i k j / Points}); k j mod Points indexes the
+    // twiddle table since Points is a power of two.
+    void AddTerm(const FourierSeries& s, int k, double scale) {
+        const double re = scale * s.Re[k], im = scale * s.Im[k];
+        const unsigned mask = (unsigned)Points - 1;
+        unsigned idx = 0;
+        for (int j = 0; j < Points; ++j) {
+            Ys[j] += re * Cos[idx] - im * Sin[idx];
+            idx = (idx + (unsigned)k) & mask;
+        }
+    }
+
+    const FourierSeries* Series;
+    int Version;
+    int Log2Points;
+    std::vector<double> Cos, Sin;
+    std::vector<kiss_fft_scalar> Time;
+    std::vector<kiss_fft_cpx> Freq;
+    detail::KissFftrPlan Plan;
+};
+
+} // namespace Hamzstlab
@@ -0,0 +1,278 @@
+// Hamzstlab Mathematics: cubic splines and barycentric Lagrange interpolation
+//
+// CubicSpline interpolates (x_i, y_i), x increasing, with a C2 piecewise cubic
+// whose end conditions are natural (y'' = 0), clamped (given y') or
+// not-a-knot (y''' continuous at x_1 and x_{n-2}). The slopes at the knots
+// solve a tridiagonal system, which the Thomas algorithm does in O(n):
+//
+//   Hamzstlab::CubicSpline s;
+//   s.Build(xs, ys, n, Hamzstlab::SplineBoundary_NotAKnot);
+//   double y = s(0.5);                        // one point, binary search
+//   s.Evaluate(queries, values, m);           // sorted queries, one forward walk
+//
+// Evaluate is the fast path for resampling: it finds the interval of every
+// query by walking forward from the interval of the previous one. Long jumps,
+// as when a few thousand screen columns sample a million knots, start at the
+// interval the mean knot spacing predicts and gallop from there, so they cost
+// O(1) probes on evenly spread knots and O(log(n/m)) at worst. The cubics are
+// then evaluated four queries at a time on Vec4d lanes.
+//
+// BarycentricLagrange is the polynomial through all the points in the
+// barycentric form of Berrut and Trefethen (2004): O(n) per evaluation after
+// the weights are known, and numerically stable. On the n Chebyshev points of
+// the second kind the weights are known in closed form, and the interpolant
+// converges for every smooth f where equispaced points suffer from Runge's
+// phenomenon.
+
+#pragma once
+
+#include "hamzstlab_simd.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Hamzstlab {
+
+enum SplineBoundary {
+    SplineBoundary_Natural,
+    SplineBoundary_Clamped,
+    SplineBoundary_NotAKnot,
+    SplineBoundary_COUNT
+};
+
+inline const char* SplineBoundaryName(int boundary) {
+    static const char* names[] = { "Natural", "Clamped", "Not-a-knot" };
+    return boundary >= 0 && boundary < SplineBoundary_COUNT ? names[boundary] : "";
+}
+
+namespace detail {
+
+// Solves the tridiagonal system sub[i] x[i-1] + diag[i] x[i] + sup[i] x[i+1] = rhs[i]
+// in place (Thomas algorithm): rhs becomes x, diag and sup are overwritten.
+// No pivoting; the spline systems are diagonally dominant except for the
+// not-a-knot end rows, which the elimination handles like any other.
+inline void SolveTridiagonal(const double* sub, double* diag, double* sup, double* rhs, int n) {
+    for (int i = 1; i < n; ++i) {
+        const double m = sub[i] / diag[i - 1];
+        diag[i] -= m * sup[i - 1];
+        rhs[i] -= m * rhs[i - 1];
+    }
+    rhs[n - 1] /= diag[n - 1];
+    for (int i = n - 2; i >= 0; --i)
+        rhs[i] = (rhs[i] - sup[i] * rhs[i + 1]) / diag[i];
+}
+
+} // namespace detail
+
+class CubicSpline {
+public:
+    // On [X[i], X[i+1]] the spline is a + t (b + t (c + t d)) with t = x - X[i] and
+    // (a, b, c, d) = Coef[4i .. 4i+3], interleaved so that one query touches one cache line.
+    std::vector<double> X, Coef;
+
+    int Size() const { return (int)X.size(); }
+
+    // dy0 and dyn are the end slopes for SplineBoundary_Clamped. Returns false
+    // when there are fewer than two points or x is not strictly increasing.
+    bool Build(const double* x, const double* y, int n, int boundary = SplineBoundary_Natural, double dy0 = 0, double dyn = 0) {
+        X.clear(); Coef.clear();
+        if (n < 2)
+            return false;
+        for (int i = 1; i < n; ++i)
+            if (!(x[i] > x[i - 1]))
+                return false;
+        std::vector<double> h(n - 1), delta(n - 1), sub(n), diag(n), sup(n), s(n);
+        for (int i = 0; i < n - 1; ++i) {
+            h[i] = x[i + 1] - x[i];
+            delta[i] = (y[i + 1] - y[i]) / h[i];
+        }
+        // interior rows: continuity of y'' at x_i
+        for (int i = 1; i < n - 1; ++i) {
+            sub[i]  = h[i];
+            diag[i] = 2 * (h[i - 1] + h[i]);
+            sup[i]  = h[i - 1];
+            s[i]    = 3 * (h[i] * delta[i - 1] + h[i - 1] * delta[i]);
+        }
+        if (boundary == SplineBoundary_Clamped) {
+            diag[0] = 1; sup[0] = 0; s[0] = dy0;
+            sub[n - 1] = 0; diag[n - 1] = 1; s[n - 1] = dyn;
+        }
+        else if (boundary == SplineBoundary_NotAKnot && n >= 4) {
+            diag[0] = h[1];
+            sup[0]  = h[0] + h[1];
+            s[0]    = ((h[0] + 2 * (h[0] + h[1])) * h[1] * delta[0] + h[0] * h[0] * delta[1]) / (h[0] + h[1]);
+            sub[n - 1]  = h[n - 2] + h[n - 3];
+            diag[n - 1] = h[n - 3];
+            s[n - 1]    = (h[n - 2] * h[n - 2] * delta[n - 3] + (2 * (h[n - 3] + h[n - 2]) + h[n - 2]) * h[n - 3] * delta[n - 2]) / (h[n - 3] + h[n - 2]);
+        }
+        else if (boundary == SplineBoundary_NotAKnot) {
+            // three points: the parabola through them; two points: the line
+            diag[0] = 1; sup[0] = 1; s[0] = 2 * delta[0];
+            sub[n - 1] = 1; diag[n - 1] = 1; s[n - 1] = 2 * delta[n - 2];
+            if (n == 2) { sup[0] = 0; s[0] = delta[0]; sub[1] = 0; s[1] = delta[0]; }
+        }
+        else {
+            diag[0] = 2; sup[0] = 1; s[0] = 3 * delta[0];
+            sub[n - 1] = 1; diag[n - 1] = 2; s[n - 1] = 3 * delta[n - 2];
+        }
+        detail::SolveTridiagonal(sub.data(), diag.data(), sup.data(), s.data(), n);
+        X.assign(x, x + n);
+        Coef.resize((size_t)4 * (n - 1));
+        for (int i = 0; i < n - 1; ++i) {
+            double* p = &Coef[(size_t)4 * i];
+            p[0] = y[i];
+            p[1] = s[i];
+            p[2] = (3 * delta[i] - 2 * s[i] - s[i + 1]) / h[i];
+            p[3] = (s[i] + s[i + 1] - 2 * delta[i]) / (h[i] * h[i]);
+        }
+        return true;
+    }
+
+    // Interval of x: the last i with X[i] <= x, clamped to [0, n-2] so that
+    // points outside the knots extrapolate the end cubics.
+    int Interval(double x) const {
+        const int last = (int)X.size() - 2;
+        int i = (int)(std::upper_bound(X.begin(), X.end(), x) - X.begin()) - 1;
+        return i < 0 ? 0 : (i > last ? last : i);
+    }
+
+    double operator()(double x) const {
+        const int i = Interval(x);
+        const double t = x - X[i], *p = &Coef[(size_t)4 * i];
+        return p[0] + t * (p[1] + t * (p[2] + t * p[3]));
+    }
+
+    // yq[k] = s(xq[k]) for m queries sorted in increasing order.
+    void Evaluate(const double* xq, double* yq, int m) const {
+        if (X.size() < 2 || m <= 0)
+            return;
+        const int last = (int)X.size() - 2;
+        int i = Interval(xq[0]);
+        const double per_x = (last + 1) / (X[last + 1] - X[0]);   // intervals per unit of x
+        double t[64], a[64], b[64], c[64], d[64];
+        for (int k0 = 0; k0 < m; k0 += 64) {
+            const int block = std::min(64, m - k0);
+            // intervals by a forward walk. A long jump first probes the interval the
+            // mean knot spacing predicts, then gallops and bisects from there.
+            for (int k = 0; k < block; ++k) {
+                const double x = xq[k0 + k];
+                if (i < last && x >= X[i + 1]) {
+                    int lo = i + 1, bound = last + 1, step = 1;   // X[lo] <= x, and x < X[bound] unless bound == last + 1
+                    const double ahead = (x - X[lo]) * per_x;
+                    const int guess = ahead < last - lo ? lo + (int)ahead : last;
+                    if (guess > lo) {
+                        if (x >= X[guess]) lo = guess;
+                        else bound = guess;
+                    }
+                    while (lo + step < bound && x >= X[lo + step]) { lo += step; step *= 2; }
+                    int hi = std::min(lo + step, bound);
+                    while (hi - lo > 1) {
+                        const int mid = (lo + hi) / 2;
+                        if (x >= X[mid]) lo = mid; else hi = mid;
+                    }
+                    i = lo;
+                }
+                const double* p = &Coef[(size_t)4 * i];
+                t[k] = x - X[i];
+                a[k] = p[0]; b[k] = p[1]; c[k] = p[2]; d[k] = p[3];
+            }
+            int k = 0;
+            for (; k + 4 <= block; k += 4) {
+                const Vec4d tv = Vec4d::Load(t + k);
+                (Vec4d::Load(a + k) + tv * (Vec4d::Load(b + k) + tv * (Vec4d::Load(c + k) + tv * Vec4d::Load(d + k))))
+                    .Store(yq + k0 + k);
+            }
+            for (; k < block; ++k)
+                yq[k0 + k] = a[k] + t[k] * (b[k] + t[k] * (c[k] + t[k] * d[k]));
+        }
+    }
+};
+
+class BarycentricLagrange {
+public:
+    std::vector<double> X, Y, W;   // nodes, values, barycentric weights
+
+    int Size() const { return (int)X.size(); }
+
+    // Arbitrary distinct nodes; the weights cost O(n^2). They are scaled by
+    // the capacity 4 / (max x - min x) to stay clear of overflow.
+    void Build(const double* x, const double* y, int n) {
+        X.assign(x, x + n);
+        Y.assign(y, y + n);
+        W.assign(n, 1.0);
+        if (n < 2)
+            return;
+        const double cap = 4 / (*std::max_element(x, x + n) - *std::min_element(x, x + n));
+        for (int j = 0; j < n; ++j) {
+            double w = 1;
+            for (int k = 0; k < n; ++k)
+                if (k != j) w *= cap * (x[j] - x[k]);
+            W[j] = 1 / w;
+        }
+    }
+
+    // n >= 2 Chebyshev points of the second kind on [a,b], x_j = mid - half cos(j pi / (n-1)),
+    // with weights (-1)^j, halved at both ends.
+    template <class F>
+    void Chebyshev(const F& f, double a, double b, int n) {
+        X.resize(n); Y.resize(n); W.resize(n);
+        const double mid = 0.5 * (a + b), half = 0.5 * (b - a);
+        for (int j = 0; j < n; ++j) {
+            X[j] = mid - half * std::cos(3.14159265358979323846 * j / (n - 1));
+            Y[j] = f(X[j]);
+            W[j] = (j % 2 ? -1.0 : 1.0) * (j == 0 || j == n - 1 ? 0.5 : 1.0);
+        }
+        X[0] = a;
+        X[n - 1] = b;
+    }
+
+    // Equispaced nodes on [a,b], for comparison: weights (-1)^j C(n-1, j).
+    template <class F>
+    void Equispaced(const F& f, double a, double b, int n) {
+        X.resize(n); Y.resize(n); W.resize(n);
+        double binom = 1;
+        for (int j = 0; j < n; ++j) {
+            X[j] = n > 1 ? a + (b - a) * j / (n - 1) : a;
+            Y[j] = f(X[j]);
+            W[j] = (j % 2 ? -binom : binom);
+            binom = binom * (n - 1 - j) / (j + 1);
+        }
+    }
+
+    double operator()(double x) const {
+        double num = 0, den = 0;
+        for (size_t j = 0; j < X.size(); ++j) {
+            const double diff = x - X[j];
+            if (diff == 0)
+                return Y[j];
+            const double c = W[j] / diff;
+            num += c * Y[j];
+            den += c;
+        }
+        return num / den;
+    }
+
+    // Four queries per pass over the nodes; a query that hits a node exactly
+    // (0/0 in the vector sum) is redone with the scalar formula.
+    void Evaluate(const double* xq, double* yq, int m) const {
+        const int n = (int)X.size();
+        int k = 0;
+        for (; k + 4 <= m; k += 4) {
+            const Vec4d x = Vec4d::Load(xq + k);
+            Vec4d num(0.0), den(0.0);
+            for (int j = 0; j < n; ++j) {
+                const Vec4d c = W[j] / (x - X[j]);
+                num = num + c * Y[j];
+                den = den + c;
+            }
+            (num / den).Store(yq + k);
+            for (int l = 0; l < 4; ++l)
+                if (!std::isfinite(yq[k + l]))
+                    yq[k + l] = (*this)(xq[k + l]);
+        }
+        for (; k < m; ++k)
+            yq[k] = (*this)(xq[k]);
+    }
+};
+
+} // namespace Hamzstlab
@@ -0,0 +1,287 @@
+// Hamzstlab Mathematics: interval arithmetic and verified root isolation
+//
+// Interval is a closed interval [Lo, Hi] whose operations round outward (every
+// computed bound is moved one ulp away with nextafter), so f evaluated on an
+// Interval encloses the true range of f over it. Functions are written once as
+// templates, as for hamzstlab_autodiff.h, and Dual<Interval> gives an enclosure
+// of f' over a whole interval:
+//
+//   struct G { template <typename T> T operator()(const T& x) const { using std::cos; return cos(x) - x; } };
+//   Hamzstlab::IntervalRootResult r = Hamzstlab::IsolateRoots(G(), 0.0, 5.0);
+//
+// IsolateRoots runs interval Newton with bisection. A box is pruned when f(X)
+// excludes zero or when the Newton image N(X) = m - f(m)/f'(X) misses X. When
+// N(X) lies inside X and f'(X) excludes zero, X contains exactly one root
+// (Unique). Every root of f in [a,b] lies in one of the returned enclosures.
+// When MaxBoxes runs out first, the boxes still waiting are returned as
+// Possible enclosures and Complete is false, so the union still covers every
+// root but some enclosures are wide.
+
+#pragma once
+
+#include "hamzstlab_autodiff.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Hamzstlab {
+
+struct Interval {
+    double Lo, Hi;
+    Interval() : Lo(0), Hi(0) { }
+    Interval(double v) : Lo(v), Hi(v) { }
+    Interval(double lo, double hi) : Lo(lo), Hi(hi) { }
+    double Mid() const    { return Lo + (Hi - Lo) / 2; }
+    double Width() const  { return Hi - Lo; }
+    bool Contains(double v) const { return Lo <= v && v <= Hi; }
+    bool Empty() const    { return !(Lo <= Hi); }
+    Interval& operator+=(const Interval& o);
+    Interval& operator-=(const Interval& o);
+    Interval& operator*=(const Interval& o);
+    Interval& operator/=(const Interval& o);
+};
+
+namespace detail {
+inline double RoundDown(double v) { return std::nextafter(v, -std::numeric_limits<double>::infinity()); }
+inline double RoundUp(double v)   { return std::nextafter(v,  std::numeric_limits<double>::infinity()); }
+inline Interval Outward(double lo, double hi) { return Interval(RoundDown(lo), RoundUp(hi)); }
+inline double Min4(double a, double b, double c, double d) { return std::fmin(std::fmin(a, b), std::fmin(c, d)); }
+inline double Max4(double a, double b, double c, double d) { return std::fmax(std::fmax(a, b), std::fmax(c, d)); }
+} // namespace detail
+
+inline Interval operator+(const Interval& a) { return a; }
+inline Interval operator-(const Interval& a) { return Interval(-a.Hi, -a.Lo); }
+inline Interval operator+(const Interval& a, const Interval& b) { return detail::Outward(a.Lo + b.Lo, a.Hi + b.Hi); }
+inline Interval operator-(const Interval& a, const Interval& b) { return detail::Outward(a.Lo - b.Hi, a.Hi - b.Lo); }
+inline Interval operator*(const Interval& a, const Interval& b) {
+    double p1 = a.Lo * b.Lo, p2 = a.Lo * b.Hi, p3 = a.Hi * b.Lo, p4 = a.Hi * b.Hi;
+    return detail::Outward(detail::Min4(p1, p2, p3, p4), detail::Max4(p1, p2, p3, p4));
+}
+// Division by an interval containing zero gives the whole real line; see ExtendedDivide.
+inline Interval operator/(const Interval& a, const Interval& b) {
+    if (b.Contains(0.0))
+        return Interval(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+    double q1 = a.Lo / b.Lo, q2 = a.Lo / b.Hi, q3 = a.Hi / b.Lo, q4 = a.Hi / b.Hi;
+    return detail::Outward(detail::Min4(q1, q2, q3, q4), detail::Max4(q1, q2, q3, q4));
+}
+inline Interval operator+(const Interval& a, double b) { return a + Interval(b); }
+inline Interval operator+(double a, const Interval& b) { return Interval(a) + b; }
+inline Interval operator-(const Interval& a, double b) { return a - Interval(b); }
+inline Interval operator-(double a, const Interval& b) { return Interval(a) - b; }
+inline Interval operator*(const Interval& a, double b) { return a * Interval(b); }
+inline Interval operator*(double a, const Interval& b) { return Interval(a) * b; }
+inline Interval operator/(const Interval& a, double b) { return a / Interval(b); }
+inline Interval operator/(double a, const Interval& b) { return Interval(a) / b; }
+inline Interval& Interval::operator+=(const Interval& o) { return *this = *this + o; }
+inline Interval& Interval::operator-=(const Interval& o) { return *this = *this - o; }
+inline Interval& Interval::operator*=(const Interval& o) { return *this = *this * o; }
+inline Interval& Interval::operator/=(const Interval& o) { return *this = *this / o; }
+// Certainly-less comparisons, used only to pick a branch in fabs.
+inline bool operator<(const Interval& a, const Interval& b) { return a.Hi < b.Lo; }
+inline bool operator>(const Interval& a, const Interval& b) { return a.Lo > b.Hi; }
+
+inline Interval Intersect(const Interval& a, const Interval& b) { return Interval(std::fmax(a.Lo, b.Lo), std::fmin(a.Hi, b.Hi)); }
+
+// Library functions are accurate to a few ulps, so their bounds are widened by two.
+inline Interval exp(const Interval& x)  { return detail::Outward(detail::RoundDown(std::exp(x.Lo)), detail::RoundUp(std::exp(x.Hi))); }
+inline Interval log(const Interval& x)  { return detail::Outward(detail::RoundDown(std::log(x.Lo)), detail::RoundUp(std::log(x.Hi))); }
+inline Interval sqrt(const Interval& x) { return detail::Outward(std::sqrt(std::fmax(x.Lo, 0.0)), std::sqrt(x.Hi)); }
+inline Interval atan(const Interval& x) { return detail::Outward(detail::RoundDown(std::atan(x.Lo)), detail::RoundUp(std::atan(x.Hi))); }
+inline Interval sinh(const Interval& x) { return detail::Outward(detail::RoundDown(std::sinh(x.Lo)), detail::RoundUp(std::sinh(x.Hi))); }
+inline Interval tanh(const Interval& x) { return detail::Outward(detail::RoundDown(std::tanh(x.Lo)), detail::RoundUp(std::tanh(x.Hi))); }
+inline Interval cosh(const Interval& x) {
+    double lo = x.Contains(0.0) ? 1.0 : std::cosh(std::fmin(std::fabs(x.Lo), std::fabs(x.Hi)));
+    return detail::Outward(detail::RoundDown(lo), detail::RoundUp(std::cosh(std::fmax(std::fabs(x.Lo), std::fabs(x.Hi)))));
+}
+inline Interval cos(const Interval& x) {
+    const double pi = 3.141592653589793;
+    if (!(x.Width() < 2 * pi))
+        return Interval(-1, 1);
+    double c1 = std::cos(x.Lo), c2 = std::cos(x.Hi);
+    double lo = std::fmin(c1, c2), hi = std::fmax(c1, c2);
+    // extrema at even (max) and odd (min) multiples of pi inside x; the bracket
+    // k is enlarged by one on both sides to stay safe against rounding of x/pi
+    long k0 = (long)std::floor(x.Lo / pi) - 1, k1 = (long)std::ceil(x.Hi / pi) + 1;
+    for (long k = k0; k <= k1; ++k) {
+        double e = k * pi;
+        if (e > x.Lo && e < x.Hi) {
+            if (k % 2 == 0) hi = 1;
+            else            lo = -1;
+        }
+    }
+    Interval r = detail::Outward(detail::RoundDown(lo), detail::RoundUp(hi));
+    return Intersect(r, Interval(-1, 1));
+}
+inline Interval sin(const Interval& x) { return cos(x - Interval(1.5707963267948966, 1.5707963267948968)); }
+inline Interval tan(const Interval& x) { return sin(x) / cos(x); }
+inline Interval fabs(const Interval& x) {
+    if (x.Lo >= 0) return x;
+    if (x.Hi <= 0) return -x;
+    return Interval(0, std::fmax(-x.Lo, x.Hi));
+}
+inline Interval abs(const Interval& x) { return fabs(x); }
+// Integer powers are exact ranges (even powers of intervals around zero start at 0).
+inline Interval pow(const Interval& x, int n) {
+    if (n == 0) return Interval(1);
+    if (n < 0)  return Interval(1) / pow(x, -n);
+    Interval r = (n % 2 == 0) ? fabs(x) : x;
+    return detail::Outward(detail::RoundDown(std::pow(r.Lo, n)), detail::RoundUp(std::pow(r.Hi, n)));
+}
+inline Interval pow(const Interval& x, const Interval& p) {
+    if (p.Lo == p.Hi && p.Lo == std::floor(p.Lo) && std::fabs(p.Lo) < 1024)
+        return pow(x, (int)p.Lo);
+    return exp(p * log(x));
+}
+inline Interval pow(const Interval& x, double p) { return pow(x, Interval(p)); }
+
+// a / b when b contains zero: up to two disjoint pieces (Kahan extended division).
+// Returns the number of pieces written to out.
+inline int ExtendedDivide(const Interval& a, const Interval& b, Interval out[2]) {
+    const double inf = std::numeric_limits<double>::infinity();
+    if (!b.Contains(0.0)) { out[0] = a / b; return 1; }
+    if (a.Contains(0.0) || (b.Lo == 0 && b.Hi == 0)) { out[0] = Interval(-inf, inf); return a.Contains(0.0) ? 1 : 0; }
+    int n = 0;
+    if (a.Lo > 0) {
+        if (b.Lo < 0) out[n++] = Interval(-inf, detail::RoundUp(a.Lo / b.Lo));
+        if (b.Hi > 0) out[n++] = Interval(detail::RoundDown(a.Lo / b.Hi), inf);
+    }
+    else {
+        if (b.Hi > 0) out[n++] = Interval(-inf, detail::RoundUp(a.Hi / b.Hi));
+        if (b.Lo < 0) out[n++] = Interval(detail::RoundDown(a.Hi / b.Lo), inf);
+    }
+    return n;
+}
+
+//-----------------------------------------------------------------------------
+// Interval Newton root isolation
+//-----------------------------------------------------------------------------
+
+struct IntervalRootOptions {
+    double XTol;      // stop refining a box narrower than this
+    int    MaxBoxes;  // safety limit on processed boxes; unprocessed boxes are returned as Possible
+    IntervalRootOptions() { XTol = 1e-10; MaxBoxes = 100000; }
+};
+
+struct IntervalRootBox {
+    double Lo, Hi;     // x range
+    double FLo, FHi;   // enclosure of f over [Lo,Hi]
+    int    Status;     // IntervalBox_*
+};
+
+enum IntervalBoxStatus {
+    IntervalBox_Pruned,     // f(X) or N(X) excludes every root
+    IntervalBox_Split,      // bisected or narrowed further
+    IntervalBox_Unique,     // verified to contain exactly one root
+    IntervalBox_Possible    // below XTol without proof of existence, or left over at MaxBoxes
+};
+
+struct IntervalRootResult {
+    std::vector<IntervalRootBox> Roots;   // final enclosures, sorted by Lo
+    std::vector<IntervalRootBox> Boxes;   // every processed box, for plotting
+    int    Processed;
+    int    Pruned;
+    int    Evaluations;                   // interval evaluations of f and f'
+    double Seconds;
+    bool   Complete;                      // false when MaxBoxes stopped the search
+    IntervalRootResult() { Processed = Pruned = Evaluations = 0; Seconds = 0; Complete = true; }
+};
+
+template <class F>
+IntervalRootResult IsolateRoots(const F& f, double a, double b, const IntervalRootOptions& opt = IntervalRootOptions(), bool record_boxes = true) {
+    IntervalRootResult res;
+    detail::RootClock::time_point t0 = detail::RootClock::now();
+    std::vector<Interval> stack;
+    stack.push_back(Interval(a, b));
+    while (!stack.empty() && res.Processed < opt.MaxBoxes) {
+        Interval X = stack.back();
+        stack.pop_back();
+        ++res.Processed;
+        Dual<Interval> d = f(Dual<Interval>(X, Interval(1.0)));
+        ++res.Evaluations;
+        IntervalRootBox box = { X.Lo, X.Hi, d.Val.Lo, d.Val.Hi, IntervalBox_Split };
+        if (!d.Val.Contains(0.0)) {
+            box.Status = IntervalBox_Pruned;
+            ++res.Pruned;
+            if (record_boxes) res.Boxes.push_back(box);
+            continue;
+        }
+        // Newton image N(X) = m - f(m) / f'(X), intersected with X
+        double m = X.Mid();
+        Interval fm = f(Interval(m));
+        ++res.Evaluations;
+        Interval q[2];
+        int pieces = ExtendedDivide(fm, d.Der, q);
+        Interval next[2];
+        int count = 0;
+        bool unique = false;
+        for (int i = 0; i < pieces; ++i) {
+            Interval N = Interval(m) - q[i];
+            Interval Y = Intersect(N, X);
+            if (Y.Empty())
+                continue;
+            if (pieces == 1 && !d.Der.Contains(0.0) && N.Lo > X.Lo && N.Hi < X.Hi)
+                unique = true;
+            next[count++] = Y;
+        }
+        if (count == 0) {
+            box.Status = IntervalBox_Pruned;
+            ++res.Pruned;
+            if (record_boxes) res.Boxes.push_back(box);
+            continue;
+        }
+        bool narrow = true;
+        for (int i = 0; i < count; ++i)
+            narrow = narrow && next[i].Width() <= opt.XTol;
+        if (narrow || X.Width() <= opt.XTol) {
+            // keep the enclosure, merged with a neighbour that touches it
+            box.Status = unique ? IntervalBox_Unique : IntervalBox_Possible;
+            if (unique || count == 1) { box.Lo = next[0].Lo; box.Hi = next[count - 1].Hi; }
+            res.Roots.push_back(box);
+            if (record_boxes) res.Boxes.push_back(box);
+            continue;
+        }
+        if (record_boxes) res.Boxes.push_back(box);
+        if (count == 1 && next[0].Width() < 0.75 * X.Width()) {
+            // Newton contracted X enough; keep iterating on the smaller box
+            stack.push_back(next[0]);
+            continue;
+        }
+        for (int i = 0; i < count; ++i) {
+            const Interval& Y = next[i];
+            double c = Y.Mid();
+            // push the right half first so boxes come off the stack left to right
+            stack.push_back(Interval(c, Y.Hi));
+            stack.push_back(Interval(Y.Lo, c));
+        }
+    }
+    // out of boxes: whatever was not examined may still hold roots
+    res.Complete = stack.empty();
+    for (size_t i = 0; i < stack.size(); ++i) {
+        Interval fx = f(stack[i]);
+        ++res.Evaluations;
+        if (!fx.Contains(0.0))
+            continue;
+        IntervalRootBox box = { stack[i].Lo, stack[i].Hi, fx.Lo, fx.Hi, IntervalBox_Possible };
+        res.Roots.push_back(box);
+    }
+    // sort and merge enclosures that share an endpoint (a root on a split point)
+    std::vector<IntervalRootBox> roots;
+    std::sort(res.Roots.begin(), res.Roots.end(), [](const IntervalRootBox& l, const IntervalRootBox& r) { return l.Lo < r.Lo; });
+    for (size_t i = 0; i < res.Roots.size(); ++i) {
+        if (!roots.empty() && res.Roots[i].Lo <= roots.back().Hi) {
+            IntervalRootBox& p = roots.back();
+            p.Hi  = std::fmax(p.Hi, res.Roots[i].Hi);
+            p.FLo = std::fmin(p.FLo, res.Roots[i].FLo);
+            p.FHi = std::fmax(p.FHi, res.Roots[i].FHi);
+            p.Status = IntervalBox_Possible;
+            continue;
+        }
+        roots.push_back(res.Roots[i]);
+    }
+    res.Roots.swap(roots);
+    res.Seconds = std::chrono::duration<double>(detail::RootClock::now() - t0).count();
+    return res;
+}
+
+} // namespace Hamzstlab
@@ -0,0 +1,287 @@
+// Hamzstlab Mathematics: background jobs with progressive results
+//
+// Long computations run on a JobRunner's own worker thread instead of inside
+// the ImGui frame. Submitting a job cancels the previous one: every submission
+// bumps a generation counter, and a running job polls JobToken::Cancelled()
+// and returns as soon as it is stale. Results travel back in chunks through a
+// SpscQueue, a fixed-size lock-free ring buffer with one producer (the worker)
+// and one consumer (the UI thread), so neither side ever waits on a lock.
+//
+// ProgressiveOde wraps this for the integrators of hamzstlab_ode.h:
+//
+//   static Hamzstlab::ProgressiveOde solve;
+//   if (params_changed) solve.Start(Hamzstlab::OdeMethod_RK45, Rhs(p), 0.0, y0, 3, 1000.0, opt);
+//   solve.Poll();                      // once per frame: appends the new chunks
+//   ImPlot::PlotLine("x", solve.Result.Ts.data(), ..., solve.Result.Size());
+//
+// With opt.Dense the dense output streams along with the steps. While a solve
+// is running Result holds the interpolant of one step past its last point, so
+// HasDense() turns true once the solve is Done.
+//
+// Link with -pthread.
+
+#pragma once
+
+#include "hamzstlab_ode.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Hamzstlab {
+
+// Single-producer single-consumer ring buffer holding up to Capacity - 1 items.
+template <class T, int Capacity = 64>
+class SpscQueue {
+public:
+    SpscQueue() : Head(0), Tail(0) { }
+
+    // Producer side. Returns false when the queue is full.
+    bool Push(T& item) {
+        const unsigned tail = Tail.load(std::memory_order_relaxed);
+        const unsigned next = (tail + 1) % Capacity;
+        if (next == Head.load(std::memory_order_acquire))
+            return false;
+        std::swap(Slots[tail], item);
+        Tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false when the queue is empty.
+    bool Pop(T& item) {
+        const unsigned head = Head.load(std::memory_order_relaxed);
+        if (head == Tail.load(std::memory_order_acquire))
+            return false;
+        std::swap(item, Slots[head]);
+        Head.store((head + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T Slots[Capacity];
+    std::atomic<unsigned> Head, Tail;
+};
+
+struct JobToken {
+    const std::atomic<unsigned>* Current;
+    unsigned                     Generation;
+    bool Cancelled() const { return Current->load(std::memory_order_relaxed) != Generation; }
+};
+
+// One worker thread running the most recently submitted job.
+class JobRunner {
+public:
+    JobRunner() : Generation(0), Running(false), HasPending(false), Quit(false) { }
+    ~JobRunner() {
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Quit = true;
+            Generation.fetch_add(1);
+        }
+        Wake.notify_one();
+        if (Worker.joinable())
+            Worker.join();
+    }
+
+    // Cancels the running job and queues fn to run next. Returns its generation.
+    unsigned Submit(const std::function<void(const JobToken&)>& fn) {
+        unsigned gen;
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            gen = Generation.fetch_add(1) + 1;
+            Pending = fn;
+            HasPending = true;
+            if (!Worker.joinable())
+                Worker = std::thread(&JobRunner::Loop, this);
+        }
+        Wake.notify_one();
+        return gen;
+    }
+
+    void Cancel() {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Generation.fetch_add(1);
+        HasPending = false;
+    }
+
+    unsigned CurrentGeneration() const { return Generation.load(); }
+    bool Busy() const { return Running.load() || HasPending; }
+
+private:
+    std::atomic<unsigned> Generation;
+    std::atomic<bool>     Running, HasPending;
+    bool                  Quit;
+    std::function<void(const JobToken&)> Pending;
+    std::mutex              Mutex;
+    std::condition_variable Wake;
+    std::thread             Worker;
+
+    void Loop() {
+        for (;;) {
+            std::function<void(const JobToken&)> job;
+            JobToken token;
+            {
+                std::unique_lock<std::mutex> lock(Mutex);
+                Wake.wait(lock, [this] { return Quit || HasPending; });
+                if (Quit)
+                    return;
+                job.swap(Pending);
+                HasPending = false;
+                token.Current = &Generation;
+                token.Generation = Generation.load();
+                Running = true;
+            }
+            job(token);
+            Running = false;
+        }
+    }
+};
+
+// Part of a solution produced by the worker.
+struct OdeChunk {
+    unsigned            Generation;
+    std::vector<double> Ts, Ys;
+    std::vector<double> Dys, Q;    // dense output of these points and of the steps leaving them
+    int                 DenseDegree;
+    bool                Last;      // the solve has ended; the stats below are final
+    int                 Steps, Rejected, Evaluations;
+    bool                Success;
+    double              Seconds;
+    OdeChunk() { Generation = 0; DenseDegree = 0; Last = false; Steps = Rejected = Evaluations = 0; Success = false; Seconds = 0; }
+};
+
+namespace detail {
+
+// Observer handing every ChunkSteps accepted steps (or every MaxDelay seconds)
+// to the queue, and stopping the solve when its job is stale. Handed-over
+// points are dropped from the worker's copy of the result, so a long solve is
+// only stored once, on the UI side. Dense output goes with them: the Hermite
+// slopes of the handed-over points, and the interpolant rows of every step
+// so far, including the one that ends at the point the worker keeps.
+struct ChunkObserver {
+    SpscQueue<OdeChunk>* Queue;
+    JobToken             Token;
+    int                  ChunkSteps;
+    double               MaxDelay;
+    std::chrono::steady_clock::time_point LastPush;
+
+    bool Flush(OdeResult& r, bool last) {
+        OdeChunk chunk;
+        chunk.Generation = Token.Generation;
+        // the worker keeps its last point as the start of the next step
+        const int keep = last ? 0 : 1;
+        const int count = r.Size() - keep;
+        chunk.Ts.assign(r.Ts.begin(), r.Ts.begin() + count);
+        chunk.Ys.assign(r.Ys.begin(), r.Ys.begin() + (size_t)count * r.Dim);
+        const size_t dys = std::min(r.Dys.size(), (size_t)count * r.Dim);
+        chunk.Dys.assign(r.Dys.begin(), r.Dys.begin() + dys);
+        chunk.Q.swap(r.Q);
+        chunk.DenseDegree = r.DenseDegree;
+        chunk.Last = last;
+        chunk.Steps = r.Steps; chunk.Rejected = r.Rejected; chunk.Evaluations = r.Evaluations;
+        chunk.Success = r.Success; chunk.Seconds = r.Seconds;
+        r.Ts.erase(r.Ts.begin(), r.Ts.begin() + count);
+        r.Ys.erase(r.Ys.begin(), r.Ys.begin() + (size_t)count * r.Dim);
+        r.Dys.erase(r.Dys.begin(), r.Dys.begin() + dys);
+        // wait for room, but never for a consumer that moved on to a newer job
+        while (!Queue->Push(chunk)) {
+            if (Token.Cancelled())
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        LastPush = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    bool operator()(OdeResult& r) {
+        if (Token.Cancelled())
+            return false;
+        if (r.Size() > ChunkSteps || (r.Size() > 1 && std::chrono::duration<double>(std::chrono::steady_clock::now() - LastPush).count() > MaxDelay))
+            return Flush(r, false);
+        return true;
+    }
+};
+
+} // namespace detail
+
+class ProgressiveOde {
+public:
+    OdeResult Result;      // grows on the UI thread as chunks arrive
+    bool      Done;        // the current solve has finished (or failed)
+    int       ChunkSteps;  // accepted steps per chunk
+    double    MaxDelay;    // seconds between chunks of a slow solve
+
+    ProgressiveOde() : Done(true), ChunkSteps(2048), MaxDelay(1.0 / 60), Generation(0) { }
+
+    // Cancels the running solve and starts a new one; Result restarts empty.
+    template <class F>
+    void Start(int method, const F& f, double t0, const double* y0, int n, double t1, const OdeOptions& opt) {
+        Result = OdeResult();
+        Result.Dim = n;
+        Done = false;
+        std::vector<double> y(y0, y0 + n);
+        SpscQueue<OdeChunk>* queue = &Queue;
+        const int chunk_steps = ChunkSteps;
+        const double max_delay = MaxDelay;
+        Generation = Runner.Submit([=](const JobToken& token) {
+            detail::ChunkObserver observe = { queue, token, chunk_steps, max_delay, std::chrono::steady_clock::now() };
+            OdeWorkspace ws;
+            OdeResult r = SolveOde(method, f, t0, y.data(), n, t1, opt, ws, observe);
+            if (!token.Cancelled())
+                observe.Flush(r, true);
+        });
+    }
+
+    void Cancel() { Runner.Cancel(); Done = true; }
+
+    // Drops all but the last `keep` points of Result (and their dense output),
+    // for callers that consume the points as they arrive: a long solve then
+    // holds one chunk at a time instead of the whole trajectory.
+    void Trim(int keep = 1) {
+        const int drop = Result.Size() - keep;
+        if (drop <= 0)
+            return;
+        const size_t n = (size_t)Result.Dim;
+        Result.Ts.erase(Result.Ts.begin(), Result.Ts.begin() + drop);
+        Result.Ys.erase(Result.Ys.begin(), Result.Ys.begin() + drop * n);
+        if (!Result.Dys.empty())
+            Result.Dys.erase(Result.Dys.begin(), Result.Dys.begin() + std::min(Result.Dys.size(), drop * n));
+        if (!Result.Q.empty())
+            Result.Q.erase(Result.Q.begin(), Result.Q.begin() + std::min(Result.Q.size(), drop * n * Result.DenseDegree));
+    }
+
+    // Moves the chunks that arrived since the last call into Result and drops
+    // those of cancelled solves. Returns the number of new points.
+    int Poll() {
+        OdeChunk chunk;
+        int added = 0;
+        while (Queue.Pop(chunk)) {
+            if (chunk.Generation != Generation)
+                continue;
+            Result.Ts.insert(Result.Ts.end(), chunk.Ts.begin(), chunk.Ts.end());
+            Result.Ys.insert(Result.Ys.end(), chunk.Ys.begin(), chunk.Ys.end());
+            Result.Dys.insert(Result.Dys.end(), chunk.Dys.begin(), chunk.Dys.end());
+            Result.Q.insert(Result.Q.end(), chunk.Q.begin(), chunk.Q.end());
+            Result.DenseDegree = chunk.DenseDegree;
+            Result.Steps = chunk.Steps; Result.Rejected = chunk.Rejected; Result.Evaluations = chunk.Evaluations;
+            added += (int)chunk.Ts.size();
+            if (chunk.Last) {
+                Result.Success = chunk.Success;
+                Result.Seconds = chunk.Seconds;
+                Done = true;
+            }
+        }
+        return added;
+    }
+
+private:
+    SpscQueue<OdeChunk> Queue;
+    JobRunner           Runner;   // after Queue: joins its thread before Queue goes away
+    unsigned            Generation;
+};
+
+} // namespace Hamzstlab
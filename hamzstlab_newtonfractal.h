@@ -0,0 +1,244 @@
+// Hamzstlab Mathematics: Newton fractal of z^n - 1
+//
+// Every pixel of a complex-plane viewport is used as the start point of
+// Newton's method on p(z) = z^n - 1,
+//
+//   z <- z - (z^n - 1) / (n z^(n-1)) = ((n-1) z + 1 / z^(n-1)) / n,
+//
+// and colored by the root it converges to and by how many iterations it took.
+// The kernels follow implot-demos/demos/mandel.cpp: a scalar template, AVX
+// specializations with 8 floats or 4 doubles per register (compiled when
+// __AVX__ is defined, e.g. with -mavx), and row tiles handed to the thread pool.
+//
+// Output pixel value is 2*root + shade with shade in [0,1] (1 = converged at once),
+// ready for PlotHeatmap with scale [0, 2n-1] and NewtonFractalColormap().
+
+#pragma once
+
+#include "implot.h"
+#include "hamzstlab_parallel.h"
+#include <cmath>
+#include <stdio.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace Hamzstlab {
+
+struct NewtonFractalSpec {
+    /* Image Specification */
+    int    Width;
+    int    Height;
+    /* Fractal Specification */
+    int    Degree;      // n in z^n - 1
+    double XLim[2];     // real axis, left to right
+    double YLim[2];     // imaginary axis, first row to last row
+    int    Iterations;
+    double Tol;         // stop when |dz| < Tol
+    NewtonFractalSpec() {
+        Width = Height = 512; Degree = 3;
+        XLim[0] = YLim[1] = -1.5; XLim[1] = YLim[0] = 1.5;
+        Iterations = 64; Tol = 1e-6;
+    }
+};
+
+namespace detail {
+
+// Nearest n-th root of unity to (zr,zi) and the pixel value for it.
+inline float NewtonFractalPixel(double zr, double zi, int iters, const NewtonFractalSpec& s) {
+    if (!(zr == zr) || !(zi == zi))
+        return 0;
+    const double two_pi = 6.283185307179586;
+    int root = (int)std::floor(std::atan2(zi, zr) * s.Degree / two_pi + 0.5);
+    root = ((root % s.Degree) + s.Degree) % s.Degree;
+    float shade = 1.0f - (float)iters / s.Iterations;
+    return 2 * root + std::sqrt(shade > 0 ? shade : 0.0f);
+}
+
+} // namespace detail
+
+template <typename T>
+void NewtonFractalBasic(float* image, const NewtonFractalSpec& s) {
+    const T xdiff = s.XLim[1] - s.XLim[0];
+    const T ydiff = s.YLim[1] - s.YLim[0];
+    const T a = T(s.Degree - 1) / s.Degree, b = T(1) / s.Degree;
+    const T tol2 = T(s.Tol * s.Tol);
+    for (int y = 0; y < s.Height; y++) {
+        for (int x = 0; x < s.Width; x++) {
+            T zr = x * xdiff / s.Width  + T(s.XLim[0]);
+            T zi = y * ydiff / s.Height + T(s.YLim[0]);
+            int k = 0;
+            while (k < s.Iterations) {
+                // w = z^(n-1)
+                T wr = zr, wi = zi;
+                for (int j = 2; j < s.Degree; ++j) {
+                    T t = wr * zr - wi * zi;
+                    wi  = wr * zi + wi * zr;
+                    wr  = t;
+                }
+                T inv = b / (wr * wr + wi * wi);
+                T zr1 = a * zr + wr * inv;
+                T zi1 = a * zi - wi * inv;
+                T dr = zr1 - zr, di = zi1 - zi;
+                zr = zr1;
+                zi = zi1;
+                ++k;
+                if (!(dr * dr + di * di >= tol2))
+                    break;
+            }
+            image[y * s.Width + x] = detail::NewtonFractalPixel(zr, zi, k, s);
+        }
+    }
+}
+
+#if defined(__AVX__)
+
+template <typename T>
+void NewtonFractalAVX(float* image, const NewtonFractalSpec& s);
+
+template <>
+inline void NewtonFractalAVX<float>(float* image, const NewtonFractalSpec& s) {
+    __m256 xmin   = _mm256_set1_ps((float)s.XLim[0]);
+    __m256 ymin   = _mm256_set1_ps((float)s.YLim[0]);
+    __m256 xscale = _mm256_set1_ps((float)((s.XLim[1] - s.XLim[0]) / s.Width));
+    __m256 yscale = _mm256_set1_ps((float)((s.YLim[1] - s.YLim[0]) / s.Height));
+    __m256 a      = _mm256_set1_ps((float)(s.Degree - 1) / s.Degree);
+    __m256 b      = _mm256_set1_ps(1.0f / s.Degree);
+    __m256 tol2   = _mm256_set1_ps((float)(s.Tol * s.Tol));
+    __m256 one    = _mm256_set1_ps(1);
+    alignas(32) float zrs[8], zis[8], ks[8];
+    for (int y = 0; y < s.Height; y++) {
+        for (int x = 0; x < s.Width; x += 8) {
+            __m256 mx = _mm256_set_ps(x + 7, x + 6, x + 5, x + 4,
+                                      x + 3, x + 2, x + 1, x + 0);
+            __m256 my = _mm256_set1_ps(y);
+            __m256 zr = _mm256_add_ps(_mm256_mul_ps(mx, xscale), xmin);
+            __m256 zi = _mm256_add_ps(_mm256_mul_ps(my, yscale), ymin);
+            __m256 mk = _mm256_setzero_ps();
+            __m256 active = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int k = 0; k < s.Iterations; ++k) {
+                __m256 wr = zr, wi = zi;
+                for (int j = 2; j < s.Degree; ++j) {
+                    __m256 t = _mm256_sub_ps(_mm256_mul_ps(wr, zr), _mm256_mul_ps(wi, zi));
+                    wi = _mm256_add_ps(_mm256_mul_ps(wr, zi), _mm256_mul_ps(wi, zr));
+                    wr = t;
+                }
+                __m256 inv = _mm256_div_ps(b, _mm256_add_ps(_mm256_mul_ps(wr, wr), _mm256_mul_ps(wi, wi)));
+                __m256 zr1 = _mm256_add_ps(_mm256_mul_ps(a, zr), _mm256_mul_ps(wr, inv));
+                __m256 zi1 = _mm256_sub_ps(_mm256_mul_ps(a, zi), _mm256_mul_ps(wi, inv));
+                __m256 dr  = _mm256_sub_ps(zr1, zr);
+                __m256 di  = _mm256_sub_ps(zi1, zi);
+                zr = zr1;
+                zi = zi1;
+                mk = _mm256_add_ps(_mm256_and_ps(active, one), mk);
+                __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dr, dr), _mm256_mul_ps(di, di));
+                active = _mm256_and_ps(active, _mm256_cmp_ps(d2, tol2, _CMP_GE_OQ));
+                if (_mm256_testz_ps(active, active))
+                    break;
+            }
+            _mm256_store_ps(zrs, zr);
+            _mm256_store_ps(zis, zi);
+            _mm256_store_ps(ks, mk);
+            for (int i = 0; i < 8 && x + i < s.Width; ++i)
+                image[y * s.Width + x + i] = detail::NewtonFractalPixel(zrs[i], zis[i], (int)ks[i], s);
+        }
+    }
+}
+
+template <>
+inline void NewtonFractalAVX<double>(float* image, const NewtonFractalSpec& s) {
+    __m256d xmin   = _mm256_set1_pd(s.XLim[0]);
+    __m256d ymin   = _mm256_set1_pd(s.YLim[0]);
+    __m256d xscale = _mm256_set1_pd((s.XLim[1] - s.XLim[0]) / s.Width);
+    __m256d yscale = _mm256_set1_pd((s.YLim[1] - s.YLim[0]) / s.Height);
+    __m256d a      = _mm256_set1_pd((double)(s.Degree - 1) / s.Degree);
+    __m256d b      = _mm256_set1_pd(1.0 / s.Degree);
+    __m256d tol2   = _mm256_set1_pd(s.Tol * s.Tol);
+    __m256d one    = _mm256_set1_pd(1);
+    alignas(32) double zrs[4], zis[4], ks[4];
+    for (int y = 0; y < s.Height; y++) {
+        for (int x = 0; x < s.Width; x += 4) {
+            __m256d mx = _mm256_set_pd(x + 3, x + 2, x + 1, x + 0);
+            __m256d my = _mm256_set1_pd(y);
+            __m256d zr = _mm256_add_pd(_mm256_mul_pd(mx, xscale), xmin);
+            __m256d zi = _mm256_add_pd(_mm256_mul_pd(my, yscale), ymin);
+            __m256d mk = _mm256_setzero_pd();
+            __m256d active = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+            for (int k = 0; k < s.Iterations; ++k) {
+                __m256d wr = zr, wi = zi;
+                for (int j = 2; j < s.Degree; ++j) {
+                    __m256d t = _mm256_sub_pd(_mm256_mul_pd(wr, zr), _mm256_mul_pd(wi, zi));
+                    wi = _mm256_add_pd(_mm256_mul_pd(wr, zi), _mm256_mul_pd(wi, zr));
+                    wr = t;
+                }
+                __m256d inv = _mm256_div_pd(b, _mm256_add_pd(_mm256_mul_pd(wr, wr), _mm256_mul_pd(wi, wi)));
+                __m256d zr1 = _mm256_add_pd(_mm256_mul_pd(a, zr), _mm256_mul_pd(wr, inv));
+                __m256d zi1 = _mm256_sub_pd(_mm256_mul_pd(a, zi), _mm256_mul_pd(wi, inv));
+                __m256d dr  = _mm256_sub_pd(zr1, zr);
+                __m256d di  = _mm256_sub_pd(zi1, zi);
+                zr = zr1;
+                zi = zi1;
+                mk = _mm256_add_pd(_mm256_and_pd(active, one), mk);
+                __m256d d2 = _mm256_add_pd(_mm256_mul_pd(dr, dr), _mm256_mul_pd(di, di));
+                active = _mm256_and_pd(active, _mm256_cmp_pd(d2, tol2, _CMP_GE_OQ));
+                if (_mm256_testz_pd(active, active))
+                    break;
+            }
+            _mm256_store_pd(zrs, zr);
+            _mm256_store_pd(zis, zi);
+            _mm256_store_pd(ks, mk);
+            for (int i = 0; i < 4 && x + i < s.Width; ++i)
+                image[y * s.Width + x + i] = detail::NewtonFractalPixel(zrs[i], zis[i], (int)ks[i], s);
+        }
+    }
+}
+
+#endif // __AVX__
+
+inline bool NewtonFractalHasAVX() {
+#if defined(__AVX__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Renders the whole image. Rows are split into tiles of `tile_rows` that the
+// thread pool picks up one at a time, so expensive regions (basin boundaries)
+// do not leave the other threads idle. image must hold Width*Height floats.
+template <typename T>
+void RenderNewtonFractal(float* image, const NewtonFractalSpec& s, bool avx, int threads = 0, int tile_rows = 16) {
+    const double dy = (s.YLim[1] - s.YLim[0]) / s.Height;
+    ParallelFor(s.Height, tile_rows, [&](int begin, int end) {
+        NewtonFractalSpec ss = s;
+        ss.Height  = end - begin;
+        ss.YLim[0] = s.YLim[0] + begin * dy;
+        ss.YLim[1] = ss.YLim[0] + ss.Height * dy;
+        float* sub = image + (size_t)begin * s.Width;
+#if defined(__AVX__)
+        if (avx) { NewtonFractalAVX<T>(sub, ss); return; }
+#endif
+        (void)avx;
+        NewtonFractalBasic<T>(sub, ss);
+    }, threads);
+}
+
+// Colormap with a dark and a bright key per root: pixel value 2*root + shade
+// interpolates between them. Registered once per degree.
+inline ImPlotColormap NewtonFractalColormap(int degree) {
+    char name[32];
+    snprintf(name, sizeof(name), "Newton Fractal %d", degree);
+    ImPlotColormap cmap = ImPlot::GetColormapIndex(name);
+    if (cmap != -1)
+        return cmap;
+    ImVector<ImU32> keys;
+    for (int k = 0; k < degree; ++k) {
+        ImVec4 c;
+        ImGui::ColorConvertHSVtoRGB((float)k / degree, 0.75f, 1.0f, c.x, c.y, c.z);
+        keys.push_back(ImGui::ColorConvertFloat4ToU32(ImVec4(c.x * 0.08f, c.y * 0.08f, c.z * 0.08f, 1)));
+        keys.push_back(ImGui::ColorConvertFloat4ToU32(ImVec4(c.x, c.y, c.z, 1)));
+    }
+    return ImPlot::AddColormap(name, keys.Data, keys.Size, false);
+}
+
+} // namespace Hamzstlab
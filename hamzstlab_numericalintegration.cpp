@@ -0,0 +1,373 @@
+// MIT License
+
+// Copyright (c) 2023 Evan Pezent
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// ImPlot v0.17
+
+// We define this so that the demo does not accidentally use deprecated API
+#ifndef IMPLOT_DISABLE_OBSOLETE_FUNCTIONS
+#define IMPLOT_DISABLE_OBSOLETE_FUNCTIONS
+#endif
+
+#include "implot.h"
+#ifndef IMGUI_DISABLE
+#include <math.h>
+#include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hamzstlab_quadrature.h"
+
+#ifdef _MSC_VER
+#define sprintf sprintf_s
+#endif
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+#if !defined(IMGUI_DISABLE_DEMO_WINDOWS)
+
+namespace ImPlot {
+
+//-----------------------------------------------------------------------------
+// [SECTION] Demo Functions
+//-----------------------------------------------------------------------------
+
+void Demo_Help() {
+    ImGui::Text("ABOUT THIS DEMO:");
+    ImGui::BulletText("We are demonstrating numerical integration with Simpson's rule, Romberg integration and adaptive Gauss-Kronrod quadrature");
+    ImGui::Separator();
+    ImGui::Text("PROGRAMMER GUIDE:");
+    ImGui::BulletText("See the ShowNumericalIntegrationWindow() code in hamzstlab_numericalintegration.cpp. <- you are here!");
+    ImGui::BulletText("If you see visual artifacts, do one of the following:");
+    ImGui::Indent();
+    ImGui::BulletText("Handle ImGuiBackendFlags_RendererHasVtxOffset for 16-bit indices in your backend.");
+    ImGui::BulletText("Or, enable 32-bit indices in imconfig.h.");
+    ImGui::BulletText("Your current configuration is:");
+    ImGui::Indent();
+    ImGui::BulletText("ImDrawIdx: %d-bit", (int)(sizeof(ImDrawIdx) * 8));
+    ImGui::BulletText("ImGuiBackendFlags_RendererHasVtxOffset: %s", (ImGui::GetIO().BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset) ? "True" : "False");
+    ImGui::Unindent();
+    ImGui::Unindent();
+    ImGui::Separator();
+    ImGui::Text("USER GUIDE:");
+    ShowUserGuide();
+}
+
+//-----------------------------------------------------------------------------
+
+void Demo_Config() {
+    ImGui::ShowFontSelector("Font");
+    ImGui::ShowStyleSelector("ImGui Style");
+    ImPlot::ShowStyleSelector("ImPlot Style");
+    ImPlot::ShowColormapSelector("ImPlot Colormap");
+    ImPlot::ShowInputMapSelector("Input Map");
+}
+
+//-----------------------------------------------------------------------------
+
+static const char* IntegrandNames[] = { "f(x) = exp(-x^2)", "f(x) = sqrt(x)", "f(x) = 1 / ((x - 0.3)^2 + 0.0001)", "f(x) = x sin(50x)", "f(x) = 1 / (1 + 25x^2)" };
+
+// The integrands as templates, so the quadrature rules can evaluate four nodes per call.
+struct Integrand {
+    int Func;
+    template <typename T> T operator()(const T& x) const {
+        using std::exp; using std::sqrt; using std::sin;
+        switch (Func) {
+            case 1:  return sqrt(x);
+            case 2:  return 1.0 / ((x - 0.3) * (x - 0.3) + 1e-4);
+            case 3:  return x * sin(50.0 * x);
+            case 4:  return 1.0 / (1.0 + 25.0 * x * x);
+            default: return exp(-x * x);
+        }
+    }
+};
+
+// Exact antiderivatives, for the true error of every result.
+double IntegrandPrimitive(int func, double x) {
+    switch (func) {
+        case 1:  return 2.0 / 3.0 * x * sqrt(x);
+        case 2:  return 100 * atan((x - 0.3) / 0.01);
+        case 3:  return sin(50 * x) / 2500 - x * cos(50 * x) / 50;
+        case 4:  return atan(5 * x) / 5;
+        default: return sqrt(PI) / 2 * erf(x);
+    }
+}
+
+// Results for one (f, a, b, method, tolerance), and evaluations against
+// tolerance for every method, recomputed only when f or [a,b] change.
+struct QuadratureCache {
+    int   Func, Method;
+    float A, B, Tol;
+    Hamzstlab::QuadratureResult Result;
+    double Exact;
+    ImVector<double> CurveXs, CurveYs;
+    ImVector<double> ShadeXs, ShadeYs;     // SamplesPerSegment points for every segment
+    ImVector<double> Bounds;               // segment boundaries
+    int              SamplesPerSegment;
+    ImVector<double> SweepTols, SweepEvals[Hamzstlab::QuadratureMethod_COUNT], SweepErrors[Hamzstlab::QuadratureMethod_COUNT];
+    QuadratureCache() { Func = Method = -1; A = B = Tol = 0; Exact = 0; SamplesPerSegment = 0; }
+    void Update(int func, float a, float b, int method, float tol) {
+        const bool interval = func != Func || a != A || b != B;
+        if (!interval && method == Method && tol == Tol)
+            return;
+        Func = func; A = a; B = b; Method = method; Tol = tol;
+        Integrand f = { func };
+        Exact = IntegrandPrimitive(func, b) - IntegrandPrimitive(func, a);
+        Hamzstlab::QuadratureOptions opt(pow(10.0, (double)tol), pow(10.0, (double)tol));
+        Result = Hamzstlab::Integrate(method, f, a, b, opt);
+        UpdateSegments(f);
+        if (interval)
+            UpdateSweep(f);
+    }
+    void UpdateSegments(const Integrand& f) {
+        // Simpson and Romberg panels are uniform; show them the same way when there are few enough
+        std::vector<Hamzstlab::QuadratureSegment> segs = Result.Segments;
+        if (segs.empty()) {
+            const int panels = Result.Levels <= 10 ? 1 << Result.Levels : 1;
+            for (int i = 0; i < panels; ++i) {
+                Hamzstlab::QuadratureSegment s = { A + (B - A) * i / panels, A + (B - A) * (i + 1) / panels, 0, 0 };
+                segs.push_back(s);
+            }
+        }
+        const int n = (int)segs.size();
+        SamplesPerSegment = n <= 64 ? 32 : (n <= 512 ? 8 : 2);
+        const int m = SamplesPerSegment;
+        ShadeXs.resize(n * m);
+        ShadeYs.resize(n * m);
+        Bounds.resize(0);
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < m; ++j)
+                ShadeXs[i * m + j] = segs[i].A + (segs[i].B - segs[i].A) * j / (m - 1);
+            Bounds.push_back(segs[i].A);
+        }
+        Bounds.push_back(B);
+        Hamzstlab::QuadratureEval(f, ShadeXs.Data, ShadeYs.Data, ShadeXs.Size);
+        CurveXs.resize(1000);
+        CurveYs.resize(1000);
+        for (int i = 0; i < 1000; ++i)
+            CurveXs[i] = A + (B - A) * i / 999.0;
+        Hamzstlab::QuadratureEval(f, CurveXs.Data, CurveYs.Data, CurveXs.Size);
+    }
+    void UpdateSweep(const Integrand& f) {
+        SweepTols.resize(0);
+        for (int e = 2; e <= 13; ++e)
+            SweepTols.push_back(pow(10.0, -e));
+        for (int m = 0; m < Hamzstlab::QuadratureMethod_COUNT; ++m) {
+            SweepEvals[m].resize(0);
+            SweepErrors[m].resize(0);
+            for (int i = 0; i < SweepTols.Size; ++i) {
+                Hamzstlab::QuadratureOptions opt(SweepTols[i], SweepTols[i]);
+                opt.MaxLevels = 16;     // keeps dragging [a,b] interactive when Simpson and Romberg stall
+                Hamzstlab::QuadratureResult r = Hamzstlab::Integrate(m, f, A, B, opt);
+                SweepEvals[m].push_back((double)r.Evaluations);
+                // exact answers have no place on a log axis
+                SweepErrors[m].push_back(fmax(fabs(r.Value - Exact), 1e-17));
+            }
+        }
+    }
+};
+
+void Demo_Quadrature() {
+	static int   func = 2;
+	static float a = 0, b = 1;
+	static int   method = Hamzstlab::QuadratureMethod_GaussKronrod;
+	static float tol = -8;      // log10 of the absolute and relative tolerance
+	static QuadratureCache cache;
+
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("f(x)", &func, IntegrandNames, IM_ARRAYSIZE(IntegrandNames));
+	ImGui::SetNextItemWidth(200);
+	ImGui::DragFloatRange2("[a,b]", &a, &b, 0.01f, -5.0f, 5.0f);
+	// sqrt(x) is integrated over x >= 0 only
+	if (func == 1 && a < 0) a = 0;
+	if (b <= a) b = a + 0.01f;
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("Method", &method, "Simpson\0Romberg\0Gauss-Kronrod (G7K15)\0");
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderFloat("log10(Tol)", &tol, -13, -2, "%.1f");
+
+	cache.Update(func, a, b, method, tol);
+	const Hamzstlab::QuadratureResult& r = cache.Result;
+
+	ImGui::Text("Integral %.15g, estimated error %.2e, true error %.2e%s", r.Value, r.Error, fabs(r.Value - cache.Exact), r.Converged ? "" : " (not converged)");
+	if (method == Hamzstlab::QuadratureMethod_GaussKronrod)
+		ImGui::Text("%lld evaluations, %d segments, %.3f ms", r.Evaluations, (int)r.Segments.size(), r.Seconds * 1e3);
+	else
+		ImGui::Text("%lld evaluations, %d panels, %.3f ms", r.Evaluations, 1 << r.Levels, r.Seconds * 1e3);
+
+	if (method == Hamzstlab::QuadratureMethod_Romberg && ImGui::TreeNode("Romberg Tableau")) {
+		// the last rows and columns, where the extrapolation converges
+		const int rows = r.Levels + 1 < 8 ? r.Levels + 1 : 8, first = r.Levels + 1 - rows;
+		if (ImGui::BeginTable("##Tableau", rows + 1, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+			ImGui::TableSetupColumn("Panels");
+			for (int j = first; j <= r.Levels; ++j) {
+				char label[16];
+				sprintf(label, "R(k,%d)", j);
+				ImGui::TableSetupColumn(label);
+			}
+			ImGui::TableHeadersRow();
+			for (int k = first; k <= r.Levels; ++k) {
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn(); ImGui::Text("%d", 1 << k);
+				for (int j = first; j <= k; ++j) {
+					ImGui::TableNextColumn(); ImGui::Text("%.12f", r.RombergAt(k, j));
+				}
+			}
+			ImGui::EndTable();
+		}
+		ImGui::TreePop();
+	}
+
+	if (ImPlot::BeginPlot("Subdivision")) {
+	ImPlot::SetupAxes("x", "f(x)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
+	const int m = cache.SamplesPerSegment, n = m > 0 ? cache.ShadeXs.Size / m : 0;
+	// alternate two shades so that neighbouring segments stay apart
+	for (int i = 0; i < n; ++i) {
+		ImPlot::SetNextFillStyle(ImPlot::GetColormapColor(i % 2 == 0 ? 0 : 1), 0.5f);
+		ImPlot::PlotShaded(i % 2 == 0 ? "Segments" : "##Segments", &cache.ShadeXs[i * m], &cache.ShadeYs[i * m], m);
+	}
+	if (cache.Bounds.Size <= 1025)
+		ImPlot::PlotInfLines("Boundaries", cache.Bounds.Data, cache.Bounds.Size);
+	ImPlot::SetNextLineStyle(ImVec4(0, 0, 0, 1));
+	ImPlot::PlotLine(IntegrandNames[func], cache.CurveXs.Data, cache.CurveYs.Data, cache.CurveXs.Size);
+	ImPlot::EndPlot();
+	}
+
+	if (ImPlot::BeginSubplots("##Sweep", 1, 2, ImVec2(-1, 400))) {
+	if (ImPlot::BeginPlot("Evaluations to Tolerance")) {
+		ImPlot::SetupAxes("Tolerance", "Evaluations", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+		ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+		for (int k = 0; k < Hamzstlab::QuadratureMethod_COUNT; ++k) {
+			ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
+			ImPlot::PlotLine(Hamzstlab::QuadratureMethodName(k), cache.SweepTols.Data, cache.SweepEvals[k].Data, cache.SweepTols.Size);
+		}
+		ImPlot::EndPlot();
+	}
+	if (ImPlot::BeginPlot("True Error")) {
+		ImPlot::SetupAxes("Evaluations", "|error|", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+		ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+		for (int k = 0; k < Hamzstlab::QuadratureMethod_COUNT; ++k) {
+			ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
+			ImPlot::PlotScatter(Hamzstlab::QuadratureMethodName(k), cache.SweepEvals[k].Data, cache.SweepErrors[k].Data, cache.SweepEvals[k].Size);
+		}
+		ImPlot::EndPlot();
+	}
+	ImPlot::EndSubplots();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// DEMO WINDOW
+//-----------------------------------------------------------------------------
+
+void DemoHeader(const char* label, void(*demo)()) {
+    if (ImGui::TreeNodeEx(label)) {
+        demo();
+        ImGui::TreePop();
+    }
+}
+
+void ShowNumericalIntegrationWindow(bool* p_open) {
+    static bool show_implot_metrics      = false;
+    static bool show_implot_style_editor = false;
+    static bool show_imgui_metrics       = false;
+    static bool show_imgui_style_editor  = false;
+    static bool show_imgui_demo          = false;
+
+    if (show_implot_metrics) {
+        ImPlot::ShowMetricsWindow(&show_implot_metrics);
+    }
+    if (show_implot_style_editor) {
+        ImGui::SetNextWindowSize(ImVec2(415,762), ImGuiCond_Appearing);
+        ImGui::Begin("Style Editor (ImPlot)", &show_implot_style_editor);
+        ImPlot::ShowStyleEditor();
+        ImGui::End();
+    }
+    if (show_imgui_style_editor) {
+        ImGui::Begin("Style Editor (ImGui)", &show_imgui_style_editor);
+        ImGui::ShowStyleEditor();
+        ImGui::End();
+    }
+    if (show_imgui_metrics) {
+        ImGui::ShowMetricsWindow(&show_imgui_metrics);
+    }
+    if (show_imgui_demo) {
+        ImGui::ShowDemoWindow(&show_imgui_demo);
+    }
+    ImGui::SetNextWindowPos(ImVec2(50, 50), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(600, 750), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Numerical Integration", p_open, ImGuiWindowFlags_MenuBar);
+    if (ImGui::BeginMenuBar()) {
+        if (ImGui::BeginMenu("Tools")) {
+            ImGui::MenuItem("Metrics",      nullptr, &show_implot_metrics);
+            ImGui::MenuItem("Style Editor", nullptr, &show_implot_style_editor);
+            ImGui::Separator();
+            ImGui::MenuItem("ImGui Metrics",       nullptr, &show_imgui_metrics);
+            ImGui::MenuItem("ImGui Style Editor",  nullptr, &show_imgui_style_editor);
+            ImGui::MenuItem("ImGui Demo",          nullptr, &show_imgui_demo);
+            ImGui::EndMenu();
+        }
+        ImGui::EndMenuBar();
+    }
+    //-------------------------------------------------------------------------
+    ImGui::Text("with ImPlot (v%s)", IMPLOT_VERSION);
+    // display warning about 16-bit indices
+    static bool showWarning = sizeof(ImDrawIdx)*8 == 16 && (ImGui::GetIO().BackendFlags & ImGuiBackendFlags_RendererHasVtxOffset) == false;
+    if (showWarning) {
+        ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1,1,0,1));
+        ImGui::TextWrapped("WARNING: ImDrawIdx is 16-bit and ImGuiBackendFlags_RendererHasVtxOffset is false. Expect visual glitches and artifacts! See README for more information.");
+        ImGui::PopStyleColor();
+    }
+
+    ImGui::Spacing();
+
+    if (ImGui::BeginTabBar("ImPlotDemoTabs")) {
+        if (ImGui::BeginTabItem("Plots")) {
+            DemoHeader("Simpson, Romberg and Gauss-Kronrod", Demo_Quadrature);
+            ImGui::EndTabItem();
+        }
+        if (ImGui::BeginTabItem("Config")) {
+            Demo_Config();
+            ImGui::EndTabItem();
+        }
+        if (ImGui::BeginTabItem("Help")) {
+            Demo_Help();
+            ImGui::EndTabItem();
+        }
+        ImGui::EndTabBar();
+    }
+    ImGui::End();
+}
+
+} // namespace ImPlot
+
+#else
+
+namespace ImPlot { void ShowNumericalIntegrationWindow(bool* p_open) {} }
+
+#endif
+
+#endif // #ifndef IMGUI_DISABLE
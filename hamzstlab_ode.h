@@ -0,0 +1,378 @@
+// Hamzstlab Mathematics: explicit Runge-Kutta integrators for y' = f(t, y)
+//
+// The right-hand side is any callable object
+//
+//   struct Rhs { void operator()(double t, const double* y, double* dydt) const; };
+//
+// passed as a template parameter, so every stage is a direct (inlinable) call.
+// SolveOde integrates a system of n equations from t0 to t1:
+//
+//   Hamzstlab::OdeOptions opt;            // RelTol/AbsTol for adaptive methods, H for fixed ones
+//   Hamzstlab::OdeResult r = Hamzstlab::SolveOde(Hamzstlab::OdeMethod_RK45, Rhs(), 0.0, y0, n, 10.0, opt);
+//   for (int i = 0; i < r.Size(); ++i) printf("%g %g\n", r.Ts[i], r.Y(i)[0]);
+//
+// Fixed-step methods: Euler, Heun (explicit trapezoid) and the classical RK4.
+// Adaptive methods: RK23 (Bogacki-Shampine 3(2)) and RK45 (Dormand-Prince 5(4)),
+// both first-same-as-last and advancing with the higher order solution; the
+// step size follows the embedded error estimate. Stage buffers live in an
+// OdeWorkspace allocated once per solve (or reused across solves).
+//
+// With OdeOptions::Dense the result is also a continuous function of t:
+// RK23 and RK45 keep the coefficients of their own interpolants (the free
+// cubic of Bogacki-Shampine and the quartic of Dormand-Prince), the other
+// methods keep f(t, y) at every step for cubic Hermite interpolation. Plots can
+// then sample r.Eval(t, i) at pixel resolution, e.g. through
+// CurveSampler::Update(OdeComponent(r, i)), while the solver keeps its natural
+// step count.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace Hamzstlab {
+
+enum OdeMethod {
+    OdeMethod_Euler,
+    OdeMethod_Heun,
+    OdeMethod_RK4,
+    OdeMethod_RK23,
+    OdeMethod_RK45,
+    OdeMethod_COUNT
+};
+
+inline const char* OdeMethodName(int method) {
+    static const char* names[] = { "Euler", "Heun", "RK4", "RK23 (Bogacki-Shampine)", "RK45 (Dormand-Prince)" };
+    return method >= 0 && method < OdeMethod_COUNT ? names[method] : "";
+}
+
+inline bool OdeMethodAdaptive(int method) { return method == OdeMethod_RK23 || method == OdeMethod_RK45; }
+
+struct OdeOptions {
+    double H;         // step of fixed-step methods; initial step of adaptive ones (<= 0 picks one)
+    double RelTol;
+    double AbsTol;
+    double HMin;
+    double HMax;      // <= 0 means no limit
+    int    MaxSteps;
+    bool   Dense;     // keep what OdeResult::Eval needs between the steps
+    OdeOptions() { H = 0.01; RelTol = 1e-6; AbsTol = 1e-9; HMin = 1e-14; HMax = 0; MaxSteps = 1000000; Dense = false; }
+};
+
+struct OdeResult {
+    int    Dim;
+    std::vector<double> Ts;
+    std::vector<double> Ys;   // Dim values per entry of Ts
+    int    Steps;             // accepted steps
+    int    Rejected;          // rejected adaptive steps
+    int    Evaluations;       // calls of f
+    int    Jacobians;         // Jacobian evaluations (implicit methods)
+    int    Factorizations;    // LU decompositions (implicit methods)
+    bool   Success;           // reached t1
+    bool   Stopped;           // ended early because the observer returned false
+    double Seconds;
+    // dense output, filled when OdeOptions::Dense is set
+    std::vector<double> Dys;  // f(t, y), Dim values per entry of Ts (Hermite)
+    std::vector<double> Q;    // Dim x DenseDegree interpolant coefficients per step
+    int    DenseDegree;       // 0 when the Hermite cubic is used
+    OdeResult() { Dim = 0; Steps = Rejected = Evaluations = Jacobians = Factorizations = 0; Success = Stopped = false; Seconds = 0; DenseDegree = 0; }
+    int Size() const { return (int)Ts.size(); }
+    const double* Y(int i) const { return &Ys[(size_t)i * Dim]; }
+    bool HasDense() const { return Size() > 1 && (DenseDegree > 0 ? Q.size() == (size_t)(Size() - 1) * Dim * DenseDegree : Dys.size() == Ys.size()); }
+
+    // Index i of the step [Ts[i], Ts[i+1]] containing t (clamped to the ends).
+    int Locate(double t) const {
+        const int n = Size();
+        if (n < 2) return 0;
+        int i = Ts[n - 1] >= Ts[0] ? (int)(std::upper_bound(Ts.begin(), Ts.end(), t) - Ts.begin()) - 1
+                                   : (int)(std::upper_bound(Ts.begin(), Ts.end(), t, std::greater<double>()) - Ts.begin()) - 1;
+        return i < 0 ? 0 : (i > n - 2 ? n - 2 : i);
+    }
+
+    // Component c of the solution at t inside the integrated range, NaN outside
+    // it. Without dense output the steps are joined linearly.
+    double Eval(double t, int c) const {
+        const int n = Size();
+        if (n == 0 || c < 0 || c >= Dim) return std::numeric_limits<double>::quiet_NaN();
+        const double lo = std::fmin(Ts[0], Ts[n - 1]), hi = std::fmax(Ts[0], Ts[n - 1]);
+        if (!(t >= lo && t <= hi)) return std::numeric_limits<double>::quiet_NaN();
+        if (n == 1) return Ys[c];
+        const int i = Locate(t);
+        const double h = Ts[i + 1] - Ts[i], s = h != 0 ? (t - Ts[i]) / h : 0;
+        const double y0 = Ys[(size_t)i * Dim + c], y1 = Ys[(size_t)(i + 1) * Dim + c];
+        if (!HasDense())
+            return y0 + s * (y1 - y0);
+        if (DenseDegree > 0) {
+            // y0 + h (q_1 s + q_2 s^2 + ... + q_d s^d)
+            const double* q = &Q[((size_t)i * Dim + c) * DenseDegree];
+            double acc = 0;
+            for (int j = DenseDegree - 1; j >= 0; --j)
+                acc = (acc + q[j]) * s;
+            return y0 + h * acc;
+        }
+        const double f0 = Dys[(size_t)i * Dim + c], f1 = Dys[(size_t)(i + 1) * Dim + c];
+        const double s2 = s * s, s3 = s2 * s;
+        return (2 * s3 - 3 * s2 + 1) * y0 + (s3 - 2 * s2 + s) * h * f0 + (3 * s2 - 2 * s3) * y1 + (s3 - s2) * h * f1;
+    }
+
+    void Eval(double t, double* y) const {
+        for (int c = 0; c < Dim; ++c) y[c] = Eval(t, c);
+    }
+};
+
+// One component of a solution as a function of t, e.g. for CurveSampler.
+struct OdeComponent {
+    const OdeResult* Result;
+    int              Component;
+    OdeComponent(const OdeResult& r, int c) : Result(&r), Component(c) { }
+    double operator()(double t) const { return Result->Eval(t, Component); }
+};
+
+// Butcher tableau of an explicit method. E holds b - b_hat for the error estimate.
+struct ButcherTableau {
+    int           Stages;
+    int           Order;        // order of the propagated solution
+    int           ErrorOrder;   // order of the embedded solution, 0 if none
+    bool          FSAL;         // last stage equals f(t+h, y_new)
+    const double* A;            // Stages x Stages, row-major, strictly lower
+    const double* B;
+    const double* C;
+    const double* E;
+    int           DenseDegree;  // degree of the built-in interpolant, 0 if none
+    const double* P;            // Stages x DenseDegree, row-major
+};
+
+inline const ButcherTableau& OdeTableau(int method) {
+    static const double euler_a[] = { 0 };
+    static const double euler_b[] = { 1 };
+    static const double euler_c[] = { 0 };
+    static const double heun_a[]  = { 0, 0,
+                                      1, 0 };
+    static const double heun_b[]  = { 0.5, 0.5 };
+    static const double heun_c[]  = { 0, 1 };
+    static const double rk4_a[]   = { 0,   0,   0, 0,
+                                      0.5, 0,   0, 0,
+                                      0,   0.5, 0, 0,
+                                      0,   0,   1, 0 };
+    static const double rk4_b[]   = { 1.0/6, 1.0/3, 1.0/3, 1.0/6 };
+    static const double rk4_c[]   = { 0, 0.5, 0.5, 1 };
+    static const double bs_a[]    = { 0,     0,     0,     0,
+                                      0.5,   0,     0,     0,
+                                      0,     0.75,  0,     0,
+                                      2.0/9, 1.0/3, 4.0/9, 0 };
+    static const double bs_b[]    = { 2.0/9, 1.0/3, 4.0/9, 0 };
+    static const double bs_c[]    = { 0, 0.5, 0.75, 1 };
+    static const double bs_e[]    = { 2.0/9 - 7.0/24, 1.0/3 - 0.25, 4.0/9 - 1.0/3, -0.125 };
+    static const double dp_a[]    = { 0,              0,               0,              0,            0,               0,         0,
+                                      1.0/5,          0,               0,              0,            0,               0,         0,
+                                      3.0/40,         9.0/40,          0,              0,            0,               0,         0,
+                                      44.0/45,       -56.0/15,         32.0/9,         0,            0,               0,         0,
+                                      19372.0/6561,  -25360.0/2187,    64448.0/6561,  -212.0/729,    0,               0,         0,
+                                      9017.0/3168,   -355.0/33,        46732.0/5247,   49.0/176,    -5103.0/18656,    0,         0,
+                                      35.0/384,       0,               500.0/1113,     125.0/192,   -2187.0/6784,     11.0/84,   0 };
+    static const double dp_b[]    = { 35.0/384, 0, 500.0/1113, 125.0/192, -2187.0/6784, 11.0/84, 0 };
+    static const double dp_c[]    = { 0, 1.0/5, 3.0/10, 4.0/5, 8.0/9, 1, 1 };
+    static const double dp_e[]    = { 35.0/384 - 5179.0/57600, 0, 500.0/1113 - 7571.0/16695, 125.0/192 - 393.0/640,
+                                      -2187.0/6784 + 92097.0/339200, 11.0/84 - 187.0/2100, -1.0/40 };
+    // y(t + s h) = y + h sum_j (sum_i k_i P[i][j]) s^(j+1)
+    static const double bs_p[]    = { 1, -4.0/3,  5.0/9,
+                                      0,  1.0,   -2.0/3,
+                                      0,  4.0/3, -8.0/9,
+                                      0, -1.0,    1.0 };
+    static const double dp_p[]    = { 1, -8048581381.0/2820520608,    8663915743.0/2820520608,    -12715105075.0/11282082432,
+                                      0,  0,                           0,                           0,
+                                      0,  131558114200.0/32700410799, -68118460800.0/10900136933,  87487479700.0/32700410799,
+                                      0, -1754552775.0/470086768,      14199869525.0/1410260304,   -10690763975.0/1880347072,
+                                      0,  127303824393.0/49829197408, -318862633887.0/49829197408, 701980252875.0/199316789632,
+                                      0, -282668133.0/205662961,       2019193451.0/616988883,     -1453857185.0/822651844,
+                                      0,  40617522.0/29380423,        -110615467.0/29380423,        69997945.0/29380423 };
+    static const ButcherTableau tableaus[] = {
+        { 1, 1, 0, false, euler_a, euler_b, euler_c, nullptr, 0, nullptr },
+        { 2, 2, 0, false, heun_a,  heun_b,  heun_c,  nullptr, 0, nullptr },
+        { 4, 4, 0, false, rk4_a,   rk4_b,   rk4_c,   nullptr, 0, nullptr },
+        { 4, 3, 2, true,  bs_a,    bs_b,    bs_c,    bs_e,    3, bs_p    },
+        { 7, 5, 4, true,  dp_a,    dp_b,    dp_c,    dp_e,    4, dp_p    },
+    };
+    return tableaus[method >= 0 && method < OdeMethod_COUNT ? method : OdeMethod_RK45];
+}
+
+// Stage and scratch storage for one system size; reused between steps and solves.
+struct OdeWorkspace {
+    int                 Dim;
+    std::vector<double> K;      // Stages x Dim stage derivatives
+    std::vector<double> Tmp, YNew, Err;
+    OdeWorkspace() { Dim = 0; }
+    void Resize(int n, int stages) {
+        Dim = n;
+        if ((int)K.size() < stages * n) K.resize((size_t)stages * n);
+        Tmp.resize(n); YNew.resize(n); Err.resize(n);
+    }
+    double* Stage(int i) { return &K[(size_t)i * Dim]; }
+};
+
+// One explicit RK step from (t, y) with step h into ws.YNew (and ws.Err when the
+// tableau is embedded). Stage 0 must already hold f(t, y).
+template <class F>
+void RKStep(const ButcherTableau& tab, const F& f, double t, const double* y, double h, OdeWorkspace& ws, int& evals) {
+    const int n = ws.Dim;
+    for (int s = 1; s < tab.Stages; ++s) {
+        const double* a = tab.A + s * tab.Stages;
+        for (int i = 0; i < n; ++i) {
+            double acc = 0;
+            for (int j = 0; j < s; ++j)
+                acc += a[j] * ws.K[(size_t)j * n + i];
+            ws.Tmp[i] = y[i] + h * acc;
+        }
+        f(t + tab.C[s] * h, ws.Tmp.data(), ws.Stage(s));
+        ++evals;
+    }
+    for (int i = 0; i < n; ++i) {
+        double acc = 0, err = 0;
+        for (int j = 0; j < tab.Stages; ++j) {
+            acc += tab.B[j] * ws.K[(size_t)j * n + i];
+            if (tab.E) err += tab.E[j] * ws.K[(size_t)j * n + i];
+        }
+        ws.YNew[i] = y[i] + h * acc;
+        ws.Err[i]  = h * err;
+    }
+}
+
+// RMS of err_i / (AbsTol + RelTol * max(|y_i|, |ynew_i|)); a step is accepted when <= 1.
+inline double OdeErrorNorm(const double* y, const double* ynew, const double* err, int n, const OdeOptions& opt) {
+    double sum = 0;
+    for (int i = 0; i < n; ++i) {
+        double sc = opt.AbsTol + opt.RelTol * std::fmax(std::fabs(y[i]), std::fabs(ynew[i]));
+        double e  = err[i] / sc;
+        sum += e * e;
+    }
+    return std::sqrt(sum / n);
+}
+
+// Starting step from the size of y and f(t0, y0) (Hairer, Norsett & Wanner, II.4).
+template <class F>
+double OdeInitialStep(const F& f, double t0, const double* y0, const double* f0, int n, int order, double dir, const OdeOptions& opt, int& evals) {
+    double d0 = 0, d1 = 0;
+    for (int i = 0; i < n; ++i) {
+        double sc = opt.AbsTol + opt.RelTol * std::fabs(y0[i]);
+        d0 += (y0[i] / sc) * (y0[i] / sc);
+        d1 += (f0[i] / sc) * (f0[i] / sc);
+    }
+    d0 = std::sqrt(d0 / n); d1 = std::sqrt(d1 / n);
+    double h0 = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+    std::vector<double> y1(n), f1(n);
+    for (int i = 0; i < n; ++i)
+        y1[i] = y0[i] + dir * h0 * f0[i];
+    f(t0 + dir * h0, y1.data(), f1.data());
+    ++evals;
+    double d2 = 0;
+    for (int i = 0; i < n; ++i) {
+        double sc = opt.AbsTol + opt.RelTol * std::fabs(y0[i]);
+        d2 += ((f1[i] - f0[i]) / sc) * ((f1[i] - f0[i]) / sc);
+    }
+    d2 = std::sqrt(d2 / n) / h0;
+    double m  = std::fmax(d1, d2);
+    double h1 = m <= 1e-15 ? std::fmax(1e-6, h0 * 1e-3) : std::pow(0.01 / m, 1.0 / (order + 1));
+    return std::fmin(100 * h0, h1);
+}
+
+// Called after every accepted step with the result so far; returning false ends
+// the integration there (hamzstlab_events.h uses this for terminal events), and
+// the result reports Stopped instead of Success.
+struct OdeNoObserver {
+    bool operator()(OdeResult&) { return true; }
+};
+
+template <class F, class Observer>
+OdeResult SolveOde(int method, const F& f, double t0, const double* y0, int n, double t1, const OdeOptions& opt, OdeWorkspace& ws, Observer& observe) {
+    OdeResult res;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const ButcherTableau& tab = OdeTableau(method);
+    const bool adaptive = tab.E != nullptr;
+    const double dir  = t1 >= t0 ? 1.0 : -1.0;
+    const double hmax = opt.HMax > 0 ? opt.HMax : std::fabs(t1 - t0);
+    res.Dim = n;
+    ws.Resize(n, tab.Stages);
+    std::vector<double> y(y0, y0 + n);
+    res.Ts.push_back(t0);
+    res.Ys.insert(res.Ys.end(), y.begin(), y.end());
+
+    double t = t0;
+    f(t, y.data(), ws.Stage(0));
+    res.Evaluations = 1;
+    if (opt.Dense) {
+        res.DenseDegree = tab.DenseDegree;
+        if (tab.DenseDegree == 0)
+            res.Dys.insert(res.Dys.end(), ws.Stage(0), ws.Stage(0) + n);
+    }
+    double h = opt.H > 0 ? opt.H : OdeInitialStep(f, t0, y0, ws.Stage(0), n, tab.Order, dir, opt, res.Evaluations);
+    h = std::fmin(h, hmax);
+    const double exponent = adaptive ? 1.0 / (tab.ErrorOrder + 1) : 0;
+
+    while (dir * (t1 - t) > 0) {
+        if (res.Steps + res.Rejected >= opt.MaxSteps) { res.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); return res; }
+        bool last = false;
+        if (h * (1 + 1e-9) >= std::fabs(t1 - t)) { h = std::fabs(t1 - t); last = true; }
+        RKStep(tab, f, t, y.data(), dir * h, ws, res.Evaluations);
+        if (adaptive) {
+            double err = OdeErrorNorm(y.data(), ws.YNew.data(), ws.Err.data(), n, opt);
+            double fac = err == 0 ? 5.0 : std::fmin(5.0, std::fmax(0.2, 0.9 * std::pow(err, -exponent)));
+            if (!(err <= 1)) {
+                ++res.Rejected;
+                h *= std::fmin(1.0, fac);
+                if (h < opt.HMin || !std::isfinite(err)) { res.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); return res; }
+                continue;
+            }
+            t = last ? t1 : t + dir * h;
+            if (opt.Dense && tab.DenseDegree > 0)
+                for (int i = 0; i < n; ++i)
+                    for (int j = 0; j < tab.DenseDegree; ++j) {
+                        double acc = 0;
+                        for (int s = 0; s < tab.Stages; ++s)
+                            acc += ws.K[(size_t)s * n + i] * tab.P[s * tab.DenseDegree + j];
+                        res.Q.push_back(acc);
+                    }
+            h = std::fmin(h * fac, hmax);
+        }
+        else {
+            t = last ? t1 : t + dir * h;
+        }
+        y.assign(ws.YNew.begin(), ws.YNew.end());
+        ++res.Steps;
+        res.Ts.push_back(t);
+        res.Ys.insert(res.Ys.end(), y.begin(), y.end());
+        if (tab.FSAL) {
+            std::copy(ws.Stage(tab.Stages - 1), ws.Stage(tab.Stages - 1) + n, ws.Stage(0));
+        }
+        else if (dir * (t1 - t) > 0 || opt.Dense) {
+            f(t, y.data(), ws.Stage(0));
+            ++res.Evaluations;
+        }
+        if (opt.Dense && tab.DenseDegree == 0)
+            res.Dys.insert(res.Dys.end(), ws.Stage(0), ws.Stage(0) + n);
+        if (!observe(res)) {
+            res.Stopped = true;
+            break;
+        }
+    }
+    res.Success = !res.Stopped;
+    res.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return res;
+}
+
+template <class F>
+OdeResult SolveOde(int method, const F& f, double t0, const double* y0, int n, double t1, const OdeOptions& opt, OdeWorkspace& ws) {
+    OdeNoObserver none;
+    return SolveOde(method, f, t0, y0, n, t1, opt, ws, none);
+}
+
+template <class F>
+OdeResult SolveOde(int method, const F& f, double t0, const double* y0, int n, double t1, const OdeOptions& opt = OdeOptions()) {
+    OdeWorkspace ws;
+    return SolveOde(method, f, t0, y0, n, t1, opt, ws);
+}
+
+} // namespace Hamzstlab
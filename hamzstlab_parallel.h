@@ -0,0 +1,83 @@
+// Hamzstlab Mathematics: thread pool helpers
+//
+// Uses the ThreadPool from implot-demos/3rdparty (the same one that drives
+// implot-demos/demos/mandel.cpp). Add implot-demos/3rdparty to the include path
+// and link with -pthread.
+//
+// ParallelFor splits [0,count) into chunks of `grain` items. Every worker, and
+// the calling thread, keeps pulling the next free chunk from a shared counter
+// until none are left, so threads that finish early take over the remaining
+// work of slower ones. Do not call ParallelFor from inside a pool task.
+//
+// Long jobs running on a background thread (a JobRunner worker) pass
+// GetBackgroundThreadPool() instead: their tasks then never sit in the queue
+// ahead of those of a ParallelFor on the UI thread, which would stall the
+// frame until the whole job is done.
+
+#pragma once
+
+#include "ThreadPool.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace Hamzstlab {
+
+inline int ThreadCount() {
+    unsigned int n = std::thread::hardware_concurrency();
+    return n > 0 ? (int)n : 4;
+}
+
+inline ThreadPool& GetThreadPool() {
+    static ThreadPool pool(ThreadCount() - 1 > 0 ? ThreadCount() - 1 : 1);
+    return pool;
+}
+
+// A second pool of the same size, for background jobs.
+inline ThreadPool& GetBackgroundThreadPool() {
+    static ThreadPool pool(ThreadCount() - 1 > 0 ? ThreadCount() - 1 : 1);
+    return pool;
+}
+
+// Calls fn(begin, end) for consecutive chunks of [0,count) on the threads of
+// `pool` and the calling thread. threads <= 0 uses all cores.
+template <class Fn>
+void ParallelFor(ThreadPool& pool, int count, int grain, const Fn& fn, int threads = 0) {
+    if (count <= 0)
+        return;
+    if (grain < 1)
+        grain = 1;
+    const int chunks = (count + grain - 1) / grain;
+    int workers = threads > 0 ? threads : ThreadCount();
+    if (workers > chunks)
+        workers = chunks;
+    if (workers <= 1) {
+        fn(0, count);
+        return;
+    }
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        for (;;) {
+            int c = next.fetch_add(1);
+            if (c >= chunks)
+                return;
+            int begin = c * grain;
+            int end   = begin + grain < count ? begin + grain : count;
+            fn(begin, end);
+        }
+    };
+    std::vector< std::future<void> > results;
+    results.reserve(workers - 1);
+    for (int i = 0; i < workers - 1; ++i)
+        results.push_back(pool.enqueue(work));
+    work();
+    for (size_t i = 0; i < results.size(); ++i)
+        results[i].wait();
+}
+
+template <class Fn>
+void ParallelFor(int count, int grain, const Fn& fn, int threads = 0) {
+    ParallelFor(GetThreadPool(), count, grain, fn, threads);
+}
+
+} // namespace Hamzstlab
@@ -0,0 +1,418 @@
+// Hamzstlab Mathematics: all complex roots of a real polynomial
+//
+// p(z) = c[0] + c[1] z + ... + c[n] z^n   (coefficients in ascending order)
+//
+// PolyRootSolver finds the n roots simultaneously with the Aberth-Ehrlich
+// iteration. Starting points come from the Newton polygon of the coefficients
+// (Bini), or from the previous roots when WarmStart is set, which is what makes
+// root-locus sweeps cheap: neighbouring coefficient sets converge in a couple of
+// iterations. If Aberth does not converge, the eigenvalues of the balanced
+// companion matrix (Hessenberg QR) are used and then polished by Aberth.
+//
+// The solver keeps its scratch buffers between calls; reuse one instance per
+// thread for repeated solves.
+
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace Hamzstlab {
+
+// ys[k] = p(xs[k]) for real points. The loop over points is innermost so the
+// compiler can vectorize it.
+inline void PolyEval(const double* c, int n, const double* xs, double* ys, int count) {
+    for (int k = 0; k < count; ++k)
+        ys[k] = c[n];
+    for (int j = n - 1; j >= 0; --j)
+        for (int k = 0; k < count; ++k)
+            ys[k] = ys[k] * xs[k] + c[j];
+}
+
+// p(z) and p'(z) at count complex points given in split real/imaginary arrays.
+inline void PolyEvalComplex(const double* c, int n, const double* zr, const double* zi, int count,
+                            double* pr, double* pi, double* dr, double* di) {
+    for (int k = 0; k < count; ++k) {
+        pr[k] = c[n]; pi[k] = 0;
+        dr[k] = 0;    di[k] = 0;
+    }
+    for (int j = n - 1; j >= 0; --j) {
+        const double cj = c[j];
+        for (int k = 0; k < count; ++k) {
+            // d = d*z + p ; p = p*z + c
+            double ndr = dr[k] * zr[k] - di[k] * zi[k] + pr[k];
+            double ndi = dr[k] * zi[k] + di[k] * zr[k] + pi[k];
+            double npr = pr[k] * zr[k] - pi[k] * zi[k] + cj;
+            double npi = pr[k] * zi[k] + pi[k] * zr[k];
+            dr[k] = ndr; di[k] = ndi;
+            pr[k] = npr; pi[k] = npi;
+        }
+    }
+}
+
+struct PolyRootOptions {
+    int    MaxIter;
+    double Tol;          // relative size of the last Aberth correction
+    bool   WarmStart;    // start from the roots passed in
+    bool   Fallback;     // use companion eigenvalues if Aberth fails
+    PolyRootOptions() { MaxIter = 100; Tol = 1e-14; WarmStart = false; Fallback = true; }
+};
+
+struct PolyRootStats {
+    int  Iterations;
+    bool Converged;
+    bool UsedFallback;
+    PolyRootStats() { Iterations = 0; Converged = false; UsedFallback = false; }
+};
+
+class PolyRootSolver {
+public:
+    // Writes the roots of the polynomial of the given degree to roots[0..degree-1]
+    // and returns how many there are (leading zero coefficients lower the degree).
+    int Solve(const double* coef, int degree, std::complex<double>* roots,
+              const PolyRootOptions& opt = PolyRootOptions(), PolyRootStats* stats = nullptr) {
+        PolyRootStats st;
+        int n = degree;
+        while (n > 0 && coef[n] == 0)
+            --n;
+        int zeros = 0;
+        while (zeros < n && coef[zeros] == 0)
+            ++zeros;
+        for (int i = 0; i < zeros; ++i)
+            roots[i] = 0;
+        const int m = n - zeros;
+        std::complex<double>* z = roots + zeros;
+        if (m == 1) {
+            z[0] = -coef[zeros] / coef[zeros + 1];
+            st.Converged = true;
+        }
+        else if (m > 1) {
+            Coef.assign(coef + zeros, coef + n + 1);
+            Rev.assign(Coef.rbegin(), Coef.rend());
+            if (!opt.WarmStart)
+                InitialGuess(m, z);
+            st.Converged = Aberth(m, z, opt, st.Iterations);
+            if (!st.Converged && opt.Fallback) {
+                st.UsedFallback = true;
+                if (CompanionEigenvalues(m, z)) {
+                    int polish = 0;
+                    PolyRootOptions popt = opt;
+                    popt.MaxIter = 10;
+                    st.Converged = Aberth(m, z, popt, polish);
+                    st.Iterations += polish;
+                }
+            }
+        }
+        else {
+            st.Converged = true;
+        }
+        if (stats)
+            *stats = st;
+        return n;
+    }
+
+private:
+    // Points on circles whose radii follow the upper convex hull of (i, log|c_i|).
+    void InitialGuess(int n, std::complex<double>* z) {
+        std::vector<int>&    hull = Hull;
+        std::vector<double>& lg   = LogAbs;
+        lg.resize(n + 1);
+        for (int i = 0; i <= n; ++i)
+            lg[i] = Coef[i] != 0 ? std::log(std::fabs(Coef[i])) : -1e300;
+        hull.clear();
+        for (int i = 0; i <= n; ++i) {
+            if (lg[i] <= -1e300)
+                continue;
+            while (hull.size() >= 2) {
+                int a = hull[hull.size() - 2], b = hull.back();
+                // drop b if it lies on or below the segment a -> i
+                if ((lg[b] - lg[a]) * (i - a) <= (lg[i] - lg[a]) * (b - a))
+                    hull.pop_back();
+                else
+                    break;
+            }
+            hull.push_back(i);
+        }
+        const double twopi = 6.283185307179586;
+        const double sigma = 0.7;
+        int k = 0;
+        for (size_t h = 0; h + 1 < hull.size(); ++h) {
+            int a = hull[h], b = hull[h + 1];
+            int cnt = b - a;
+            double r = std::exp((lg[a] - lg[b]) / cnt);
+            for (int j = 0; j < cnt; ++j, ++k) {
+                double ang = twopi * j / cnt + twopi * h / n + sigma;
+                z[k] = std::polar(r, ang);
+            }
+        }
+    }
+
+    bool Aberth(int n, std::complex<double>* z, const PolyRootOptions& opt, int& iterations) {
+        Active.assign(n, 1);
+        Zr.resize(n); Zi.resize(n);
+        Pr.resize(n); Pi.resize(n); Dr.resize(n); Di.resize(n);
+        Wr.resize(n); Wi.resize(n);
+        Ar.resize(n); Ai.resize(n);
+        Mod.resize(n); Scale.resize(n);
+        Idx.resize(n);
+        for (int it = 0; it < opt.MaxIter; ++it) {
+            iterations = it + 1;
+            // Newton ratios p/p' for the active roots, split by |z| <= 1 (forward
+            // Horner) and |z| > 1 (reversed coefficients in 1/z, avoids overflow).
+            int cnt_in = 0, cnt_out = 0;
+            for (int i = 0; i < n; ++i)
+                if (Active[i] && std::norm(z[i]) <= 1) Idx[cnt_in++] = i;
+            for (int i = 0; i < n; ++i)
+                if (Active[i] && std::norm(z[i]) > 1) Idx[cnt_in + cnt_out++] = i;
+            if (cnt_in + cnt_out == 0)
+                return true;
+            for (int k = 0; k < cnt_in; ++k) {
+                Zr[k] = z[Idx[k]].real(); Zi[k] = z[Idx[k]].imag();
+            }
+            for (int k = cnt_in; k < cnt_in + cnt_out; ++k) {
+                std::complex<double> y = 1.0 / z[Idx[k]];
+                Zr[k] = y.real(); Zi[k] = y.imag();
+            }
+            for (int i = 0; i < n; ++i) {
+                Ar[i] = z[i].real(); Ai[i] = z[i].imag();
+            }
+            PolyEvalComplex(Coef.data(), n, Zr.data(), Zi.data(), cnt_in, Pr.data(), Pi.data(), Dr.data(), Di.data());
+            PolyEvalComplex(Rev.data(), n, Zr.data() + cnt_in, Zi.data() + cnt_in, cnt_out,
+                            Pr.data() + cnt_in, Pi.data() + cnt_in, Dr.data() + cnt_in, Di.data() + cnt_in);
+            // sum_j |c_j| |z|^j, the size of p(z) when evaluated in floating point
+            const int cnt = cnt_in + cnt_out;
+            for (int k = 0; k < cnt; ++k)
+                Mod[k] = std::sqrt(Zr[k] * Zr[k] + Zi[k] * Zi[k]);
+            for (int k = 0; k < cnt_in; ++k)
+                Scale[k] = std::fabs(Coef[n]);
+            for (int k = cnt_in; k < cnt; ++k)
+                Scale[k] = std::fabs(Rev[n]);
+            for (int j = n - 1; j >= 0; --j) {
+                const double a = std::fabs(Coef[j]), b = std::fabs(Rev[j]);
+                for (int k = 0; k < cnt_in; ++k)
+                    Scale[k] = Scale[k] * Mod[k] + a;
+                for (int k = cnt_in; k < cnt; ++k)
+                    Scale[k] = Scale[k] * Mod[k] + b;
+            }
+            int still_active = 0;
+            for (int k = 0; k < cnt; ++k) {
+                const int i = Idx[k];
+                std::complex<double> p(Pr[k], Pi[k]), d(Dr[k], Di[k]), ratio;
+                if (k < cnt_in) {
+                    ratio = d != 0.0 ? p / d : std::complex<double>(0);
+                }
+                else {
+                    // p/p' = z / (n - y q'(y)/q(y)) with y = 1/z
+                    std::complex<double> y(Zr[k], Zi[k]);
+                    std::complex<double> den = p != 0.0 ? (double)n - y * d / p : std::complex<double>(1e300);
+                    ratio = z[i] / den;
+                }
+                if (std::abs(p) <= 4e-16 * Scale[k]) {
+                    // p(z) is at rounding level: z cannot be improved further
+                    Wr[k] = 0; Wi[k] = 0;
+                    continue;
+                }
+                // sum over j != i of 1/(z_i - z_j)
+                const double xr = Ar[i], xi = Ai[i];
+                double sr = 0, si = 0;
+                for (int j = 0; j < i; ++j) {
+                    double er = xr - Ar[j], ei = xi - Ai[j], inv = 1 / (er * er + ei * ei);
+                    sr += er * inv; si -= ei * inv;
+                }
+                for (int j = i + 1; j < n; ++j) {
+                    double er = xr - Ar[j], ei = xi - Ai[j], inv = 1 / (er * er + ei * ei);
+                    sr += er * inv; si -= ei * inv;
+                }
+                std::complex<double> sum(sr, si);
+                std::complex<double> w = ratio / (1.0 - ratio * sum);
+                Wr[k] = w.real(); Wi[k] = w.imag();
+            }
+            for (int k = 0; k < cnt; ++k) {
+                const int i = Idx[k];
+                std::complex<double> w(Wr[k], Wi[k]);
+                z[i] -= w;
+                if (w == 0.0 || std::abs(w) <= opt.Tol * std::abs(z[i]) || !std::isfinite(z[i].real()) || !std::isfinite(z[i].imag()))
+                    Active[i] = 0;
+                else
+                    ++still_active;
+            }
+            if (still_active == 0)
+                break;
+        }
+        for (int i = 0; i < n; ++i)
+            if (Active[i] || !std::isfinite(z[i].real()) || !std::isfinite(z[i].imag()))
+                return false;
+        return true;
+    }
+
+    // Eigenvalues of the balanced companion matrix by the shifted Hessenberg QR
+    // algorithm (hqr/balanc as in Numerical Recipes, 1-based storage).
+    bool CompanionEigenvalues(int n, std::complex<double>* z) {
+        const int N = n + 1;
+        H.assign((size_t)N * N, 0.0);
+        double* A = H.data();
+        #define HZ_A(i,j) A[(size_t)(i) * N + (j)]
+        for (int k = 1; k <= n; ++k) {
+            HZ_A(1, k) = -Coef[n - k] / Coef[n];
+            if (k != n) HZ_A(k + 1, k) = 1.0;
+        }
+        // balance
+        const double radix = 2.0, sqrdx = radix * radix;
+        bool done = false;
+        while (!done) {
+            done = true;
+            for (int i = 1; i <= n; ++i) {
+                double r = 0, c = 0;
+                for (int j = 1; j <= n; ++j)
+                    if (j != i) {
+                        c += std::fabs(HZ_A(j, i));
+                        r += std::fabs(HZ_A(i, j));
+                    }
+                if (c != 0 && r != 0) {
+                    double g = r / radix, f = 1.0, s = c + r;
+                    while (c < g) { f *= radix; c *= sqrdx; }
+                    g = r * radix;
+                    while (c > g) { f /= radix; c /= sqrdx; }
+                    if ((c + r) / f < 0.95 * s) {
+                        done = false;
+                        g = 1.0 / f;
+                        for (int j = 1; j <= n; ++j) HZ_A(i, j) *= g;
+                        for (int j = 1; j <= n; ++j) HZ_A(j, i) *= f;
+                    }
+                }
+            }
+        }
+        // hqr
+        double anorm = 0;
+        for (int i = 1; i <= n; ++i)
+            for (int j = (i - 1 > 1 ? i - 1 : 1); j <= n; ++j)
+                anorm += std::fabs(HZ_A(i, j));
+        int nn = n, l = 1, m = 1;
+        double t = 0, p = 0, q = 0, r = 0, s, w, x, y, zz;
+        while (nn >= 1) {
+            int its = 0;
+            do {
+                for (l = nn; l >= 2; --l) {
+                    s = std::fabs(HZ_A(l - 1, l - 1)) + std::fabs(HZ_A(l, l));
+                    if (s == 0) s = anorm;
+                    if (std::fabs(HZ_A(l, l - 1)) + s == s) {
+                        HZ_A(l, l - 1) = 0;
+                        break;
+                    }
+                }
+                x = HZ_A(nn, nn);
+                if (l == nn) {
+                    z[nn - 1] = std::complex<double>(x + t, 0);
+                    --nn;
+                }
+                else {
+                    y = HZ_A(nn - 1, nn - 1);
+                    w = HZ_A(nn, nn - 1) * HZ_A(nn - 1, nn);
+                    if (l == nn - 1) {
+                        p = 0.5 * (y - x);
+                        q = p * p + w;
+                        zz = std::sqrt(std::fabs(q));
+                        x += t;
+                        if (q >= 0) {
+                            zz = p + (p >= 0 ? std::fabs(zz) : -std::fabs(zz));
+                            double r1 = x + zz, r2 = zz != 0 ? x - w / zz : x + zz;
+                            z[nn - 2] = std::complex<double>(r1, 0);
+                            z[nn - 1] = std::complex<double>(r2, 0);
+                        }
+                        else {
+                            z[nn - 2] = std::complex<double>(x + p, -zz);
+                            z[nn - 1] = std::complex<double>(x + p, zz);
+                        }
+                        nn -= 2;
+                    }
+                    else {
+                        if (its == 60)
+                            return false;
+                        if (its == 10 || its == 20) {
+                            t += x;
+                            for (int i = 1; i <= nn; ++i) HZ_A(i, i) -= x;
+                            s = std::fabs(HZ_A(nn, nn - 1)) + std::fabs(HZ_A(nn - 1, nn - 2));
+                            y = x = 0.75 * s;
+                            w = -0.4375 * s * s;
+                        }
+                        ++its;
+                        for (m = nn - 2; m >= l; --m) {
+                            zz = HZ_A(m, m);
+                            r = x - zz;
+                            s = y - zz;
+                            p = (r * s - w) / HZ_A(m + 1, m) + HZ_A(m, m + 1);
+                            q = HZ_A(m + 1, m + 1) - zz - r - s;
+                            r = HZ_A(m + 2, m + 1);
+                            s = std::fabs(p) + std::fabs(q) + std::fabs(r);
+                            p /= s; q /= s; r /= s;
+                            if (m == l) break;
+                            double u = std::fabs(HZ_A(m, m - 1)) * (std::fabs(q) + std::fabs(r));
+                            double v = std::fabs(p) * (std::fabs(HZ_A(m - 1, m - 1)) + std::fabs(zz) + std::fabs(HZ_A(m + 1, m + 1)));
+                            if (u + v == v) break;
+                        }
+                        for (int i = m + 2; i <= nn; ++i) {
+                            HZ_A(i, i - 2) = 0;
+                            if (i != m + 2) HZ_A(i, i - 3) = 0;
+                        }
+                        for (int k = m; k <= nn - 1; ++k) {
+                            if (k != m) {
+                                p = HZ_A(k, k - 1);
+                                q = HZ_A(k + 1, k - 1);
+                                r = 0;
+                                if (k != nn - 1) r = HZ_A(k + 2, k - 1);
+                                if ((x = std::fabs(p) + std::fabs(q) + std::fabs(r)) != 0) {
+                                    p /= x; q /= x; r /= x;
+                                }
+                            }
+                            double sq = std::sqrt(p * p + q * q + r * r);
+                            if ((s = (p >= 0 ? sq : -sq)) != 0) {
+                                if (k == m) {
+                                    if (l != m) HZ_A(k, k - 1) = -HZ_A(k, k - 1);
+                                }
+                                else {
+                                    HZ_A(k, k - 1) = -s * x;
+                                }
+                                p += s;
+                                x = p / s;
+                                y = q / s;
+                                zz = r / s;
+                                q /= p;
+                                r /= p;
+                                for (int j = k; j <= nn; ++j) {
+                                    p = HZ_A(k, j) + q * HZ_A(k + 1, j);
+                                    if (k != nn - 1) {
+                                        p += r * HZ_A(k + 2, j);
+                                        HZ_A(k + 2, j) -= p * zz;
+                                    }
+                                    HZ_A(k + 1, j) -= p * y;
+                                    HZ_A(k, j) -= p * x;
+                                }
+                                int mmin = nn < k + 3 ? nn : k + 3;
+                                for (int i = l; i <= mmin; ++i) {
+                                    p = x * HZ_A(i, k) + y * HZ_A(i, k + 1);
+                                    if (k != nn - 1) {
+                                        p += zz * HZ_A(i, k + 2);
+                                        HZ_A(i, k + 2) -= p * r;
+                                    }
+                                    HZ_A(i, k + 1) -= p * q;
+                                    HZ_A(i, k) -= p;
+                                }
+                            }
+                        }
+                    }
+                }
+            } while (l < nn - 1);
+        }
+        #undef HZ_A
+        return true;
+    }
+
+    std::vector<double> Coef, Rev, LogAbs;
+    std::vector<int>    Hull, Idx;
+    std::vector<char>   Active;
+    std::vector<double> Zr, Zi, Pr, Pi, Dr, Di, Wr, Wi, Ar, Ai, Mod, Scale;
+    std::vector<double> H;
+};
+
+} // namespace Hamzstlab
@@ -0,0 +1,329 @@
+// Hamzstlab Mathematics: numerical integration of f over [a,b]
+//
+// The integrand is written once as a template so that its nodes are evaluated
+// four at a time on Vec4d lanes (see hamzstlab_simd.h):
+//
+//   struct Gauss { template <typename T> T operator()(const T& x) const { using std::exp; return exp(-x * x); } };
+//   Hamzstlab::QuadratureOptions opt;                 // AbsTol, RelTol, ...
+//   Hamzstlab::QuadratureResult r = Hamzstlab::GaussKronrod(Gauss(), 0.0, 3.0, opt);
+//   printf("%.15f +- %g after %lld evaluations\n", r.Value, r.Error, r.Evaluations);
+//
+// Simpson and Romberg halve a uniform panel width until two successive
+// estimates agree to the tolerance. Every level only evaluates the new
+// midpoints: the trapezoid sum of the previous level is reused, and Romberg
+// extends its Richardson tableau by one row per level instead of rebuilding
+// it. GaussKronrod is adaptive: each segment gets a 15-point Kronrod rule with
+// its embedded 7-point Gauss rule, and the segment with the largest error
+// estimate (kept on top of a priority queue) is bisected until the total error
+// is below the tolerance. Evaluations are spent where f is hard, which matters
+// when f is expensive. The final segments are returned for plotting.
+
+#pragma once
+
+#include "hamzstlab_simd.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <vector>
+
+namespace Hamzstlab {
+
+enum QuadratureMethod {
+    QuadratureMethod_Simpson,
+    QuadratureMethod_Romberg,
+    QuadratureMethod_GaussKronrod,
+    QuadratureMethod_COUNT
+};
+
+inline const char* QuadratureMethodName(int method) {
+    static const char* names[] = { "Simpson", "Romberg", "Gauss-Kronrod (G7K15)" };
+    return method >= 0 && method < QuadratureMethod_COUNT ? names[method] : "";
+}
+
+struct QuadratureOptions {
+    double AbsTol;
+    double RelTol;
+    int    MaxLevels;      // Simpson and Romberg: at most 2^MaxLevels panels
+    int    MaxSegments;    // Gauss-Kronrod
+    QuadratureOptions(double abs_tol = 1e-10, double rel_tol = 1e-10) {
+        AbsTol = abs_tol; RelTol = rel_tol; MaxLevels = 20; MaxSegments = 2000;
+    }
+};
+
+struct QuadratureSegment {
+    double A, B;
+    double Value;
+    double Error;
+    bool operator<(const QuadratureSegment& o) const { return Error < o.Error; }
+};
+
+struct QuadratureResult {
+    double    Value;
+    double    Error;          // estimated absolute error
+    long long Evaluations;
+    double    Seconds;
+    bool      Converged;
+    int       Levels;                          // Simpson, Romberg: 2^Levels panels
+    std::vector<double>            Tableau;    // Romberg: R(k, j) at k (k + 1) / 2 + j
+    std::vector<QuadratureSegment> Segments;   // Gauss-Kronrod, sorted by A
+    QuadratureResult() { Value = Error = 0; Evaluations = 0; Seconds = 0; Converged = false; Levels = 0; }
+    double RombergAt(int k, int j) const { return Tableau[(size_t)k * (k + 1) / 2 + j]; }
+};
+
+// y[i] = f(x[i]) for i in [0, n), four nodes per call, the way the rules below
+// evaluate f; also for plotting an integrand. Unused lanes of the last call
+// repeat the last node so that f never sees a point outside the caller's set.
+template <class F>
+void QuadratureEval(const F& f, const double* x, double* y, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        f(Vec4d::Load(x + i)).Store(y + i);
+    if (i < n) {
+        double xs[4], ys[4];
+        for (int l = 0; l < 4; ++l)
+            xs[l] = x[i + l < n ? i + l : n - 1];
+        f(Vec4d::Load(xs)).Store(ys);
+        for (int l = 0; i + l < n; ++l)
+            y[i + l] = ys[l];
+    }
+}
+
+namespace detail {
+
+typedef std::chrono::steady_clock QuadratureClock;
+
+inline double QuadratureTol(const QuadratureOptions& opt, double value) {
+    return std::max(opt.AbsTol, opt.RelTol * std::fabs(value));
+}
+
+// Sum of f(a + (2i + 1) h), i = 0..count: the midpoints added when the panel
+// width of a trapezoid sum halves to h.
+template <class F>
+double MidpointSum(const F& f, double a, double h, long long count) {
+    double x[64], y[64], sum = 0;
+    for (long long i = 0; i < count; i += 64) {
+        const int m = (int)std::min<long long>(64, count - i);
+        for (int j = 0; j < m; ++j)
+            x[j] = a + (2 * (i + j) + 1) * h;
+        QuadratureEval(f, x, y, m);
+        for (int j = 0; j < m; ++j)
+            sum += y[j];
+    }
+    return sum;
+}
+
+// One step of trapezoid refinement: T(h/2) from T(h), 2^(level - 1) new nodes.
+template <class F>
+double RefineTrapezoid(const F& f, double a, double b, int level, double t, long long& evaluations) {
+    const long long added = 1LL << (level - 1);
+    const double h = (b - a) / (2 * added);
+    evaluations += added;
+    return 0.5 * t + h * MidpointSum(f, a, h, added);
+}
+
+// QUADPACK's 15-point Kronrod nodes on [-1, 1] (by symmetry, the positive half)
+// and weights, with the weights of the embedded 7-point Gauss rule.
+struct Kronrod15 {
+    double X[8], WK[8], WG[8];
+    Kronrod15() {
+        static const double x[8]  = { 0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+                                      0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+                                      0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+                                      0.207784955007898467600689403773245, 0.000000000000000000000000000000000 };
+        static const double wk[8] = { 0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+                                      0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+                                      0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+                                      0.204432940075298892414161999234649, 0.209482141084727828012999174891714 };
+        static const double wg[8] = { 0, 0.129484966168869693270611432679082, 0, 0.279705391489276667901467771423780,
+                                      0, 0.381830050505118944950369775488975, 0, 0.417959183673469387755102040816327 };
+        for (int i = 0; i < 8; ++i) { X[i] = x[i]; WK[i] = wk[i]; WG[i] = wg[i]; }
+    }
+};
+
+// Applies G7K15 to `count` segments at once; their 15 * count nodes go to f
+// in groups of four. The error estimate is QUADPACK's (QK15).
+template <class F>
+void KronrodSegments(const F& f, QuadratureSegment* segs, int count) {
+    static const Kronrod15 rule;
+    double x[32] = { 0 }, y[32];
+    for (int s = 0; s < count; ++s) {
+        const double c = 0.5 * (segs[s].A + segs[s].B), h = 0.5 * (segs[s].B - segs[s].A);
+        double* xs = x + 15 * s;
+        xs[0] = c;
+        for (int i = 0; i < 7; ++i) {
+            xs[1 + 2 * i] = c - h * rule.X[i];
+            xs[2 + 2 * i] = c + h * rule.X[i];
+        }
+    }
+    QuadratureEval(f, x, y, 15 * count);
+    for (int s = 0; s < count; ++s) {
+        const double h = 0.5 * (segs[s].B - segs[s].A);
+        const double* ys = y + 15 * s;
+        double k = rule.WK[7] * ys[0], g = rule.WG[7] * ys[0], abs_sum = rule.WK[7] * std::fabs(ys[0]);
+        for (int i = 0; i < 7; ++i) {
+            const double pair = ys[1 + 2 * i] + ys[2 + 2 * i];
+            k += rule.WK[i] * pair;
+            g += rule.WG[i] * pair;
+            abs_sum += rule.WK[i] * (std::fabs(ys[1 + 2 * i]) + std::fabs(ys[2 + 2 * i]));
+        }
+        const double mean = 0.5 * k;
+        double asc = rule.WK[7] * std::fabs(ys[0] - mean);
+        for (int i = 0; i < 7; ++i)
+            asc += rule.WK[i] * (std::fabs(ys[1 + 2 * i] - mean) + std::fabs(ys[2 + 2 * i] - mean));
+        const double abs_h = std::fabs(h);
+        const double resabs = abs_sum * abs_h, resasc = asc * abs_h;
+        double err = std::fabs((k - g) * h);
+        if (resasc != 0 && err != 0)
+            err = resasc * std::min(1.0, std::pow(200 * err / resasc, 1.5));
+        const double eps = std::numeric_limits<double>::epsilon();
+        if (resabs > std::numeric_limits<double>::min() / (50 * eps))
+            err = std::max(50 * eps * resabs, err);
+        segs[s].Value = k * h;
+        // a NaN or inf anywhere in the segment keeps it at the top of the queue
+        segs[s].Error = err == err ? err : HUGE_VAL;
+    }
+}
+
+} // namespace detail
+
+// Composite Simpson's rule with n panels (rounded up to even), no error estimate.
+template <class F>
+double CompositeSimpson(const F& f, double a, double b, int n) {
+    n += n & 1;
+    const double h = (b - a) / n;
+    std::vector<double> x(n + 1), y(n + 1);
+    for (int i = 0; i <= n; ++i)
+        x[i] = a + i * h;
+    x[n] = b;
+    QuadratureEval(f, x.data(), y.data(), n + 1);
+    double odd = 0, even = 0;
+    for (int i = 1; i < n; i += 2) odd += y[i];
+    for (int i = 2; i < n; i += 2) even += y[i];
+    return h / 3 * (y[0] + 4 * odd + 2 * even + y[n]);
+}
+
+// Simpson's rule with the panel count doubled until |S(h) - S(2h)| / 15, the
+// Richardson estimate of the error of S(h), is below the tolerance.
+template <class F>
+QuadratureResult Simpson(const F& f, double a, double b, const QuadratureOptions& opt = QuadratureOptions()) {
+    QuadratureResult res;
+    detail::QuadratureClock::time_point start = detail::QuadratureClock::now();
+    double ends[2] = { a, b }, fs[2];
+    QuadratureEval(f, ends, fs, 2);
+    res.Evaluations = 2;
+    double t = 0.5 * (b - a) * (fs[0] + fs[1]), s = t;
+    for (int k = 1; k <= opt.MaxLevels; ++k) {
+        const double t1 = detail::RefineTrapezoid(f, a, b, k, t, res.Evaluations);
+        const double s1 = (4 * t1 - t) / 3;
+        res.Value = s1;
+        res.Levels = k;
+        if (k > 1) {
+            res.Error = std::fabs(s1 - s) / 15;
+            // at least 8 panels, so that a few nodes landing on zeros of f cannot fake agreement
+            if (k >= 3 && res.Error <= detail::QuadratureTol(opt, s1)) {
+                res.Converged = true;
+                break;
+            }
+        }
+        t = t1;
+        s = s1;
+    }
+    res.Seconds = std::chrono::duration<double>(detail::QuadratureClock::now() - start).count();
+    return res;
+}
+
+// Romberg integration: row k of the tableau starts with the trapezoid sum of
+// 2^k panels and R(k, j) = R(k, j-1) + (R(k, j-1) - R(k-1, j-1)) / (4^j - 1).
+// Stops when the diagonal entries R(k, k) and R(k-1, k-1) agree.
+template <class F>
+QuadratureResult Romberg(const F& f, double a, double b, const QuadratureOptions& opt = QuadratureOptions()) {
+    QuadratureResult res;
+    detail::QuadratureClock::time_point start = detail::QuadratureClock::now();
+    double ends[2] = { a, b }, fs[2];
+    QuadratureEval(f, ends, fs, 2);
+    res.Evaluations = 2;
+    res.Tableau.push_back(0.5 * (b - a) * (fs[0] + fs[1]));
+    res.Value = res.Tableau[0];
+    for (int k = 1; k <= opt.MaxLevels; ++k) {
+        const size_t prev = (size_t)(k - 1) * k / 2, row = prev + k;
+        res.Tableau.push_back(detail::RefineTrapezoid(f, a, b, k, res.Tableau[prev], res.Evaluations));
+        double factor = 1;
+        for (int j = 1; j <= k; ++j) {
+            factor *= 4;
+            const double r = res.Tableau[row + j - 1];
+            res.Tableau.push_back(r + (r - res.Tableau[prev + j - 1]) / (factor - 1));
+        }
+        res.Value = res.Tableau[row + k];
+        res.Error = std::fabs(res.Value - res.Tableau[prev + k - 1]);
+        res.Levels = k;
+        if (k >= 3 && res.Error <= detail::QuadratureTol(opt, res.Value)) {
+            res.Converged = true;
+            break;
+        }
+    }
+    res.Seconds = std::chrono::duration<double>(detail::QuadratureClock::now() - start).count();
+    return res;
+}
+
+// Adaptive G7K15: the segment with the largest error estimate is bisected
+// until the sum of the estimates meets the tolerance.
+template <class F>
+QuadratureResult GaussKronrod(const F& f, double a, double b, const QuadratureOptions& opt = QuadratureOptions()) {
+    QuadratureResult res;
+    detail::QuadratureClock::time_point start = detail::QuadratureClock::now();
+    QuadratureSegment whole = { a, b, 0, 0 };
+    detail::KronrodSegments(f, &whole, 1);
+    res.Evaluations = 15;
+    std::priority_queue<QuadratureSegment> queue;
+    queue.push(whole);
+    double value = whole.Value, error = whole.Error;
+    while (!(error <= detail::QuadratureTol(opt, value)) && (int)queue.size() < opt.MaxSegments) {
+        QuadratureSegment worst = queue.top();
+        const double mid = 0.5 * (worst.A + worst.B);
+        // no room left between A and B: further bisection cannot help
+        if (!(mid > std::min(worst.A, worst.B) && mid < std::max(worst.A, worst.B)))
+            break;
+        queue.pop();
+        QuadratureSegment halves[2] = { { worst.A, mid, 0, 0 }, { mid, worst.B, 0, 0 } };
+        detail::KronrodSegments(f, halves, 2);
+        res.Evaluations += 30;
+        value += halves[0].Value + halves[1].Value - worst.Value;
+        error += halves[0].Error + halves[1].Error - worst.Error;
+        queue.push(halves[0]);
+        queue.push(halves[1]);
+        // the running error sum accumulates roundoff (and inf - inf): resum it now and then
+        if (queue.size() % 64 == 0 || !(error < HUGE_VAL)) {
+            std::priority_queue<QuadratureSegment> copy = queue;
+            value = error = 0;
+            for (; !copy.empty(); copy.pop()) {
+                value += copy.top().Value;
+                error += copy.top().Error;
+            }
+        }
+    }
+    res.Segments.reserve(queue.size());
+    for (value = error = 0; !queue.empty(); queue.pop()) {
+        res.Segments.push_back(queue.top());
+        value += queue.top().Value;
+        error += queue.top().Error;
+    }
+    std::sort(res.Segments.begin(), res.Segments.end(), [](const QuadratureSegment& l, const QuadratureSegment& r) { return l.A < r.A; });
+    res.Value = value;
+    res.Error = error;
+    res.Converged = error <= detail::QuadratureTol(opt, value);
+    res.Seconds = std::chrono::duration<double>(detail::QuadratureClock::now() - start).count();
+    return res;
+}
+
+template <class F>
+QuadratureResult Integrate(int method, const F& f, double a, double b, const QuadratureOptions& opt = QuadratureOptions()) {
+    switch (method) {
+    case QuadratureMethod_Simpson: return Simpson(f, a, b, opt);
+    case QuadratureMethod_Romberg: return Romberg(f, a, b, opt);
+    default:                       return GaussKronrod(f, a, b, opt);
+    }
+}
+
+} // namespace Hamzstlab
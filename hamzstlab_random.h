@@ -0,0 +1,433 @@
+// Hamzstlab Mathematics: random numbers for plots and parallel Monte Carlo
+//
+// Engines (no global state; one per thread or per task):
+//
+//   Xoshiro256pp     xoshiro256++ (Blackman & Vigna), 64 bits per call, Jump()
+//                    for 2^128 non-overlapping streams
+//   Xoshiro256ppx4   four jumped xoshiro256++ lanes stepped together; its Fill
+//                    is plain lane-wise code that the compiler vectorizes
+//   PhiloxEngine     Philox4x32-10 (Salmon et al., SC 2011) as a stream
+//
+// Philox is counter-based: a keyed bijection maps a 128-bit counter to 128
+// random bits, so the n-th number of any stream is computed directly instead
+// of by stepping a shared state. A Monte Carlo path that draws its numbers
+// from (seed, path, step) gets the same numbers whichever thread runs it and
+// in whatever order, which makes parallel results reproducible for any thread
+// count:
+//
+//   double z[4];
+//   Hamzstlab::PhiloxNormals4(seed, path, step / 4, z);   // 4 N(0,1) numbers
+//
+// Distributions take any engine with `uint64_t operator()()` and
+// `void Fill(uint64_t* out, size_t n)`. Normal and exponential variates use
+// the ziggurat method (Marsaglia & Tsang 2000, in Doornik's layout): one
+// 64-bit word gives the layer, the sign and the abscissa, and 99% of draws
+// are accepted with one multiply and one compare. The bulk versions fill
+// millions of variates per call from a vectorized block of raw bits:
+//
+//   std::vector<double> xs(1000000);
+//   Hamzstlab::Xoshiro256ppx4 rng(seed);
+//   Hamzstlab::FillNormal(rng, xs.data(), xs.size(), mean, sd);
+//
+// ThreadEngine() is a per-thread, automatically seeded engine for code that
+// used rand(): Hamzstlab::Normal(Hamzstlab::ThreadEngine()).
+//
+// PhiloxNormals4 keeps the Box-Muller transform: every pair of words maps to
+// one pair of normals, so a path's numbers never depend on a rejection.
+
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace Hamzstlab {
+
+// One Philox4x32-10 block: out = Philox(key, ctr).
+inline void Philox4x32_10(const uint32_t ctr[4], const uint32_t key[2], uint32_t out[4]) {
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+    uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+        const uint64_t p0 = (uint64_t)M0 * c0, p1 = (uint64_t)M1 * c2;
+        const uint32_t hi0 = (uint32_t)(p0 >> 32), lo0 = (uint32_t)p0;
+        const uint32_t hi1 = (uint32_t)(p1 >> 32), lo1 = (uint32_t)p1;
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += W0;
+        k1 += W1;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+// 128 random bits for counter (index, stream) under a 64-bit seed.
+inline void PhiloxBits(uint64_t seed, uint64_t stream, uint64_t index, uint32_t out[4]) {
+    const uint32_t ctr[4] = { (uint32_t)index, (uint32_t)(index >> 32), (uint32_t)stream, (uint32_t)(stream >> 32) };
+    const uint32_t key[2] = { (uint32_t)seed, (uint32_t)(seed >> 32) };
+    Philox4x32_10(ctr, key, out);
+}
+
+// PhiloxBits for streams first .. first + count - 1 into out[4 * count]. The
+// blocks are independent, so the loop keeps several of them in flight.
+inline void PhiloxBitsN(uint64_t seed, uint64_t first, uint64_t index, int count, uint32_t* out) {
+    for (int i = 0; i < count; ++i)
+        PhiloxBits(seed, first + i, index, out + 4 * (size_t)i);
+}
+
+// Uniform on the open interval (0,1).
+inline double UniformOpen(uint32_t u) { return (u + 0.5) * (1.0 / 4294967296.0); }
+
+// Two independent N(0,1) numbers from two uniform 32-bit words (Box-Muller).
+inline void BoxMuller(uint32_t a, uint32_t b, double& z0, double& z1) {
+    const double r = std::sqrt(-2 * std::log(UniformOpen(a)));
+    const double theta = 6.283185307179586 * UniformOpen(b);
+    z0 = r * std::cos(theta);
+    z1 = r * std::sin(theta);
+}
+
+// Four N(0,1) numbers from four words.
+inline void Normals4(const uint32_t u[4], double z[4]) {
+    BoxMuller(u[0], u[1], z[0], z[1]);
+    BoxMuller(u[2], u[3], z[2], z[3]);
+}
+
+// Four N(0,1) numbers, a pure function of (seed, stream, index).
+inline void PhiloxNormals4(uint64_t seed, uint64_t stream, uint64_t index, double z[4]) {
+    uint32_t u[4];
+    PhiloxBits(seed, stream, index, u);
+    Normals4(u, z);
+}
+
+//-----------------------------------------------------------------------------
+// Engines
+
+inline uint64_t SplitMix64(uint64_t& x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t Rotl64(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+class Xoshiro256pp {
+public:
+    typedef uint64_t result_type;
+    static uint64_t min() { return 0; }
+    static uint64_t max() { return ~(uint64_t)0; }
+
+    explicit Xoshiro256pp(uint64_t seed = 0) { Seed(seed); }
+
+    // The state is expanded from the seed with SplitMix64, as recommended.
+    void Seed(uint64_t seed) {
+        for (int i = 0; i < 4; ++i)
+            S[i] = SplitMix64(seed);
+    }
+
+    uint64_t operator()() {
+        const uint64_t result = Rotl64(S[0] + S[3], 23) + S[0];
+        const uint64_t t = S[1] << 17;
+        S[2] ^= S[0];
+        S[3] ^= S[1];
+        S[1] ^= S[2];
+        S[0] ^= S[3];
+        S[2] ^= t;
+        S[3] = Rotl64(S[3], 45);
+        return result;
+    }
+
+    void Fill(uint64_t* out, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = (*this)();
+    }
+
+    // Advances the state by 2^128 calls.
+    void Jump() {
+        static const uint64_t jump[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+        uint64_t s[4] = { 0, 0, 0, 0 };
+        for (int i = 0; i < 4; ++i)
+            for (int b = 0; b < 64; ++b) {
+                if (jump[i] & ((uint64_t)1 << b))
+                    for (int k = 0; k < 4; ++k) s[k] ^= S[k];
+                (*this)();
+            }
+        for (int k = 0; k < 4; ++k) S[k] = s[k];
+    }
+
+    uint64_t S[4];
+};
+
+class Xoshiro256ppx4 {
+public:
+    typedef uint64_t result_type;
+    static uint64_t min() { return 0; }
+    static uint64_t max() { return ~(uint64_t)0; }
+
+    explicit Xoshiro256ppx4(uint64_t seed = 0) { Seed(seed); }
+
+    // Lane k is Xoshiro256pp(seed) jumped k times.
+    void Seed(uint64_t seed) {
+        Xoshiro256pp g(seed);
+        for (int k = 0; k < 4; ++k) {
+            for (int i = 0; i < 4; ++i) S[i][k] = g.S[i];
+            g.Jump();
+        }
+        Used = 4;
+    }
+
+    uint64_t operator()() {
+        if (Used == 4) {
+            Next4(Buffer);
+            Used = 0;
+        }
+        return Buffer[Used++];
+    }
+
+    // out[4i + k] is the i-th output of lane k.
+    void Fill(uint64_t* out, size_t n) {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            Next4(out + i);
+        for (; i < n; ++i)
+            out[i] = (*this)();
+    }
+
+private:
+    uint64_t S[4][4];      // S[word][lane]
+    uint64_t Buffer[4];
+    int      Used;
+
+    void Next4(uint64_t* out) {
+        for (int k = 0; k < 4; ++k) {
+            out[k] = Rotl64(S[0][k] + S[3][k], 23) + S[0][k];
+            const uint64_t t = S[1][k] << 17;
+            S[2][k] ^= S[0][k];
+            S[3][k] ^= S[1][k];
+            S[1][k] ^= S[2][k];
+            S[0][k] ^= S[3][k];
+            S[2][k] ^= t;
+            S[3][k] = Rotl64(S[3][k], 45);
+        }
+    }
+};
+
+// Philox4x32-10 read sequentially from counter 0 of one stream.
+class PhiloxEngine {
+public:
+    typedef uint64_t result_type;
+    static uint64_t min() { return 0; }
+    static uint64_t max() { return ~(uint64_t)0; }
+
+    explicit PhiloxEngine(uint64_t seed = 0, uint64_t stream = 0) { Seed(seed, stream); }
+
+    void Seed(uint64_t seed, uint64_t stream = 0) { Key = seed; Stream = stream; Counter = 0; Used = 2; }
+
+    uint64_t operator()() {
+        if (Used == 2) {
+            uint32_t u[4];
+            PhiloxBits(Key, Stream, Counter++, u);
+            Buffer[0] = ((uint64_t)u[1] << 32) | u[0];
+            Buffer[1] = ((uint64_t)u[3] << 32) | u[2];
+            Used = 0;
+        }
+        return Buffer[Used++];
+    }
+
+    void Fill(uint64_t* out, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = (*this)();
+    }
+
+private:
+    uint64_t Key, Stream, Counter;
+    uint64_t Buffer[2];
+    int      Used;
+};
+
+// A Xoshiro256ppx4 per thread, seeded differently for every thread that asks.
+inline Xoshiro256ppx4& ThreadEngine() {
+    static std::atomic<uint64_t> next_seed(0x5DEECE66Dull);
+    thread_local Xoshiro256ppx4 engine(next_seed.fetch_add(0x9E3779B97F4A7C15ull));
+    return engine;
+}
+
+//-----------------------------------------------------------------------------
+// Distributions
+
+// [0,1) with 52 random bits: the top bits become the mantissa of a double in
+// [1,2), which needs no integer to float conversion and vectorizes.
+inline double Uniform01(uint64_t r) {
+    const uint64_t bits = (r >> 12) | 0x3FF0000000000000ull;
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d - 1.0;
+}
+
+namespace detail {
+
+// Ziggurat of C layers for a decreasing density f on [0, inf) with tail
+// start R and layer area V. X[i] are the layer edges (X[0] = V / f(R) covers
+// the tail), Q[i] = X[i+1] / X[i] the part of layer i that is surely under f.
+template <int C>
+struct ZigguratTable {
+    double X[C + 1], Q[C], F[C + 1];
+    template <class Fn, class Inv>
+    void Build(double R, double V, Fn f, Inv inverse) {
+        X[0] = V / f(R);
+        X[1] = R;
+        X[C] = 0;
+        for (int i = 2; i < C; ++i)
+            X[i] = inverse(f(X[i - 1]) + V / X[i - 1]);
+        for (int i = 0; i <= C; ++i) F[i] = f(X[i]);
+        for (int i = 0; i < C; ++i) Q[i] = X[i + 1] / X[i];
+    }
+};
+
+inline double NormalDensity(double x)  { return std::exp(-0.5 * x * x); }
+inline double NormalInverse(double y)  { return std::sqrt(-2 * std::log(y)); }
+inline double ExpDensity(double x)     { return std::exp(-x); }
+inline double ExpInverse(double y)     { return -std::log(y); }
+
+inline const ZigguratTable<128>& NormalZiggurat() {
+    struct Table : ZigguratTable<128> { Table() { Build(3.442619855899, 9.91256303526217e-3, NormalDensity, NormalInverse); } };
+    static const Table table;
+    return table;
+}
+
+inline const ZigguratTable<256>& ExpZiggurat() {
+    struct Table : ZigguratTable<256> { Table() { Build(7.69711747013104972, 3.949659822581572e-3, ExpDensity, ExpInverse); } };
+    static const Table table;
+    return table;
+}
+
+// Slow path of the normal ziggurat for the word r that missed the rectangle.
+template <class E>
+double NormalSlow(uint64_t r, E& e) {
+    const ZigguratTable<128>& z = NormalZiggurat();
+    for (;;) {
+        const int i = (int)(r & 127);
+        const double u = Uniform01(r), x = u * z.X[i];
+        const bool negative = (r >> 7) & 1;
+        if (u < z.Q[i])
+            return negative ? -x : x;
+        if (i == 0) {
+            // tail beyond R (Marsaglia 1964)
+            double t, y;
+            do {
+                t = -std::log(1 - Uniform01(e())) / z.X[1];
+                y = -std::log(1 - Uniform01(e()));
+            } while (2 * y < t * t);
+            return negative ? -(z.X[1] + t) : z.X[1] + t;
+        }
+        if (z.F[i] + Uniform01(e()) * (z.F[i + 1] - z.F[i]) < NormalDensity(x))
+            return negative ? -x : x;
+        r = e();
+    }
+}
+
+template <class E>
+double ExpSlow(uint64_t r, E& e) {
+    const ZigguratTable<256>& z = ExpZiggurat();
+    for (;;) {
+        const int i = (int)(r & 255);
+        const double u = Uniform01(r), x = u * z.X[i];
+        if (u < z.Q[i])
+            return x;
+        if (i == 0)
+            return z.X[1] - std::log(1 - Uniform01(e()));   // the tail is memoryless
+        if (z.F[i] + Uniform01(e()) * (z.F[i + 1] - z.F[i]) < ExpDensity(x))
+            return x;
+        r = e();
+    }
+}
+
+} // namespace detail
+
+template <class E>
+double Uniform(E& e, double a = 0, double b = 1) { return a + (b - a) * Uniform01(e()); }
+
+// N(0,1). The low 7 bits of the word pick the layer, bit 7 the sign and the
+// top 52 bits the abscissa.
+template <class E>
+double Normal(E& e) {
+    const detail::ZigguratTable<128>& z = detail::NormalZiggurat();
+    const uint64_t r = e();
+    const int i = (int)(r & 127);
+    const double u = Uniform01(r);
+    if (u < z.Q[i])
+        return (r & 128) ? -u * z.X[i] : u * z.X[i];
+    return detail::NormalSlow(r, e);
+}
+
+template <class E>
+double Normal(E& e, double mean, double sd) { return mean + sd * Normal(e); }
+
+// Exp(1); divide by the rate for Exp(rate).
+template <class E>
+double Exponential(E& e) {
+    const detail::ZigguratTable<256>& z = detail::ExpZiggurat();
+    const uint64_t r = e();
+    const int i = (int)(r & 255);
+    const double u = Uniform01(r);
+    if (u < z.Q[i])
+        return u * z.X[i];
+    return detail::ExpSlow(r, e);
+}
+
+// Bulk versions: raw bits come in blocks from e.Fill and are transformed in a
+// second loop, which the compiler vectorizes for the uniform case.
+template <class E>
+void FillUniform(E& e, double* out, size_t n, double a = 0, double b = 1) {
+    uint64_t bits[256];
+    for (size_t i = 0; i < n; i += 256) {
+        const size_t m = n - i < 256 ? n - i : 256;
+        e.Fill(bits, m);
+        for (size_t j = 0; j < m; ++j)
+            out[i + j] = a + (b - a) * Uniform01(bits[j]);
+    }
+}
+
+template <class E>
+void FillNormal(E& e, double* out, size_t n, double mean = 0, double sd = 1) {
+    const detail::ZigguratTable<128>& z = detail::NormalZiggurat();
+    uint64_t bits[256];
+    for (size_t i = 0; i < n; i += 256) {
+        const size_t m = n - i < 256 ? n - i : 256;
+        e.Fill(bits, m);
+        for (size_t j = 0; j < m; ++j) {
+            const uint64_t r = bits[j];
+            const int l = (int)(r & 127);
+            const double u = Uniform01(r);
+            double x;
+            if (u < z.Q[l])
+                x = (r & 128) ? -u * z.X[l] : u * z.X[l];
+            else
+                x = detail::NormalSlow(r, e);
+            out[i + j] = mean + sd * x;
+        }
+    }
+}
+
+template <class E>
+void FillExponential(E& e, double* out, size_t n, double rate = 1) {
+    const detail::ZigguratTable<256>& z = detail::ExpZiggurat();
+    const double scale = 1 / rate;
+    uint64_t bits[256];
+    for (size_t i = 0; i < n; i += 256) {
+        const size_t m = n - i < 256 ? n - i : 256;
+        e.Fill(bits, m);
+        for (size_t j = 0; j < m; ++j) {
+            const uint64_t r = bits[j];
+            const int l = (int)(r & 255);
+            const double u = Uniform01(r);
+            out[i + j] = scale * (u < z.Q[l] ? u * z.X[l] : detail::ExpSlow(r, e));
+        }
+    }
+}
+
+} // namespace Hamzstlab
@@ -0,0 +1,170 @@
+// Hamzstlab Mathematics: batch root solves over a parameter sweep
+//
+// SolveRootsBatch solves f(x; p) = 0 for every p in an array. f is written once
+// against a generic number type, as in hamzstlab_autodiff.h,
+//
+//   struct Kepler {   // E - e sin(E) = M, parameter M
+//       double e;
+//       template <typename T> T operator()(const T& E, double M) const { using std::sin; return E - e * sin(E) - M; }
+//   };
+//
+// and Newton's method gets f' from dual numbers. Parameters are processed in
+// blocks of BatchRootLanes lanes stored as separate arrays (x, p, f, f', state),
+// so the per-lane loops are straight-line code the compiler can vectorize.
+// Every block is warm-started by extrapolating the roots of the previous block
+// (continuation), and a lane that diverges or stalls is re-solved with Brent on
+// the fallback bracket. For smooth root curves most solves take 2-3 steps.
+//
+// The array is split into segments solved concurrently with ParallelFor; each
+// segment starts cold from Guess. f must not modify shared state.
+
+#pragma once
+
+#include "hamzstlab_autodiff.h"
+#include "hamzstlab_parallel.h"
+#include <atomic>
+
+namespace Hamzstlab {
+
+enum { BatchRootLanes = 8 };
+
+struct BatchRootOptions {
+    double Guess;       // start of the first block in every segment
+    double Lo, Hi;      // fallback bracket; when Lo >= Hi a bracket is searched around the guess
+    double XTol;
+    int    MaxIter;     // Newton steps before a lane falls back
+    bool   WarmStart;   // false starts every lane from Guess
+    int    Segment;     // parameters per thread segment
+    int    Threads;     // <= 0 uses all cores
+    BatchRootOptions() {
+        Guess = 0; Lo = Hi = 0; XTol = 1e-12; MaxIter = 30;
+        WarmStart = true; Segment = 4096; Threads = 0;
+    }
+};
+
+struct BatchRootStats {
+    int    Solves;
+    long long Iterations;   // Newton steps over all lanes
+    int    Fallbacks;       // lanes re-solved by bracketing
+    int    Failures;        // lanes without a converged root (root set to NaN)
+    double Seconds;
+    BatchRootStats() { Solves = Fallbacks = Failures = 0; Iterations = 0; Seconds = 0; }
+};
+
+namespace detail {
+
+// f(.; p) as a plain double -> double callable, for the bracketing fallback
+template <class F>
+struct BatchRootSlice {
+    const F* Func;
+    double   P;
+    double operator()(double x) const { return (*Func)(x, P); }
+};
+
+// Grows [x-h, x+h] geometrically until f changes sign.
+template <class G>
+bool BatchRootFindBracket(const G& g, double x, double& lo, double& hi) {
+    double h = std::fabs(x) * 1e-2 + 1e-2;
+    for (int i = 0; i < 60; ++i, h *= 2) {
+        lo = x - h; hi = x + h;
+        double flo = g(lo), fhi = g(hi);
+        if (!std::isfinite(flo) || !std::isfinite(fhi))
+            return false;
+        if (!SameSign(flo, fhi))
+            return true;
+    }
+    return false;
+}
+
+template <class F>
+void BatchRootSegment(const F& f, const double* params, double* roots, int count, const BatchRootOptions& opt,
+                      long long& iterations, int& fallbacks, int& failures) {
+    const int L = BatchRootLanes;
+    double x[L], x0[L], p[L], fx[L], dfx[L], step[L];
+    int    state[L];  // 0 iterating, 1 converged, 2 needs fallback
+    // last two solved (p, x) for the linear predictor
+    double p1 = 0, x1 = opt.Guess, p2 = 0, x2 = opt.Guess;
+    int    solved = 0;
+    for (int base = 0; base < count; base += L) {
+        const int n = count - base < L ? count - base : L;
+        for (int i = 0; i < L; ++i) {
+            p[i] = params[base + (i < n ? i : n - 1)];
+            double guess = opt.Guess;
+            if (opt.WarmStart && solved >= 2 && p1 != p2)
+                guess = x1 + (x1 - x2) / (p1 - p2) * (p[i] - p1);
+            else if (opt.WarmStart && solved >= 1)
+                guess = x1;
+            if (opt.Lo < opt.Hi && (guess < opt.Lo || guess > opt.Hi))
+                guess = opt.Lo + 0.5 * (opt.Hi - opt.Lo);
+            x[i] = x0[i] = guess;
+            state[i] = 0;
+        }
+        for (int it = 0; it < opt.MaxIter; ++it) {
+            int active = 0;
+            for (int i = 0; i < n; ++i)
+                iterations += state[i] == 0;
+            for (int i = 0; i < L; ++i) {
+                Dual<double> d = f(Dual<double>(x[i], 1.0), p[i]);
+                fx[i] = d.Val; dfx[i] = d.Der;
+            }
+            for (int i = 0; i < L; ++i) {
+                if (state[i] != 0) { step[i] = 0; continue; }
+                step[i] = fx[i] / dfx[i];
+                double xn = x[i] - step[i];
+                bool bad = !std::isfinite(xn) || (opt.Lo < opt.Hi && (xn < opt.Lo || xn > opt.Hi));
+                state[i] = bad ? 2 : (fx[i] == 0 || RootXConverged(step[i], xn, RootOptions(opt.XTol)) ? 1 : 0);
+                if (!bad) x[i] = xn;
+                active += state[i] == 0;
+            }
+            if (active == 0)
+                break;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (state[i] != 1) {
+                // divergence or stall: bracket and solve this lane alone
+                ++fallbacks;
+                BatchRootSlice<F> g = { &f, p[i] };
+                double lo = opt.Lo, hi = opt.Hi;
+                bool ok = lo < hi ? !SameSign(g(lo), g(hi)) : BatchRootFindBracket(g, x0[i], lo, hi);
+                RootResult r;
+                if (ok)
+                    r = Brent(g, lo, hi, RootOptions(opt.XTol));
+                if (!ok || !r.Converged) {
+                    ++failures;
+                    roots[base + i] = NAN;
+                    continue;
+                }
+                x[i] = r.Root;
+            }
+            roots[base + i] = x[i];
+            p2 = p1; x2 = x1;
+            p1 = p[i]; x1 = x[i];
+            ++solved;
+        }
+    }
+}
+
+} // namespace detail
+
+template <class F>
+BatchRootStats SolveRootsBatch(const F& f, const double* params, double* roots, int count, const BatchRootOptions& opt = BatchRootOptions()) {
+    BatchRootStats stats;
+    detail::RootClock::time_point t0 = detail::RootClock::now();
+    const int segment = opt.Segment > BatchRootLanes ? opt.Segment : BatchRootLanes;
+    std::atomic<long long> iterations(0);
+    std::atomic<int> fallbacks(0), failures(0);
+    ParallelFor(count, segment, [&](int begin, int end) {
+        long long it = 0;
+        int fb = 0, fl = 0;
+        detail::BatchRootSegment(f, params + begin, roots + begin, end - begin, opt, it, fb, fl);
+        iterations += it; fallbacks += fb; failures += fl;
+    }, opt.Threads);
+    stats.Solves     = count;
+    stats.Iterations = iterations;
+    stats.Fallbacks  = fallbacks;
+    stats.Failures   = failures;
+    stats.Seconds    = std::chrono::duration<double>(detail::RootClock::now() - t0).count();
+    return stats;
+}
+
+} // namespace Hamzstlab
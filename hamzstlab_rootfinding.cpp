@@ -35,6 +35,16 @@
 #include <stdlib.h>
 #include <time.h>
 #include "symintegrationc++.h"
+#include "hamzstlab_compiledexpr.h"
+#include "hamzstlab_autodiff.h"
+#include "hamzstlab_roots.h"
+#include "hamzstlab_rootscan.h"
+#include "hamzstlab_polynomial.h"
+#include "hamzstlab_newtonfractal.h"
+#include "hamzstlab_rootbatch.h"
+#include "hamzstlab_sampling.h"
+#include "hamzstlab_interval.h"
+#include "hamzstlab_random.h"
 
 #ifdef _MSC_VER
 #define sprintf sprintf_s
@@ -96,30 +106,13 @@ ImVec4 RandomColor() {
 }
 
 double RandomGauss() {
-	static double V1, V2, S;
-	static int phase = 0;
-	double X;
-	if(phase == 0) {
-		do {
-			double U1 = (double)rand() / RAND_MAX;
-			double U2 = (double)rand() / RAND_MAX;
-			V1 = 2 * U1 - 1;
-			V2 = 2 * U2 - 1;
-			S = V1 * V1 + V2 * V2;
-			} while(S >= 1 || S == 0);
-
-		X = V1 * sqrt(-2 * log(S) / S);
-	} else
-		X = V2 * sqrt(-2 * log(S) / S);
-	phase = 1 - phase;
-	return X;
+	return Hamzstlab::Normal(Hamzstlab::ThreadEngine());
 }
 
 template <int N>
 struct NormalDistribution {
     NormalDistribution(double mean, double sd) {
-        for (int i = 0; i < N; ++i)
-            Data[i] = RandomGauss()*sd + mean;
+        Hamzstlab::FillNormal(Hamzstlab::ThreadEngine(), Data, N, mean, sd);
     }
     double Data[N];
 };
@@ -288,112 +281,192 @@ void Demo_Config() {
 
 //-----------------------------------------------------------------------------
 
-void Demo_BisectionPlots() {
-	Symbolic x("x"), xa, xb, xp, z1, z2, fa, fp, f;
-	float a = 1;
-	float b = 2;
-	int N = 17;
-
-	float p = a + (b-a)/2 ;
-
-	z1 = 3;
-	z2 = 2;
-	// Define the function here.
-	f = pow(x,z1) + 4*pow(x,z2) - 10; // f(x) = x^3 + 4x^2 - 10
-	
-	xp = p;
-	xb = b;
-	xa = a;
-	
-	static double xs2[17], ys2[17];
-	xs2[1] = a;
-	ys2[1] = pow(xa,z1) + 4*pow(xa,z2) - 10;
-	xs2[2] = b;
-	ys2[2] = pow(xb,z1) + 4*pow(xb,z2) - 10;
-	for (int i = 1; i <=N; i++)
-	{
-		p = a + (b-a)/2 ;
-		xa = a;
-		xp = p;
-		fa = pow(xa,z1) + 4*pow(xa,z2) - 10;
-		fp = pow(xp,z1) + 4*pow(xp,z2) - 10;	
-		xs2[i+2] = p;
-		ys2[i+2] = fp;
-		double fafp = fa*fp;
-		if (fafp> 0)
-		{
-			a = p;
-		}	
-		else
-		{
-			b = p;
-		}
-		cout << endl;
-	}
+// Functions offered by the bisection demo. The index into this table is part of the cache key.
+static const char* BisectionFunctionNames[] = { "f(x) = x^3 + 4x^2 - 10", "f(x) = cos(x) - x" };
 
-	static float xs1[1001], ys1[1001];
-	for (int i = 0; i < 1001; ++i) {
-		xs1[i] = i * 1.0f;
-		ys1[i] = pow(xs1[i],3) + 4.0f*(pow(xs1[i],2)) - 10.0f;
-	}
+Symbolic BisectionFunction(int idx, const Symbolic& x) {
+	if (idx == 1)
+		return cos(x) - x;
+	return pow(x,Symbolic(3)) + 4*pow(x,Symbolic(2)) - 10; // f(x) = x^3 + 4x^2 - 10
+}
+
+// The same functions as templates, for interval evaluation.
+struct BisectionFunctor {
+    int Func;
+    template <typename T> T operator()(const T& x) const {
+        using std::cos;
+        if (Func == 1)
+            return cos(x) - x;
+        return x*x*x + 4.0*x*x - 10.0;
+    }
+};
+
+// Processed boxes of the interval Newton isolator as closed rectangles [Lo,Hi] x f([Lo,Hi]),
+// separated by NaN so that one PlotLine draws them all.
+static void AppendIntervalBox(ImVector<double>& xs, ImVector<double>& ys, const Hamzstlab::IntervalRootBox& b) {
+    double flo = b.FLo > -1e6 ? b.FLo : -1e6, fhi = b.FHi < 1e6 ? b.FHi : 1e6;
+    double bx[6] = { b.Lo, b.Hi, b.Hi, b.Lo, b.Lo, NAN };
+    double by[6] = { flo, flo, fhi, fhi, flo, NAN };
+    for (int i = 0; i < 6; ++i) {
+        xs.push_back(bx[i]);
+        ys.push_back(by[i]);
+    }
+}
+
+// Bisection iterates, recomputed only when (f, a, b, N) changes. The curve is
+// resampled by Curve when f or the plot limits change.
+struct BisectionCache {
+    int   Func;
+    float A, B;
+    int   N;
+    ImVector<double> Xs, Ys;     // endpoints followed by the N midpoints
+    Hamzstlab::CompiledExpr  F;
+    Hamzstlab::IntervalRootResult Intervals;   // verified enclosures of every root in [a,b]
+    ImVector<double> PrunedXs, PrunedYs, SplitXs, SplitYs, EnclosureXs;
+    double           BoxesPerSecond;
+    double           IsolateSeconds;   // one IsolateRoots run without box recording
+    int              ScanSamples;      // uniform sampling of f in double, actually run
+    int              ScanSignChanges;
+    double           ScanSeconds;
+    Hamzstlab::CurveSampler  Curve;
+    bool                     CurveChanged;
+    BisectionCache() { Func = -1; A = B = 0; N = 0; CurveChanged = true; BoxesPerSecond = IsolateSeconds = ScanSeconds = 0; ScanSamples = ScanSignChanges = 0; }
+    bool Matches(int func, float a, float b, int n) const {
+        return Func == func && A == a && B == b && N == n;
+    }
+    void Update(int func, float a, float b, int n) {
+        if (Matches(func, a, b, n))
+            return;
+        if (Func != func) {
+            Symbolic x("x");
+            F.Compile(BisectionFunction(func, x), x);
+            CurveChanged = true;
+        }
+        Func = func; A = a; B = b; N = n;
+        Hamzstlab::RootOptions opt(0, 0, N);
+        Hamzstlab::RootResult  res = Hamzstlab::Bisection(F, a, b, opt);
+        Xs.resize((int)res.Xs.size());
+        Ys.resize((int)res.Fs.size());
+        for (int i = 0; i < Xs.Size; ++i) {
+            Xs[i] = res.Xs[i];
+            Ys[i] = res.Fs[i];
+        }
+        UpdateIntervals();
+    }
+    void UpdateIntervals() {
+        BisectionFunctor g = { Func };
+        Intervals = Hamzstlab::IsolateRoots(g, A, B);
+        // the isolation takes microseconds, so time repeated runs for a stable rate
+        int boxes = 0, reps = 0;
+        double seconds = 0;
+        while (seconds < 1e-3 && reps < 10000) {
+            Hamzstlab::IntervalRootResult r = Hamzstlab::IsolateRoots(g, A, B, Hamzstlab::IntervalRootOptions(), false);
+            boxes += r.Processed; seconds += r.Seconds; ++reps;
+        }
+        BoxesPerSecond = seconds > 0 ? boxes / seconds : 0;
+        IsolateSeconds = seconds / reps;
+        // the naive alternative: sample f on a uniform grid and look for sign changes.
+        // A grid at XTol spacing is out of reach, so time a million samples and scale.
+        const double tol = Hamzstlab::IntervalRootOptions().XTol;
+        ScanSamples = (int)std::min(1e6, (B - A) / tol) + 1;
+        Hamzstlab::detail::RootClock::time_point t0 = Hamzstlab::detail::RootClock::now();
+        ScanSignChanges = 0;
+        double prev = g((double)A);
+        for (int i = 1; i < ScanSamples; ++i) {
+            double y = g(A + (B - A) * i / (ScanSamples - 1));
+            ScanSignChanges += (prev < 0) != (y < 0);
+            prev = y;
+        }
+        ScanSeconds = std::chrono::duration<double>(Hamzstlab::detail::RootClock::now() - t0).count();
+        PrunedXs.resize(0); PrunedYs.resize(0); SplitXs.resize(0); SplitYs.resize(0); EnclosureXs.resize(0);
+        for (size_t i = 0; i < Intervals.Boxes.size() && i < 2000; ++i) {
+            const Hamzstlab::IntervalRootBox& b = Intervals.Boxes[i];
+            if (b.Status == Hamzstlab::IntervalBox_Pruned) AppendIntervalBox(PrunedXs, PrunedYs, b);
+            else if (b.Status == Hamzstlab::IntervalBox_Split) AppendIntervalBox(SplitXs, SplitYs, b);
+        }
+        for (size_t i = 0; i < Intervals.Roots.size(); ++i)
+            EnclosureXs.push_back((Intervals.Roots[i].Lo + Intervals.Roots[i].Hi) / 2);
+    }
+};
+
+void Demo_BisectionPlots() {
+	static int   func = 0;
+	static float a = 1;
+	static float b = 2;
+	static int   N = 17;
+	static BisectionCache cache;
+	static bool  boxes = false;
 
 	static bool range = false;
 	ImGui::Checkbox("Change parameters", &range);
     
 	if (range) {
-	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("f(x)", &func, BisectionFunctionNames, IM_ARRAYSIZE(BisectionFunctionNames));
 	ImGui::SetNextItemWidth(200);
 	ImGui::BulletText("a");
-	ImGui::DragFloat("##a", &a, -2.00f, 1.0f);
+	ImGui::DragFloat("##a", &a, 0.01f, -2.0f, 1.0f);
 	ImGui::SetNextItemWidth(200);
 	ImGui::BulletText("b");
-	ImGui::DragFloat("##b", &b, 0.01f, 5.0f);
+	ImGui::DragFloat("##b", &b, 0.01f, 1.0f, 5.0f);
+	ImGui::SetNextItemWidth(200);
+	ImGui::BulletText("N");
+	ImGui::SliderInt("##N", &N, 1, 50);
+	}
+
+	cache.Update(func, a, b, N);
+
+	ImGui::Checkbox("Interval Newton enclosures", &boxes);
+	if (boxes) {
+		const Hamzstlab::IntervalRootResult& iv = cache.Intervals;
+		const double tol = Hamzstlab::IntervalRootOptions().XTol;
+		ImGui::Text("%d verified enclosures, %d boxes processed (%d pruned), %d interval evaluations, %.2f million boxes/s",
+			(int)iv.Roots.size(), iv.Processed, iv.Pruned, iv.Evaluations, cache.BoxesPerSecond / 1e6);
+		if (!iv.Complete)
+			ImGui::TextColored(ImVec4(1, 0.4f, 0.4f, 1), "Box limit reached: the wide \"possible root\" enclosures were not examined");
+		const double full = (b - a) / tol;
+		ImGui::Text("Isolation: %.1f us per run. Uniform sampling: %d samples in %.2f ms (%d sign changes),",
+			cache.IsolateSeconds * 1e6, cache.ScanSamples, cache.ScanSeconds * 1e3, cache.ScanSignChanges);
+		ImGui::Text("so the same %.0e resolution (%.2e samples) would take about %.1f s",
+			tol, full, cache.ScanSeconds * full / cache.ScanSamples);
+		for (size_t i = 0; i < iv.Roots.size(); ++i)
+			ImGui::BulletText("[%.16f, %.16f] %s", iv.Roots[i].Lo, iv.Roots[i].Hi,
+				iv.Roots[i].Status == Hamzstlab::IntervalBox_Unique ? "exactly one root" : "possible root");
 	}
 
 	if (ImPlot::BeginPlot("Bisection Method")) {
         ImPlot::SetupAxes("x","y");
 	ImPlot::SetupAxesLimits(0, 3, -6, 17);
 	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
-        ImPlot::PlotLine("f(x) = x^3 + 4x^2 - 10", xs1, ys1, 1001);
+	cache.Curve.Update(cache.F, cache.CurveChanged);
+	cache.CurveChanged = false;
+        cache.Curve.Plot(BisectionFunctionNames[func]);
 	ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
-        ImPlot::PlotScatter("Bisection Approximation", xs2, ys2, 17);
+        ImPlot::PlotScatter("Bisection Approximation", cache.Xs.Data, cache.Ys.Data, cache.Xs.Size);
+	if (boxes) {
+		ImPlot::PlotLine("Pruned boxes", cache.PrunedXs.Data, cache.PrunedYs.Data, cache.PrunedXs.Size);
+		ImPlot::PlotLine("Bisected boxes", cache.SplitXs.Data, cache.SplitYs.Data, cache.SplitXs.Size);
+		ImPlot::PlotInfLines("Root enclosures", cache.EnclosureXs.Data, cache.EnclosureXs.Size);
+	}
   	ImPlot::EndPlot();
     }
 }
 //-----------------------------------------------------------------------------
 #define pi  3.1415926535897
+// f(x) = cos(x) - x written once against a generic number type: double for the
+// curve, Dual for Newton's f' and HyperDual for Halley's f''.
+struct CosMinusX {
+    template <typename T> T operator()(const T& x) const { using std::cos; return cos(x) - x; }
+};
+
 void Demo_NewtonMethodPlots() {
-	Symbolic x("x"), f, fd, f1;
-	f1 = 1;
-	float pn, p0;
-	p0 = (pi/4);
-	int N = 5;
+	static Hamzstlab::CurveSampler curve;
+	static float p0 = (pi/4);
+	static int method = 0;
+	static bool tangents = true;
+	const int N = 5;
 	//radtodeg = 57.295779513082320876;
 
-	f = cos(x) - x; // the input x has to be in Radian
-	fd = df(f,x);	
-	
-	static float xs2[2002], ys2[2002];
-	xs2[1] = pi/4 ; 
-	ys2[1] = cos(pi/4) - (pi/4) ;
-	for (int i = 1; i <=N; i++)
-	{
-		double fp = f[x==p0]*f1 ;
-		double fpd = fd[x==p0]*f1 ;
-		pn = p0 - (fp/fpd);
-
-		xs2[1+i] = pn ; 
-		ys2[1+i] = cos(pn) - (pn); 
-
-		p0 = pn;
-	}
-
-	static float xs1[20000], ys1[20000];
-	for (int i = 1; i < 20000; ++i) {
-		xs1[i] = i * 0.001f;
-		ys1[i] = cosf(xs1[i]) - xs1[i] ;
-	}
-
 	static bool range = false;
 	ImGui::Checkbox("Change parameters", &range);
     
@@ -401,22 +474,444 @@ void Demo_NewtonMethodPlots() {
 	ImGui::SameLine();
 	ImGui::SetNextItemWidth(200);
 	ImGui::BulletText("p0");
-	ImGui::DragFloat("##p0", &p0, -2.00f, 2.0f);
+	ImGui::DragFloat("##p0", &p0, 0.01f, -2.0f, 2.0f);
+	}
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("Method", &method, "Newton (dual numbers)\0Halley (hyper-dual numbers)\0");
+	ImGui::SameLine();
+	ImGui::Checkbox("Tangent lines", &tangents);
+
+	// iterates with exact f' (and f'' for Halley) from one generic evaluation each
+	double xs2[N+1], ys2[N+1], ds2[N+1];
+	double pn = p0;
+	for (int i = 0; i <= N; i++)
+	{
+		xs2[i] = pn;
+		if (method == 0) {
+			ds2[i] = Hamzstlab::Derivative(CosMinusX(), pn, &ys2[i]);
+			pn = pn - ys2[i]/ds2[i];
+		} else {
+			double d2 = Hamzstlab::SecondDerivative(CosMinusX(), pn, &ys2[i], &ds2[i]);
+			pn = pn - 2*ys2[i]*ds2[i]/(2*ds2[i]*ds2[i] - ys2[i]*d2);
+		}
 	}
+	// each tangent y = f(p) + f'(p)(x - p) runs from p to the next iterate
+	double tx[3*N], ty[3*N];
+	for (int i = 0; i < N; i++) {
+		tx[3*i] = xs2[i];   ty[3*i] = ys2[i];
+		tx[3*i+1] = xs2[i+1]; ty[3*i+1] = ys2[i] + ds2[i]*(xs2[i+1] - xs2[i]);
+		tx[3*i+2] = NAN;    ty[3*i+2] = NAN;
+	}
+	ImGui::Text("p%d = %.15f, f(p%d) = %.3e, curve: %d evaluations", N, xs2[N], N, ys2[N], curve.Evaluations);
 
 	if (ImPlot::BeginPlot("Newton-Raphson Method")) {
         ImPlot::SetupAxes("x","y");
 	ImPlot::SetupAxesLimits(0, 5, -10, 8);
 	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
-        ImPlot::PlotLine("f(x) = cos(x) - x", xs1, ys1, 20000);
+	curve.Update(CosMinusX());
+        curve.Plot("f(x) = cos(x) - x");
+	if (tangents)
+		ImPlot::PlotLine("Tangent lines", tx, ty, 3*N); // NaN rows break the line between tangents
 	ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
-        ImPlot::PlotScatter("Newton-Raphson Approximation", xs2, ys2, N);
+        ImPlot::PlotScatter(method == 0 ? "Newton-Raphson Approximation" : "Halley Approximation", xs2, ys2, N+1);
   	ImPlot::EndPlot();
     }
 }
 
 //-----------------------------------------------------------------------------
 
+// Runs every method of hamzstlab_roots.h on the same bracket, recomputed only when
+// the function, bracket or tolerance changes.
+struct RootComparison {
+    int   Func;
+    float A, B, Tol;
+    Hamzstlab::CompiledExpr F, DF;
+    Hamzstlab::RootResult   Results[Hamzstlab::RootMethod_COUNT];
+    ImVector<double>        Iters[Hamzstlab::RootMethod_COUNT], Residuals[Hamzstlab::RootMethod_COUNT];
+    RootComparison() { Func = -1; A = B = Tol = 0; }
+    void Update(int func, float a, float b, float tol) {
+        if (Func == func && A == a && B == b && Tol == tol)
+            return;
+        if (Func != func) {
+            Symbolic x("x");
+            Hamzstlab::CompileWithDerivative(BisectionFunction(func, x), x, F, DF);
+        }
+        Func = func; A = a; B = b; Tol = tol;
+        Hamzstlab::RootOptions opt(pow(10.0, (double)tol), 0, 100);
+        for (int m = 0; m < Hamzstlab::RootMethod_COUNT; ++m) {
+            Results[m] = Hamzstlab::SolveRoot(m, F, DF, a, b, opt);
+            const Hamzstlab::RootResult& r = Results[m];
+            Iters[m].resize((int)r.Fs.size());
+            Residuals[m].resize((int)r.Fs.size());
+            for (int i = 0; i < Iters[m].Size; ++i) {
+                Iters[m][i]     = i;
+                Residuals[m][i] = fabs(r.Fs[i]) > 1e-17 ? fabs(r.Fs[i]) : 1e-17;
+            }
+        }
+    }
+};
+
+void Demo_RootMethodComparison() {
+	static int   func = 0;
+	static float a = 1, b = 2;
+	static float tol = -12; // log10 of the x tolerance
+	static RootComparison cmp;
+
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("f(x)", &func, BisectionFunctionNames, IM_ARRAYSIZE(BisectionFunctionNames));
+	ImGui::SetNextItemWidth(200);
+	ImGui::DragFloatRange2("[a,b]", &a, &b, 0.01f, -2.0f, 5.0f);
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderFloat("log10(tol)", &tol, -15, -1, "%.0f");
+
+	cmp.Update(func, a, b, tol);
+
+	if (ImGui::BeginTable("##Methods", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+		ImGui::TableSetupColumn("Method");
+		ImGui::TableSetupColumn("Root");
+		ImGui::TableSetupColumn("Iterations");
+		ImGui::TableSetupColumn("f evals");
+		ImGui::TableSetupColumn("Time (us)");
+		ImGui::TableSetupColumn("Converged");
+		ImGui::TableHeadersRow();
+		for (int m = 0; m < Hamzstlab::RootMethod_COUNT; ++m) {
+			const Hamzstlab::RootResult& r = cmp.Results[m];
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(Hamzstlab::RootMethodName(m));
+			ImGui::TableNextColumn(); ImGui::Text("%.15g", r.Root);
+			ImGui::TableNextColumn(); ImGui::Text("%d", r.Iterations);
+			ImGui::TableNextColumn(); ImGui::Text("%d", r.Evaluations);
+			ImGui::TableNextColumn(); ImGui::Text("%.2f", r.Seconds * 1e6);
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(r.Converged ? "yes" : "no");
+		}
+		ImGui::EndTable();
+	}
+
+	if (ImPlot::BeginPlot("Convergence")) {
+	ImPlot::SetupAxes("iterate","|f(x)|", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+	ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
+	for (int m = 0; m < Hamzstlab::RootMethod_COUNT; ++m) {
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
+		ImPlot::PlotLine(Hamzstlab::RootMethodName(m), cmp.Iters[m].Data, cmp.Residuals[m].Data, cmp.Iters[m].Size);
+	}
+  	ImPlot::EndPlot();
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static const char* ScanFunctionNames[] = { "f(x) = sin(x^2) - 0.2cos(3x)", "f(x) = (x-1)^2 (x+1)", "f(x) = x^3 + 4x^2 - 10", "f(x) = cos(x) - x" };
+
+Symbolic ScanFunction(int idx, const Symbolic& x) {
+	switch (idx) {
+		case 1:  return pow(x-1,Symbolic(2))*(x+1);
+		case 2:  return pow(x,Symbolic(3)) + 4*pow(x,Symbolic(2)) - 10;
+		case 3:  return cos(x) - x;
+		default: return sin(pow(x,Symbolic(2))) - 0.2*cos(3*x);
+	}
+}
+
+// Compiled f with an optional artificial cost, to emulate an expensive model.
+struct ScanObjective {
+    const Hamzstlab::CompiledExpr* F;
+    int Cost;
+    double operator()(double x) const {
+        volatile double sink = 0;
+        for (int k = 1; k < Cost; ++k)
+            sink = (*F)(x);
+        (void)sink;
+        return (*F)(x);
+    }
+};
+
+void Demo_AllRoots() {
+	static int   func = 0;
+	static float a = -5, b = 5;
+	static int   samples = 1000;
+	static int   cost = 1;
+	static int   threads = Hamzstlab::ThreadCount();
+	static Hamzstlab::CompiledExpr F;
+	static Hamzstlab::RootScanResult res;
+	static Hamzstlab::CurveSampler curve;
+	static bool  curve_changed = true;
+	static int   key_func = -1, key_samples = 0, key_cost = 0, key_threads = 0;
+	static float key_a = 0, key_b = 0;
+
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("f(x)", &func, ScanFunctionNames, IM_ARRAYSIZE(ScanFunctionNames));
+	ImGui::SetNextItemWidth(200);
+	ImGui::DragFloatRange2("[a,b]", &a, &b, 0.05f, -20.0f, 20.0f);
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderInt("Samples", &samples, 10, 100000, "%d", ImGuiSliderFlags_Logarithmic);
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderInt("Cost per f(x)", &cost, 1, 10000, "%d", ImGuiSliderFlags_Logarithmic);
+	ImGui::SetNextItemWidth(200);
+	ImGui::SliderInt("Threads", &threads, 1, Hamzstlab::ThreadCount());
+
+	if (func != key_func || a != key_a || b != key_b || samples != key_samples || cost != key_cost || threads != key_threads) {
+		if (func != key_func) {
+			Symbolic x("x");
+			F.Compile(ScanFunction(func, x), x);
+			curve_changed = true;
+		}
+		key_func = func; key_a = a; key_b = b; key_samples = samples; key_cost = cost; key_threads = threads;
+		ScanObjective obj = { &F, cost };
+		Hamzstlab::RootScanOptions opt;
+		opt.Samples = samples;
+		opt.Threads = threads;
+		res = Hamzstlab::FindAllRoots(obj, a, b, opt);
+	}
+
+	ImGui::Text("%d roots, %d brackets, %d tangent candidates, %d evaluations, %.3f ms on %d threads",
+		(int)res.Roots.size(), res.Brackets, res.TangentCandidates, res.Evaluations, res.Seconds * 1000, threads);
+
+	if (ImPlot::BeginPlot("All Roots")) {
+        ImPlot::SetupAxes("x","y");
+	ImPlot::SetupAxesLimits(a, b, -2, 2);
+	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
+	curve.Update(F, curve_changed);
+	curve_changed = false;
+        curve.Plot(ScanFunctionNames[func]);
+	ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle);
+        ImPlot::PlotScatter("Roots", res.Roots.data(), res.FRoots.data(), (int)res.Roots.size());
+  	ImPlot::EndPlot();
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+void Demo_PolynomialRoots() {
+	static const char* modes[] = { "x^3 + 4x^2 - 10", "Random coefficients", "Root locus D(z) + k N(z)" };
+	static int   mode = 1;
+	static int   degree = 64;
+	static int   seed = 1;
+	static int   steps = 2000;
+	static float kmax = 10;
+	static ImVector<double> coef, num, locus_re, locus_im, re, im;
+	static std::vector< std::complex<double> > roots;
+	static Hamzstlab::PolyRootSolver solver;
+	static Hamzstlab::PolyRootStats stats;
+	static double seconds = 0;
+	static int   key_mode = -1, key_degree = 0, key_seed = 0, key_steps = 0;
+	static float key_kmax = 0;
+
+	ImGui::SetNextItemWidth(200);
+	ImGui::Combo("Polynomial", &mode, modes, IM_ARRAYSIZE(modes));
+	if (mode != 0) {
+		ImGui::SetNextItemWidth(200);
+		ImGui::SliderInt("Degree", &degree, 2, 4096, "%d", ImGuiSliderFlags_Logarithmic);
+		ImGui::SameLine();
+		if (ImGui::Button("Randomize"))
+			seed++;
+	}
+	if (mode == 2) {
+		ImGui::SetNextItemWidth(200);
+		ImGui::SliderInt("k steps", &steps, 10, 20000, "%d", ImGuiSliderFlags_Logarithmic);
+		ImGui::SetNextItemWidth(200);
+		ImGui::SliderFloat("k max", &kmax, 0.1f, 1000.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+	}
+
+	if (mode != key_mode || degree != key_degree || seed != key_seed || steps != key_steps || kmax != key_kmax) {
+		key_mode = mode; key_degree = degree; key_seed = seed; key_steps = steps; key_kmax = kmax;
+		int n = mode == 0 ? 3 : degree;
+		coef.resize(n + 1);
+		srand(seed);
+		if (mode == 0) {
+			coef[0] = -10; coef[1] = 0; coef[2] = 4; coef[3] = 1;
+		}
+		else {
+			for (int i = 0; i <= n; ++i)
+				coef[i] = RandomRange(-1.0, 1.0);
+		}
+		roots.resize(n);
+		locus_re.resize(0);
+		locus_im.resize(0);
+		clock_t t0 = clock();
+		Hamzstlab::PolyRootOptions opt;
+		if (mode == 2) {
+			// D(z) + k N(z), N of degree n/2, solved for k = 0..kmax warm-started from the previous k
+			num.resize(n / 2 + 1);
+			for (int i = 0; i <= n / 2; ++i)
+				num[i] = RandomRange(-1.0, 1.0);
+			ImVector<double> c = coef;
+			solver.Solve(c.Data, n, roots.data(), opt, &stats);
+			opt.WarmStart = true;
+			int stride = steps / 200 > 1 ? steps / 200 : 1;
+			for (int s = 1; s <= steps; ++s) {
+				double k = kmax * s / steps;
+				for (int i = 0; i <= n / 2; ++i)
+					c[i] = coef[i] + k * num[i];
+				solver.Solve(c.Data, n, roots.data(), opt, &stats);
+				if (s % stride == 0) {
+					for (int i = 0; i < n; ++i) {
+						locus_re.push_back(roots[i].real());
+						locus_im.push_back(roots[i].imag());
+					}
+				}
+			}
+		}
+		else {
+			solver.Solve(coef.Data, n, roots.data(), opt, &stats);
+		}
+		seconds = (double)(clock() - t0) / CLOCKS_PER_SEC;
+		re.resize(n);
+		im.resize(n);
+		for (int i = 0; i < n; ++i) {
+			re[i] = roots[i].real();
+			im[i] = roots[i].imag();
+		}
+	}
+
+	if (mode == 2)
+		ImGui::Text("%d solves of degree %d in %.3f s (%.0f solves/s)", steps + 1, degree, seconds, (steps + 1) / (seconds > 0 ? seconds : 1e-9));
+	else
+		ImGui::Text("degree %d: %d Aberth iterations%s, %.3f ms", re.Size, stats.Iterations, stats.UsedFallback ? " + companion fallback" : "", seconds * 1000);
+
+	if (ImPlot::BeginPlot("Roots in the Complex Plane", ImVec2(-1,0), ImPlotFlags_Equal)) {
+        ImPlot::SetupAxes("Re(z)","Im(z)", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+	ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
+	if (locus_re.Size > 0) {
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 1);
+		ImPlot::PlotScatter("Root locus", locus_re.Data, locus_im.Data, locus_re.Size);
+	}
+	ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 3);
+        ImPlot::PlotScatter(mode == 2 ? "Roots at k max" : "Roots", re.Data, im.Data, re.Size);
+  	ImPlot::EndPlot();
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// Kepler's equation E - e sin(E) = M, solved for E with the mean anomaly M as parameter.
+struct KeplerEquation {
+    double e;
+    template <typename T> T operator()(const T& E, double M) const { using std::sin; return E - e * sin(E) - M; }
+};
+
+// Sweeps M over [0, 2 pi] with the batch solver of hamzstlab_rootbatch.h and plots E*(M).
+// Solved again only when e, the sweep size or the start strategy changes.
+void Demo_BatchRoots() {
+	static ImVector<double> Ms, Es;
+	static Hamzstlab::BatchRootStats stats;
+	static float ecc = 0.9f;
+	static int size = 2;
+	static bool warm = true, dirty = true;
+	const int sizes[] = { 1000, 10000, 100000, 1000000 };
+
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::SliderFloat("Eccentricity e", &ecc, 0.0f, 0.999f, "%.3f")) dirty = true;
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::Combo("Parameters", &size, "1e3\0" "1e4\0" "1e5\0" "1e6\0")) dirty = true;
+	if (ImGui::Checkbox("Warm start from neighbouring roots", &warm)) dirty = true;
+	ImGui::SameLine();
+	if (ImGui::Button("Solve again")) dirty = true;
+
+	if (dirty) {
+		const int n = sizes[size];
+		Ms.resize(n);
+		Es.resize(n);
+		for (int i = 0; i < n; ++i)
+			Ms[i] = 2 * pi * i / (n - 1);
+		KeplerEquation kepler = { ecc };
+		Hamzstlab::BatchRootOptions opt;
+		opt.Guess = pi;
+		opt.Lo = 0;
+		opt.Hi = 2 * pi;
+		opt.WarmStart = warm;
+		stats = Hamzstlab::SolveRootsBatch(kepler, Ms.Data, Es.Data, n, opt);
+		dirty = false;
+	}
+	ImGui::Text("%d solves in %.2f ms: %.2f million solves/s, %.2f Newton steps/solve, %d bracketing fallbacks, %d failures",
+		stats.Solves, stats.Seconds * 1000, stats.Solves / (stats.Seconds > 0 ? stats.Seconds : 1e-9) / 1e6,
+		(double)stats.Iterations / (stats.Solves > 0 ? stats.Solves : 1), stats.Fallbacks, stats.Failures);
+
+	if (ImPlot::BeginPlot("Root Curve E*(M)")) {
+		ImPlot::SetupAxes("M","E*", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+		ImPlot::SetupLegend(ImPlotLocation_East, ImPlotLegendFlags_Outside);
+		// at most ~4000 points are drawn, through a stride over the full sweep
+		const int step = Ms.Size > 4000 ? Ms.Size / 4000 : 1;
+		ImPlot::PlotLine("E - e sin(E) = M", Ms.Data, Es.Data, Ms.Size / step, 0, 0, step * (int)sizeof(double));
+		ImPlot::EndPlot();
+	}
+}
+
+//-----------------------------------------------------------------------------
+
+// Basins of attraction of Newton's method for z^n - 1. The image is rendered by
+// hamzstlab_newtonfractal.h only when the view, degree, resolution or kernel changes.
+void Demo_NewtonFractal() {
+	static Hamzstlab::NewtonFractalSpec s, last;
+	static ImVector<float> image;
+	static bool avx = Hamzstlab::NewtonFractalHasAVX();
+	static bool dp  = true;
+	static bool mt  = true;
+	static bool dirty = true;
+	static int res = 2;
+	static double ms = 0;
+	const int resolutions[] = { 256, 512, 1024 };
+
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::SliderInt("Degree n", &s.Degree, 2, 8)) dirty = true;
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::SliderInt("Max iterations", &s.Iterations, 8, 256)) dirty = true;
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::Combo("Resolution", &res, "256 x 256\0" "512 x 512\0" "1024 x 1024\0")) dirty = true;
+	ImGui::SameLine();
+	if (!Hamzstlab::NewtonFractalHasAVX()) ImGui::BeginDisabled();
+	if (ImGui::Checkbox("AVX", &avx)) dirty = true;
+	if (!Hamzstlab::NewtonFractalHasAVX()) ImGui::EndDisabled();
+	ImGui::SameLine();
+	if (ImGui::Checkbox("Multithreaded", &mt)) dirty = true;
+	ImGui::SameLine();
+	if (ImGui::Checkbox("Double", &dp)) dirty = true;
+	ImGui::SameLine();
+	if (ImGui::Button("Home"))
+		ImPlot::SetNextAxesLimits(-1.5, 1.5, -1.5, 1.5, ImGuiCond_Always);
+	ImGui::Text("Render: %.2f ms (%d threads, %s)", ms, mt ? Hamzstlab::ThreadCount() : 1, avx ? "AVX" : "scalar");
+
+	ImPlotColormap cmap = Hamzstlab::NewtonFractalColormap(s.Degree);
+	ImPlot::PushColormap(cmap);
+	if (ImPlot::BeginPlot("##NewtonFractal", ImVec2(-1,-1), ImPlotFlags_Equal)) {
+		ImPlot::SetupAxes("Re(z)","Im(z)");
+		ImPlot::SetupAxesLimits(-1.5, 1.5, -1.5, 1.5);
+		ImPlotRect lims = ImPlot::GetPlotLimits();
+		s.Width = s.Height = resolutions[res];
+		s.XLim[0] = lims.X.Min;
+		s.XLim[1] = lims.X.Max;
+		s.YLim[0] = lims.Y.Max;
+		s.YLim[1] = lims.Y.Min;
+		if (image.Size != s.Width * s.Height) {
+			image.resize(s.Width * s.Height);
+			dirty = true;
+		}
+		if (dirty || s.XLim[0] != last.XLim[0] || s.XLim[1] != last.XLim[1] || s.YLim[0] != last.YLim[0] || s.YLim[1] != last.YLim[1]) {
+			std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+			int threads = mt ? 0 : 1;
+			if (dp) Hamzstlab::RenderNewtonFractal<double>(image.Data, s, avx, threads);
+			else    Hamzstlab::RenderNewtonFractal<float>(image.Data, s, avx, threads);
+			ms = 1000.0 * std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+			last = s;
+			dirty = false;
+		}
+		ImPlot::PlotHeatmap("##Basins", image.Data, s.Height, s.Width, 0, 2 * s.Degree - 1, NULL, lims.Min(), lims.Max());
+		// the n roots of unity
+		double rx[8], ry[8];
+		for (int k = 0; k < s.Degree; ++k) {
+			rx[k] = cos(2 * pi * k / s.Degree);
+			ry[k] = sin(2 * pi * k / s.Degree);
+		}
+		ImPlot::SetNextMarkerStyle(ImPlotMarker_Circle, 4, ImVec4(1,1,1,1));
+		ImPlot::PlotScatter("Roots", rx, ry, s.Degree);
+		ImPlot::EndPlot();
+	}
+	ImPlot::PopColormap();
+}
+
+//-----------------------------------------------------------------------------
+
 
 //-----------------------------------------------------------------------------
 
@@ -613,6 +1108,14 @@ void ShowRootFindingWindow(bool* p_open) {
         if (ImGui::BeginTabItem("Plots")) {
 	    DemoHeader("Bisection Method", Demo_BisectionPlots);
             DemoHeader("Newton-Raphson Method", Demo_NewtonMethodPlots);
+            DemoHeader("Method Comparison", Demo_RootMethodComparison);
+            DemoHeader("All Roots in [a,b]", Demo_AllRoots);
+            DemoHeader("Polynomial Roots", Demo_PolynomialRoots);
+            DemoHeader("Parameter Sweep", Demo_BatchRoots);
+            ImGui::EndTabItem();
+        }
+        if (ImGui::BeginTabItem("Newton Fractal")) {
+            Demo_NewtonFractal();
             ImGui::EndTabItem();
         }
         if (ImGui::BeginTabItem("Custom")) {
@@ -0,0 +1,307 @@
+// Hamzstlab Mathematics: root finding for equations in one variable
+//
+// Every method takes a callable double f(double), a bracket [a,b] or a start
+// point, and RootOptions, and returns a RootResult with the root, the iterate
+// history, the number of function evaluations and the wall time.
+//
+//   Hamzstlab::RootResult r = Hamzstlab::Brent(f, 1.0, 2.0);
+//   printf("%g after %d evaluations\n", r.Root, r.Evaluations);
+//
+// Bracketing methods (Bisection, Illinois, Ridders, Brent) require f(a) and
+// f(b) of opposite sign and never leave the bracket. Newton and Secant are
+// open methods and may diverge; Converged tells which happened.
+
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace Hamzstlab {
+
+struct RootOptions {
+    double XTol;      // absolute tolerance on x
+    double RelTol;    // relative tolerance on x
+    double FTol;      // stop when |f(x)| <= FTol
+    int    MaxIter;
+    RootOptions(double xtol = 1e-12, double ftol = 0, int max_iter = 100) {
+        XTol = xtol; RelTol = 4e-16; FTol = ftol; MaxIter = max_iter;
+    }
+};
+
+struct RootResult {
+    double Root;
+    double FRoot;
+    int    Iterations;
+    int    Evaluations;
+    double Seconds;
+    bool   Converged;
+    std::vector<double> Xs, Fs;   // starting point(s), then one entry per iteration
+    RootResult() { Root = FRoot = 0; Iterations = Evaluations = 0; Seconds = 0; Converged = false; }
+};
+
+enum RootMethod {
+    RootMethod_Bisection,
+    RootMethod_Newton,
+    RootMethod_Secant,
+    RootMethod_Illinois,
+    RootMethod_Ridders,
+    RootMethod_Brent,
+    RootMethod_COUNT
+};
+
+inline const char* RootMethodName(int method) {
+    static const char* names[] = { "Bisection", "Newton", "Secant", "Illinois", "Ridders", "Brent" };
+    return method >= 0 && method < RootMethod_COUNT ? names[method] : "";
+}
+
+namespace detail {
+
+typedef std::chrono::steady_clock RootClock;
+
+// Wraps the user callable to count evaluations and record history.
+template <class F>
+struct RootRecorder {
+    F&                   Func;
+    RootResult&          Res;
+    RootClock::time_point Start;
+    RootRecorder(F& f, RootResult& res) : Func(f), Res(res), Start(RootClock::now()) { }
+    double operator()(double x) { ++Res.Evaluations; return Func(x); }
+    void Record(double x, double fx) { Res.Xs.push_back(x); Res.Fs.push_back(fx); }
+    void Finish(double x, double fx, bool converged) {
+        Res.Root = x; Res.FRoot = fx; Res.Converged = converged;
+        Res.Seconds = std::chrono::duration<double>(RootClock::now() - Start).count();
+    }
+};
+
+inline bool RootXConverged(double step, double x, const RootOptions& opt) {
+    return std::fabs(step) <= opt.XTol + opt.RelTol * std::fabs(x);
+}
+
+inline bool SameSign(double a, double b) { return (a > 0 && b > 0) || (a < 0 && b < 0); }
+
+} // namespace detail
+
+template <class F>
+RootResult Bisection(F f, double a, double b, const RootOptions& opt = RootOptions()) {
+    RootResult res;
+    detail::RootRecorder<F> rec(f, res);
+    double fa = rec(a), fb = rec(b);
+    rec.Record(a, fa);
+    rec.Record(b, fb);
+    if (fa == 0) { rec.Finish(a, fa, true); return res; }
+    if (fb == 0) { rec.Finish(b, fb, true); return res; }
+    if (detail::SameSign(fa, fb)) { rec.Finish(a, fa, false); return res; }
+    double p = a, fp = fa;
+    for (int i = 0; i < opt.MaxIter; ++i) {
+        p  = a + (b - a) / 2;
+        fp = rec(p);
+        rec.Record(p, fp);
+        res.Iterations = i + 1;
+        if (fp == 0 || std::fabs(fp) <= opt.FTol || detail::RootXConverged((b - a) / 2, p, opt)) {
+            rec.Finish(p, fp, true);
+            return res;
+        }
+        if (detail::SameSign(fa, fp)) { a = p; fa = fp; }
+        else                          { b = p; }
+    }
+    rec.Finish(p, fp, false);
+    return res;
+}
+
+template <class F, class DF>
+RootResult Newton(F f, DF df, double x0, const RootOptions& opt = RootOptions()) {
+    RootResult res;
+    detail::RootRecorder<F> rec(f, res);
+    double x = x0, fx = rec(x);
+    rec.Record(x, fx);
+    for (int i = 0; i < opt.MaxIter; ++i) {
+        if (fx == 0 || std::fabs(fx) <= opt.FTol) { rec.Finish(x, fx, true); return res; }
+        double d = df(x);
+        ++res.Evaluations;
+        if (d == 0 || !std::isfinite(d)) break;
+        double step = fx / d;
+        x -= step;
+        fx = rec(x);
+        rec.Record(x, fx);
+        res.Iterations = i + 1;
+        if (!std::isfinite(x)) break;
+        if (detail::RootXConverged(step, x, opt)) { rec.Finish(x, fx, true); return res; }
+    }
+    rec.Finish(x, fx, false);
+    return res;
+}
+
+template <class F>
+RootResult Secant(F f, double x0, double x1, const RootOptions& opt = RootOptions()) {
+    RootResult res;
+    detail::RootRecorder<F> rec(f, res);
+    double f0 = rec(x0), f1 = rec(x1);
+    rec.Record(x0, f0);
+    rec.Record(x1, f1);
+    for (int i = 0; i < opt.MaxIter; ++i) {
+        if (f1 == 0 || std::fabs(f1) <= opt.FTol) { rec.Finish(x1, f1, true); return res; }
+        if (f1 == f0) break;
+        double step = f1 * (x1 - x0) / (f1 - f0);
+        x0 = x1; f0 = f1;
+        x1 -= step;
+        f1 = rec(x1);
+        rec.Record(x1, f1);
+        res.Iterations = i + 1;
+        if (!std::isfinite(x1)) break;
+        if (detail::RootXConverged(step, x1, opt)) { rec.Finish(x1, f1, true); return res; }
+    }
+    rec.Finish(x1, f1, false);
+    return res;
+}
+
+// Regula falsi with the Illinois modification: when the same endpoint is kept
+// twice in a row its function value is halved, which restores superlinear
+// convergence on convex/concave functions.
+template <class F>
+RootResult Illinois(F f, double a, double b, const RootOptions& opt = RootOptions()) {
+    RootResult res;
+    detail::RootRecorder<F> rec(f, res);
+    double fa = rec(a), fb = rec(b);
+    rec.Record(a, fa);
+    rec.Record(b, fb);
+    if (fa == 0) { rec.Finish(a, fa, true); return res; }
+    if (fb == 0) { rec.Finish(b, fb, true); return res; }
+    if (detail::SameSign(fa, fb)) { rec.Finish(a, fa, false); return res; }
+    int side = 0;
+    double c = b, fc = fb;
+    for (int i = 0; i < opt.MaxIter; ++i) {
+        double prev = c;
+        c  = (a * fb - b * fa) / (fb - fa);
+        fc = rec(c);
+        rec.Record(c, fc);
+        res.Iterations = i + 1;
+        if (fc == 0 || std::fabs(fc) <= opt.FTol || detail::RootXConverged(c - prev, c, opt) || detail::RootXConverged(b - a, c, opt)) {
+            rec.Finish(c, fc, true);
+            return res;
+        }
+        if (detail::SameSign(fc, fb)) {
+            b = c; fb = fc;
+            if (side == -1) fa /= 2;
+            side = -1;
+        }
+        else {
+            a = c; fa = fc;
+            if (side == +1) fb /= 2;
+            side = +1;
+        }
+    }
+    rec.Finish(c, fc, false);
+    return res;
+}
+
+template <class F>
+RootResult Ridders(F f, double a, double b, const RootOptions& opt = RootOptions()) {
+    RootResult res;
+    detail::RootRecorder<F> rec(f, res);
+    double fa = rec(a), fb = rec(b);
+    rec.Record(a, fa);
+    rec.Record(b, fb);
+    if (fa == 0) { rec.Finish(a, fa, true); return res; }
+    if (fb == 0) { rec.Finish(b, fb, true); return res; }
+    if (detail::SameSign(fa, fb)) { rec.Finish(a, fa, false); return res; }
+    double x = b, fx = fb;
+    for (int i = 0; i < opt.MaxIter; ++i) {
+        double m  = (a + b) / 2;
+        double fm = rec(m);
+        double s  = std::sqrt(fm * fm - fa * fb);
+        if (s == 0) { x = m; fx = fm; break; }
+        double prev = x;
+        x  = m + (m - a) * ((fa >= fb ? 1.0 : -1.0) * fm / s);
+        fx = rec(x);
+        rec.Record(x, fx);
+        res.Iterations = i + 1;
+        if (fx == 0 || std::fabs(fx) <= opt.FTol || detail::RootXConverged(x - prev, x, opt)) {
+            rec.Finish(x, fx, true);
+            return res;
+        }
+        if (!detail::SameSign(fm, fx)) { a = m; fa = fm; b = x; fb = fx; }
+        else if (!detail::SameSign(fa, fx)) { b = x; fb = fx; }
+        else { a = x; fa = fx; }
+        if (detail::RootXConverged(b - a, x, opt)) { rec.Finish(x, fx, true); return res; }
+    }
+    rec.Finish(x, fx, std::fabs(fx) <= opt.FTol || fx == 0);
+    return res;
+}
+
+// Brent's method: inverse quadratic interpolation and secant steps, falling
+// back to bisection whenever they do not shrink the bracket fast enough.
+template <class F>
+RootResult Brent(F f, double a, double b, const RootOptions& opt = RootOptions()) {
+    RootResult res;
+    detail::RootRecorder<F> rec(f, res);
+    double fa = rec(a), fb = rec(b);
+    rec.Record(a, fa);
+    rec.Record(b, fb);
+    if (fa == 0) { rec.Finish(a, fa, true); return res; }
+    if (fb == 0) { rec.Finish(b, fb, true); return res; }
+    if (detail::SameSign(fa, fb)) { rec.Finish(a, fa, false); return res; }
+    double c = a, fc = fa, d = b - a, e = d;
+    for (int i = 0; i < opt.MaxIter; ++i) {
+        if (detail::SameSign(fb, fc)) {
+            c = a; fc = fa; d = b - a; e = d;
+        }
+        if (std::fabs(fc) < std::fabs(fb)) {
+            a = b; b = c; c = a;
+            fa = fb; fb = fc; fc = fa;
+        }
+        double tol = 2 * opt.RelTol * std::fabs(b) + 0.5 * opt.XTol;
+        double m   = 0.5 * (c - b);
+        if (std::fabs(m) <= tol || fb == 0 || std::fabs(fb) <= opt.FTol) {
+            rec.Finish(b, fb, true);
+            return res;
+        }
+        if (std::fabs(e) >= tol && std::fabs(fa) > std::fabs(fb)) {
+            double s = fb / fa, p, q;
+            if (a == c) {
+                p = 2 * m * s;
+                q = 1 - s;
+            }
+            else {
+                double r = fb / fc;
+                q = fa / fc;
+                p = s * (2 * m * q * (q - r) - (b - a) * (r - 1));
+                q = (q - 1) * (r - 1) * (s - 1);
+            }
+            if (p > 0) q = -q; else p = -p;
+            if (2 * p < std::fmin(3 * m * q - std::fabs(tol * q), std::fabs(e * q))) {
+                e = d;
+                d = p / q;
+            }
+            else {
+                d = m; e = m;
+            }
+        }
+        else {
+            d = m; e = m;
+        }
+        a = b; fa = fb;
+        b += std::fabs(d) > tol ? d : (m > 0 ? tol : -tol);
+        fb = rec(b);
+        rec.Record(b, fb);
+        res.Iterations = i + 1;
+    }
+    rec.Finish(b, fb, false);
+    return res;
+}
+
+// Runs the given method on [a,b]. Newton starts from the midpoint and needs df;
+// Secant starts from the two endpoints.
+template <class F, class DF>
+RootResult SolveRoot(int method, F f, DF df, double a, double b, const RootOptions& opt = RootOptions()) {
+    switch (method) {
+        case RootMethod_Bisection: return Bisection(f, a, b, opt);
+        case RootMethod_Newton:    return Newton(f, df, (a + b) / 2, opt);
+        case RootMethod_Secant:    return Secant(f, a, b, opt);
+        case RootMethod_Illinois:  return Illinois(f, a, b, opt);
+        case RootMethod_Ridders:   return Ridders(f, a, b, opt);
+        default:                   return Brent(f, a, b, opt);
+    }
+}
+
+} // namespace Hamzstlab
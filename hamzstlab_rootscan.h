@@ -0,0 +1,167 @@
+// Hamzstlab Mathematics: all roots of f on an interval
+//
+// FindAllRoots samples f on a uniform grid over [a,b], collects every sign
+// change as a bracket and every local minimum of |f| without a sign change as
+// a possible tangent (even multiplicity) root, then refines all candidates
+// concurrently with ParallelFor. Brackets are refined with Brent; tangent
+// candidates are minimized with golden-section search and accepted when
+// |f| <= TangentTol at the minimizer.
+//
+// f is called from several threads at once and must not modify shared state.
+
+#pragma once
+
+#include "hamzstlab_roots.h"
+#include "hamzstlab_parallel.h"
+#include <algorithm>
+
+namespace Hamzstlab {
+
+enum RootKind {
+    RootKind_SignChange,
+    RootKind_Tangent
+};
+
+struct RootScanOptions {
+    int         Samples;     // grid intervals over [a,b]
+    double      TangentTol;  // accept a tangent root when |f| <= TangentTol
+    int         Threads;     // <= 0 uses all cores
+    RootOptions Refine;
+    RootScanOptions() { Samples = 1000; TangentTol = 1e-10; Threads = 0; }
+};
+
+struct RootScanResult {
+    std::vector<double> Roots, FRoots;
+    std::vector<int>    Kinds;
+    int                 Brackets;
+    int                 TangentCandidates;
+    int                 Evaluations;
+    double              Seconds;
+    RootScanResult() { Brackets = TangentCandidates = Evaluations = 0; Seconds = 0; }
+};
+
+namespace detail {
+
+struct RootCandidate {
+    double A, B;
+    int    Kind;
+};
+
+struct RootFound {
+    double X, FX;
+    int    Kind;
+    bool operator<(const RootFound& o) const { return X < o.X; }
+};
+
+// Golden-section minimization of |f| on [a,b]; returns the minimizer.
+template <class F>
+double MinimizeAbs(const F& f, double a, double b, double xtol, int& evals, double& fmin) {
+    const double g = 0.6180339887498949;
+    double c = b - g * (b - a), d = a + g * (b - a);
+    double fc = std::fabs(f(c)), fd = std::fabs(f(d));
+    evals += 2;
+    for (int i = 0; i < 200 && std::fabs(b - a) > xtol; ++i) {
+        if (fc < fd) { b = d; d = c; fd = fc; c = b - g * (b - a); fc = std::fabs(f(c)); }
+        else         { a = c; c = d; fc = fd; d = a + g * (b - a); fd = std::fabs(f(d)); }
+        ++evals;
+    }
+    double x = fc < fd ? c : d;
+    fmin = f(x);
+    ++evals;
+    return x;
+}
+
+} // namespace detail
+
+template <class F>
+RootScanResult FindAllRoots(const F& f, double a, double b, const RootScanOptions& opt = RootScanOptions()) {
+    RootScanResult res;
+    detail::RootClock::time_point t0 = detail::RootClock::now();
+    const int n = opt.Samples > 1 ? opt.Samples : 2;
+    const double h = (b - a) / n;
+
+    // sample
+    std::vector<double> xs(n + 1), ys(n + 1);
+    ParallelFor(n + 1, 256, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            xs[i] = i == n ? b : a + i * h;
+            ys[i] = f(xs[i]);
+        }
+    }, opt.Threads);
+    res.Evaluations = n + 1;
+
+    // detect
+    std::vector<detail::RootCandidate> cand;
+    std::vector<detail::RootFound>     found;
+    for (int i = 0; i <= n; ++i) {
+        if (ys[i] == 0) {
+            detail::RootFound r = { xs[i], 0.0, RootKind_SignChange };
+            found.push_back(r);
+            continue;
+        }
+        if (i < n && ys[i + 1] != 0 && !detail::SameSign(ys[i], ys[i + 1])) {
+            detail::RootCandidate c = { xs[i], xs[i + 1], RootKind_SignChange };
+            cand.push_back(c);
+            res.Brackets++;
+        }
+        if (i > 0 && i < n && detail::SameSign(ys[i - 1], ys[i]) && detail::SameSign(ys[i], ys[i + 1]) &&
+            std::fabs(ys[i]) < std::fabs(ys[i - 1]) && std::fabs(ys[i]) <= std::fabs(ys[i + 1])) {
+            detail::RootCandidate c = { xs[i - 1], xs[i + 1], RootKind_Tangent };
+            cand.push_back(c);
+            res.TangentCandidates++;
+        }
+    }
+
+    // refine
+    std::vector< std::vector<detail::RootFound> > out(cand.size());
+    std::atomic<int> evals(0);
+    ParallelFor((int)cand.size(), 1, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const detail::RootCandidate& c = cand[i];
+            if (c.Kind == RootKind_SignChange) {
+                RootResult r = Brent(f, c.A, c.B, opt.Refine);
+                evals += r.Evaluations;
+                detail::RootFound rf = { r.Root, r.FRoot, RootKind_SignChange };
+                out[i].push_back(rf);
+                continue;
+            }
+            int e = 0;
+            double fm;
+            double xm = detail::MinimizeAbs(f, c.A, c.B, opt.Refine.XTol, e, fm);
+            double fa = f(c.A);
+            ++e;
+            if (fm != 0 && !detail::SameSign(fm, fa)) {
+                // the minimum dips through zero: two close simple roots
+                RootResult r1 = Brent(f, c.A, xm, opt.Refine);
+                RootResult r2 = Brent(f, xm, c.B, opt.Refine);
+                e += r1.Evaluations + r2.Evaluations;
+                detail::RootFound f1 = { r1.Root, r1.FRoot, RootKind_SignChange };
+                detail::RootFound f2 = { r2.Root, r2.FRoot, RootKind_SignChange };
+                out[i].push_back(f1);
+                out[i].push_back(f2);
+            }
+            else if (std::fabs(fm) <= opt.TangentTol) {
+                detail::RootFound rf = { xm, fm, RootKind_Tangent };
+                out[i].push_back(rf);
+            }
+            evals += e;
+        }
+    }, opt.Threads);
+    res.Evaluations += evals;
+
+    for (size_t i = 0; i < out.size(); ++i)
+        found.insert(found.end(), out[i].begin(), out[i].end());
+    std::sort(found.begin(), found.end());
+    const double merge = 4 * (opt.Refine.XTol + opt.Refine.RelTol * (std::fabs(a) + std::fabs(b)));
+    for (size_t i = 0; i < found.size(); ++i) {
+        if (!res.Roots.empty() && found[i].X - res.Roots.back() <= merge)
+            continue;
+        res.Roots.push_back(found[i].X);
+        res.FRoots.push_back(found[i].FX);
+        res.Kinds.push_back(found[i].Kind);
+    }
+    res.Seconds = std::chrono::duration<double>(detail::RootClock::now() - t0).count();
+    return res;
+}
+
+} // namespace Hamzstlab
@@ -0,0 +1,128 @@
+// Hamzstlab Mathematics: adaptive curve sampling for function plots
+//
+// Instead of a fixed array of samples, CurveSampler evaluates y = f(x) over the
+// visible x range of the current plot and refines recursively until the
+// polyline is within PixelTol pixels of the curve:
+//
+//   static Hamzstlab::CurveSampler curve;
+//   if (ImPlot::BeginPlot("f")) {
+//       ImPlot::SetupAxes("x","y");
+//       curve.Update(f, params_changed);   // after Setup*, before plotting
+//       curve.Plot("f(x)");
+//       ImPlot::EndPlot();
+//   }
+//
+// A segment is split when the midpoint deviates from the chord by more than
+// PixelTol pixels, when f changes sign across it (so zero crossings are drawn
+// at pixel accuracy), or when f is not finite at one end (a pole or a domain
+// edge, emitted as NaN to break the line). Segments lying entirely above or
+// below the view are not refined. Zooming in resamples at the new scale and
+// zooming out no longer pays for detail that is smaller than a pixel.
+
+#pragma once
+
+#include "implot.h"
+#include <cmath>
+
+namespace Hamzstlab {
+
+struct CurveSampleOptions {
+    double PixelTol;       // max distance in pixels between chord and curve
+    double MinPixels;      // do not split segments narrower than this
+    double InitialPixels;  // width of the initial uniform segments
+    int    MaxDepth;       // max recursive splits of an initial segment
+    CurveSampleOptions() { PixelTol = 0.25; MinPixels = 0.5; InitialPixels = 8; MaxDepth = 16; }
+};
+
+class CurveSampler {
+public:
+    ImVector<double>   Xs, Ys;
+    int                Evaluations;   // f evaluations of the last sampling
+    CurveSampleOptions Options;
+
+    CurveSampler() { Evaluations = 0; X0 = X1 = Y0 = Y1 = 0; W = H = 0; }
+
+    // Samples f over [x0,x1] for a view of y0..y1 that is w x h pixels.
+    template <class F>
+    void Sample(const F& f, double x0, double x1, double y0, double y1, double w, double h) {
+        Xs.resize(0);
+        Ys.resize(0);
+        Evaluations = 0;
+        if (!(x1 > x0) || w <= 0 || h <= 0)
+            return;
+        PxPerX = w / (x1 - x0);
+        PxPerY = h / (y1 > y0 ? y1 - y0 : 1);
+        YMin = y0 < y1 ? y0 : y1;
+        YMax = y0 < y1 ? y1 : y0;
+        int n = (int)(w / Options.InitialPixels);
+        if (n < 4) n = 4;
+        double a = x0, fa = Eval(f, a);
+        Emit(a, fa);
+        for (int i = 1; i <= n; ++i) {
+            double b = i == n ? x1 : x0 + (x1 - x0) * i / n;
+            double fb = Eval(f, b);
+            Refine(f, a, fa, b, fb, 0);
+            a = b; fa = fb;
+        }
+    }
+
+    // Resamples f over the current plot's x limits when the limits, the plot size
+    // or f itself (changed = true) differ from the last call. Call inside
+    // BeginPlot/EndPlot after the Setup calls. Returns true if it resampled.
+    template <class F>
+    bool Update(const F& f, bool changed = false) {
+        ImPlotRect lims = ImPlot::GetPlotLimits();
+        ImVec2     size = ImPlot::GetPlotSize();
+        if (!changed && lims.X.Min == X0 && lims.X.Max == X1 && lims.Y.Min == Y0 && lims.Y.Max == Y1 && size.x == W && size.y == H)
+            return false;
+        X0 = lims.X.Min; X1 = lims.X.Max; Y0 = lims.Y.Min; Y1 = lims.Y.Max; W = size.x; H = size.y;
+        Sample(f, X0, X1, Y0, Y1, W, H);
+        return true;
+    }
+
+    void Plot(const char* label, ImPlotLineFlags flags = 0) const {
+        ImPlot::PlotLine(label, Xs.Data, Ys.Data, Xs.Size, flags);
+    }
+
+private:
+    double X0, X1, Y0, Y1;
+    float  W, H;
+    double PxPerX, PxPerY, YMin, YMax;
+
+    template <class F>
+    double Eval(const F& f, double x) { ++Evaluations; return f(x); }
+
+    void Emit(double x, double y) {
+        Xs.push_back(x);
+        Ys.push_back(std::isfinite(y) ? y : NAN);
+    }
+
+    // Emits the interior samples of (a,b) and then b.
+    template <class F>
+    void Refine(const F& f, double a, double fa, double b, double fb, int depth) {
+        const double px = (b - a) * PxPerX;
+        if (depth < Options.MaxDepth && px > Options.MinPixels) {
+            const bool finite = std::isfinite(fa) && std::isfinite(fb);
+            const bool above  = finite && fa > YMax && fb > YMax;
+            const bool below  = finite && fa < YMin && fb < YMin;
+            double m = a + (b - a) / 2, fm = Eval(f, m);
+            bool split;
+            if (!finite || !std::isfinite(fm))
+                split = true;
+            else if ((above && fm > YMax) || (below && fm < YMin))
+                split = false;
+            else
+                split = std::fabs(fm - (fa + fb) / 2) * PxPerY > Options.PixelTol ||
+                        ((fa < 0) != (fb < 0) && px > 1);
+            if (split) {
+                Refine(f, a, fa, m, fm, depth + 1);
+                Refine(f, m, fm, b, fb, depth + 1);
+                return;
+            }
+            Emit(m, fm);
+        }
+        Emit(b, fb);
+    }
+};
+
+} // namespace Hamzstlab
@@ -0,0 +1,297 @@
+// Hamzstlab Mathematics: Monte Carlo for scalar SDEs dX = a(t, X) dt + b(t, X) dW
+//
+// The equation is a small object
+//
+//   struct Sde {
+//       double Drift(double t, double x) const;         // a
+//       double Diffusion(double t, double x) const;     // b
+//       double DiffusionDx(double t, double x) const;   // db/dx, used by Milstein
+//   };
+//
+// and SimulateSde runs many paths with a fixed step, returning quantile bands
+// of X at every step instead of the paths themselves:
+//
+//   Hamzstlab::SdeOptions opt;                 // Steps, Paths, Seed, ...
+//   std::vector<double> levels = { 0.05, 0.25, 0.5, 0.75, 0.95 };
+//   Hamzstlab::SdeBands b = Hamzstlab::SimulateSde(Hamzstlab::SdeMethod_EulerMaruyama, Gbm(), 0.0, 1.0, 1.0, opt, levels);
+//   ImPlot::PlotShaded("5-95%", b.Ts.data(), b.Band(0), b.Band(4), b.Size());
+//
+// Paths are simulated in blocks spread over the background thread pool
+// (SimulateSde is meant to run on a JobRunner worker, see hamzstlab_parallel.h).
+// Path i draws its Brownian increments from Philox (Seed, i, step / 4), so
+// every path is the same whichever thread runs it. Each step keeps a histogram
+// of the states over a range taken from a pilot run of the first PilotPaths
+// paths, and the quantiles are read off the histograms: memory is
+// O(Steps * Bins) for any number of paths, and since the counts are integers
+// the bands do not depend on the thread count either.
+//
+// While the blocks run, the overload taking a `progress` functor hands it the
+// bands of the paths finished so far every ProgressInterval seconds, so a long
+// simulation can be drawn as it converges.
+
+#pragma once
+
+#include "hamzstlab_parallel.h"
+#include "hamzstlab_random.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace Hamzstlab {
+
+enum SdeMethod {
+    SdeMethod_EulerMaruyama,
+    SdeMethod_Milstein,
+    SdeMethod_COUNT
+};
+
+inline const char* SdeMethodName(int method) {
+    static const char* names[] = { "Euler-Maruyama", "Milstein" };
+    return method >= 0 && method < SdeMethod_COUNT ? names[method] : "";
+}
+
+// dX = Mu X dt + Sigma X dW
+struct GeometricBrownianMotion {
+    double Mu, Sigma;
+    double Drift(double, double x) const       { return Mu * x; }
+    double Diffusion(double, double x) const   { return Sigma * x; }
+    double DiffusionDx(double, double) const   { return Sigma; }
+    double Mean(double t, double x0) const     { return x0 * std::exp(Mu * t); }
+};
+
+// dX = Theta (Mu - X) dt + Sigma dW
+struct OrnsteinUhlenbeck {
+    double Theta, Mu, Sigma;
+    double Drift(double, double x) const       { return Theta * (Mu - x); }
+    double Diffusion(double, double) const     { return Sigma; }
+    double DiffusionDx(double, double) const   { return 0; }
+    double Mean(double t, double x0) const     { return Mu + (x0 - Mu) * std::exp(-Theta * t); }
+};
+
+struct SdeOptions {
+    int       Steps;
+    long long Paths;
+    uint64_t  Seed;
+    int       Bins;         // histogram bins per step
+    int       PilotPaths;   // paths that fix the histogram ranges
+    int       BlockPaths;   // paths per task
+    int       Threads;      // <= 0 uses all cores
+    double    ProgressInterval;   // seconds between partial bands
+    SdeOptions() { Steps = 250; Paths = 100000; Seed = 0; Bins = 512; PilotPaths = 1024; BlockPaths = 1024; Threads = 0; ProgressInterval = 0.1; }
+};
+
+struct SdeBands {
+    std::vector<double> Ts;
+    std::vector<double> Levels;
+    std::vector<double> Values;     // Levels.size() x (Steps + 1), one band after the other
+    long long           Paths;      // paths simulated (fewer if cancelled)
+    bool                Complete;
+    double              Seconds;
+    SdeBands() { Paths = 0; Complete = false; Seconds = 0; }
+    int Size() const { return (int)Ts.size(); }
+    const double* Band(int level) const { return &Values[(size_t)level * Ts.size()]; }
+};
+
+struct SdeNeverCancel {
+    bool operator()() const { return false; }
+};
+
+struct SdeNoProgress {
+    void operator()(const SdeBands&) const { }
+};
+
+namespace detail {
+
+template <class S>
+inline double SdeStep(int method, const S& sde, double t, double x, double dt, double sqrt_dt, double z) {
+    const double dw = sqrt_dt * z;
+    const double b = sde.Diffusion(t, x);
+    double x1 = x + sde.Drift(t, x) * dt + b * dw;
+    if (method == SdeMethod_Milstein)
+        x1 += 0.5 * b * sde.DiffusionDx(t, x) * (dw * dw - dt);
+    return x1;
+}
+
+// Advances paths [first, first + count) step by step; visit(step, xs, count)
+// sees the states after every step.
+template <class S, class V>
+void SdeBlock(int method, const S& sde, double t0, double x0, double t1, const SdeOptions& opt, long long first, int count, std::vector<double>& xs,
+              std::vector<double>& zs, std::vector<uint32_t>& bits, V& visit) {
+    const double dt = (t1 - t0) / opt.Steps, sqrt_dt = std::sqrt(std::fabs(dt));
+    xs.assign(count, x0);
+    zs.resize((size_t)count * 4);
+    bits.resize((size_t)count * 4);
+    for (int k = 0; k < opt.Steps; ++k) {
+        if (k % 4 == 0) {
+            // the next four increments of every path
+            PhiloxBitsN(opt.Seed, (uint64_t)first, (uint64_t)(k / 4), count, bits.data());
+            for (int i = 0; i < count; ++i)
+                Normals4(&bits[(size_t)i * 4], &zs[(size_t)i * 4]);
+        }
+        const double t = t0 + k * dt;
+        for (int i = 0; i < count; ++i)
+            xs[i] = SdeStep(method, sde, t, xs[i], dt, sqrt_dt, zs[(size_t)i * 4 + k % 4]);
+        visit(k + 1, xs.data(), count);
+    }
+}
+
+struct SdeRange {
+    std::vector<double>& Lo;
+    std::vector<double>& Hi;
+    void operator()(int step, const double* xs, int count) {
+        for (int i = 0; i < count; ++i) {
+            Lo[step] = std::min(Lo[step], xs[i]);
+            Hi[step] = std::max(Hi[step], xs[i]);
+        }
+    }
+};
+
+// Bins a block's states into a local histogram, then adds it to the shared one.
+struct SdeHistogram {
+    const std::vector<double>& Lo;
+    const std::vector<double>& Scale;
+    std::atomic<int>*          Counts;
+    int                        Bins;
+    std::vector<int>           Local;
+    void operator()(int step, const double* xs, int count) {
+        Local.assign(Bins, 0);
+        for (int i = 0; i < count; ++i) {
+            double u = (xs[i] - Lo[step]) * Scale[step];
+            // states outside the pilot range go to the end bins; NaN to the first
+            int bin = u >= 0 ? (u < Bins ? (int)u : Bins - 1) : 0;
+            ++Local[bin];
+        }
+        std::atomic<int>* row = Counts + (size_t)step * Bins;
+        for (int b = 0; b < Bins; ++b)
+            if (Local[b]) row[b].fetch_add(Local[b], std::memory_order_relaxed);
+    }
+};
+
+// Reads the quantiles of every step off its histogram, by linear interpolation
+// inside the bin where the cumulative count crosses them. Each row is scaled by
+// its own total, so a snapshot taken while blocks are still adding to the
+// histograms is consistent step by step.
+inline void SdeQuantiles(const std::atomic<int>* counts, const std::vector<double>& lo, const std::vector<double>& scale, int bins,
+                         double x0, SdeBands& out) {
+    const int steps = out.Size() - 1;
+    const std::vector<double>& levels = out.Levels;
+    out.Values.resize(levels.size() * (steps + 1));
+    for (int k = 0; k <= steps; ++k) {
+        const std::atomic<int>* row = &counts[(size_t)k * bins];
+        long long total = 0;
+        if (k > 0)
+            for (int b = 0; b < bins; ++b)
+                total += row[b].load(std::memory_order_relaxed);
+        for (size_t l = 0; l < levels.size(); ++l) {
+            double v = x0;
+            if (total > 0) {
+                const double target = levels[l] * total;
+                long long cum = 0;
+                int b = 0;
+                for (; b < bins - 1 && cum + row[b].load(std::memory_order_relaxed) < target; ++b)
+                    cum += row[b].load(std::memory_order_relaxed);
+                const int n = row[b].load(std::memory_order_relaxed);
+                const double frac = n > 0 ? (target - cum) / n : 0.5;
+                v = lo[k] + (b + std::min(std::max(frac, 0.0), 1.0)) / scale[k];
+            }
+            out.Values[l * (steps + 1) + k] = v;
+        }
+    }
+}
+
+} // namespace detail
+
+// One path of the ensemble, the same as path `index` inside SimulateSde.
+template <class S>
+void SdePath(int method, const S& sde, double t0, double x0, double t1, const SdeOptions& opt, long long index, std::vector<double>& xs) {
+    xs.resize(opt.Steps + 1);
+    xs[0] = x0;
+    std::vector<double> state, zs;
+    std::vector<uint32_t> bits;
+    struct Record {
+        std::vector<double>& Xs;
+        void operator()(int step, const double* x, int) { Xs[step] = x[0]; }
+    } record = { xs };
+    detail::SdeBlock(method, sde, t0, x0, t1, opt, index, 1, state, zs, bits, record);
+}
+
+template <class S, class C, class P>
+SdeBands SimulateSde(int method, const S& sde, double t0, double x0, double t1, const SdeOptions& opt, const std::vector<double>& levels,
+                     const C& cancelled, P& progress) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const int steps = opt.Steps, bins = opt.Bins;
+    SdeBands out;
+    out.Levels = levels;
+    out.Ts.resize(steps + 1);
+    for (int k = 0; k <= steps; ++k)
+        out.Ts[k] = t0 + (t1 - t0) * k / steps;
+
+    // histogram ranges from the pilot paths, widened by half their width on each side
+    std::vector<double> lo(steps + 1, HUGE_VAL), hi(steps + 1, -HUGE_VAL), scale(steps + 1);
+    std::vector<double> xs, zs;
+    std::vector<uint32_t> bits;
+    detail::SdeRange range = { lo, hi };
+    detail::SdeBlock(method, sde, t0, x0, t1, opt, 0, (int)std::min<long long>(opt.PilotPaths, opt.Paths), xs, zs, bits, range);
+    lo[0] = hi[0] = x0;
+    for (int k = 0; k <= steps; ++k) {
+        double w = hi[k] - lo[k];
+        if (!(w > 0)) w = 1e-9 * (1 + std::fabs(lo[k]));
+        if (!(w < HUGE_VAL)) { lo[k] = -1; w = 2; }
+        lo[k] -= 0.5 * w;
+        scale[k] = bins / (2 * w);
+    }
+
+    std::vector< std::atomic<int> > counts((size_t)(steps + 1) * bins);
+    const long long blocks = (opt.Paths + opt.BlockPaths - 1) / opt.BlockPaths;
+    std::atomic<long long> done(0);
+    // the calling thread takes blocks like the pool threads, and publishes the
+    // partial bands between two of its blocks
+    const std::thread::id caller = std::this_thread::get_id();
+    std::chrono::steady_clock::time_point last = start;
+    ParallelFor(GetBackgroundThreadPool(), (int)blocks, 1, [&](int begin, int end) {
+        std::vector<double> bx, bz;
+        std::vector<uint32_t> bb;
+        detail::SdeHistogram hist = { lo, scale, counts.data(), bins, std::vector<int>() };
+        for (int b = begin; b < end; ++b) {
+            if (cancelled())
+                return;
+            const long long first = (long long)b * opt.BlockPaths;
+            const int count = (int)std::min<long long>(opt.BlockPaths, opt.Paths - first);
+            detail::SdeBlock(method, sde, t0, x0, t1, opt, first, count, bx, bz, bb, hist);
+            done.fetch_add(count);
+            if (std::this_thread::get_id() != caller)
+                continue;
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (std::chrono::duration<double>(now - last).count() >= opt.ProgressInterval && done.load() < opt.Paths) {
+                out.Paths = done.load();
+                detail::SdeQuantiles(counts.data(), lo, scale, bins, x0, out);
+                out.Seconds = std::chrono::duration<double>(now - start).count();
+                progress((const SdeBands&)out);
+                last = now;
+            }
+        }
+    }, opt.Threads);
+    out.Paths = done.load();
+    out.Complete = out.Paths == opt.Paths;
+
+    detail::SdeQuantiles(counts.data(), lo, scale, bins, x0, out);
+    out.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return out;
+}
+
+template <class S, class C>
+SdeBands SimulateSde(int method, const S& sde, double t0, double x0, double t1, const SdeOptions& opt, const std::vector<double>& levels,
+                     const C& cancelled) {
+    SdeNoProgress none;
+    return SimulateSde(method, sde, t0, x0, t1, opt, levels, cancelled, none);
+}
+
+template <class S>
+SdeBands SimulateSde(int method, const S& sde, double t0, double x0, double t1, const SdeOptions& opt, const std::vector<double>& levels) {
+    return SimulateSde(method, sde, t0, x0, t1, opt, levels, SdeNeverCancel());
+}
+
+} // namespace Hamzstlab
@@ -0,0 +1,99 @@
+// Hamzstlab Mathematics: four-lane double vector
+//
+// Vec4d holds four doubles and supports the arithmetic needed to write a
+// right-hand side or a slope function once as a template and run it on four
+// lanes at a time:
+//
+//   template <typename T> T Slope(const T& t, const T& y) { return 3.0 - 2.0 * t - 0.5 * y; }
+//   Hamzstlab::Vec4d m = Slope(Hamzstlab::Vec4d::Load(ts), Hamzstlab::Vec4d::Load(ys));
+//
+// With __AVX__ defined (e.g. -mavx) it maps to one __m256d register, otherwise
+// to a plain array that the compiler can still vectorize with SSE2.
+
+#pragma once
+
+#include <cmath>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace Hamzstlab {
+
+#if defined(__AVX__)
+
+struct Vec4d {
+    __m256d V;
+    Vec4d() { }
+    Vec4d(double s) : V(_mm256_set1_pd(s)) { }
+    Vec4d(__m256d v) : V(v) { }
+    static Vec4d Load(const double* p)        { return Vec4d(_mm256_loadu_pd(p)); }
+    void Store(double* p) const               { _mm256_storeu_pd(p, V); }
+    static Vec4d Ramp(double a, double step)  { return Vec4d(_mm256_set_pd(a + 3 * step, a + 2 * step, a + step, a)); }
+};
+
+inline Vec4d operator+(const Vec4d& a, const Vec4d& b) { return _mm256_add_pd(a.V, b.V); }
+inline Vec4d operator-(const Vec4d& a, const Vec4d& b) { return _mm256_sub_pd(a.V, b.V); }
+inline Vec4d operator*(const Vec4d& a, const Vec4d& b) { return _mm256_mul_pd(a.V, b.V); }
+inline Vec4d operator/(const Vec4d& a, const Vec4d& b) { return _mm256_div_pd(a.V, b.V); }
+inline Vec4d operator-(const Vec4d& a)                 { return _mm256_sub_pd(_mm256_setzero_pd(), a.V); }
+inline Vec4d sqrt(const Vec4d& a)                      { return _mm256_sqrt_pd(a.V); }
+inline Vec4d fmin(const Vec4d& a, const Vec4d& b)      { return _mm256_min_pd(a.V, b.V); }
+inline Vec4d fmax(const Vec4d& a, const Vec4d& b)      { return _mm256_max_pd(a.V, b.V); }
+inline Vec4d fabs(const Vec4d& a)                      { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.V); }
+// Per lane: c ? a : b, where c is a comparison result below.
+inline Vec4d Select(const Vec4d& c, const Vec4d& a, const Vec4d& b) { return _mm256_blendv_pd(b.V, a.V, c.V); }
+inline Vec4d operator<(const Vec4d& a, const Vec4d& b) { return _mm256_cmp_pd(a.V, b.V, _CMP_LT_OQ); }
+inline Vec4d operator>(const Vec4d& a, const Vec4d& b) { return _mm256_cmp_pd(a.V, b.V, _CMP_GT_OQ); }
+
+#else
+
+struct Vec4d {
+    double V[4];
+    Vec4d() { }
+    Vec4d(double s) { V[0] = V[1] = V[2] = V[3] = s; }
+    static Vec4d Load(const double* p)        { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = p[i]; return r; }
+    void Store(double* p) const               { for (int i = 0; i < 4; ++i) p[i] = V[i]; }
+    static Vec4d Ramp(double a, double step)  { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = a + i * step; return r; }
+};
+
+#define HZ_VEC4D_BINARY(op) \
+    inline Vec4d operator op(const Vec4d& a, const Vec4d& b) { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = a.V[i] op b.V[i]; return r; }
+HZ_VEC4D_BINARY(+)
+HZ_VEC4D_BINARY(-)
+HZ_VEC4D_BINARY(*)
+HZ_VEC4D_BINARY(/)
+#undef HZ_VEC4D_BINARY
+
+inline Vec4d operator-(const Vec4d& a)                 { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = -a.V[i]; return r; }
+inline Vec4d sqrt(const Vec4d& a)                      { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = std::sqrt(a.V[i]); return r; }
+inline Vec4d fmin(const Vec4d& a, const Vec4d& b)      { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = a.V[i] < b.V[i] ? a.V[i] : b.V[i]; return r; }
+inline Vec4d fmax(const Vec4d& a, const Vec4d& b)      { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = a.V[i] > b.V[i] ? a.V[i] : b.V[i]; return r; }
+inline Vec4d fabs(const Vec4d& a)                      { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = std::fabs(a.V[i]); return r; }
+// Comparisons give 1 (true) or 0 per lane in this fallback.
+inline Vec4d Select(const Vec4d& c, const Vec4d& a, const Vec4d& b) { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = c.V[i] != 0 ? a.V[i] : b.V[i]; return r; }
+inline Vec4d operator<(const Vec4d& a, const Vec4d& b) { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = a.V[i] < b.V[i]; return r; }
+inline Vec4d operator>(const Vec4d& a, const Vec4d& b) { Vec4d r; for (int i = 0; i < 4; ++i) r.V[i] = a.V[i] > b.V[i]; return r; }
+
+#endif
+
+inline Vec4d operator+(const Vec4d& a, double b) { return a + Vec4d(b); }
+inline Vec4d operator+(double a, const Vec4d& b) { return Vec4d(a) + b; }
+inline Vec4d operator-(const Vec4d& a, double b) { return a - Vec4d(b); }
+inline Vec4d operator-(double a, const Vec4d& b) { return Vec4d(a) - b; }
+inline Vec4d operator*(const Vec4d& a, double b) { return a * Vec4d(b); }
+inline Vec4d operator*(double a, const Vec4d& b) { return Vec4d(a) * b; }
+inline Vec4d operator/(const Vec4d& a, double b) { return a / Vec4d(b); }
+inline Vec4d operator/(double a, const Vec4d& b) { return Vec4d(a) / b; }
+
+// exp, log, sin, cos and atan go lane by lane through libm, so templates that
+// call them still compile for Vec4d; the arithmetic around them stays vector.
+#define HZ_VEC4D_LIBM(fn) \
+    inline Vec4d fn(const Vec4d& a) { double v[4]; a.Store(v); for (int i = 0; i < 4; ++i) v[i] = std::fn(v[i]); return Vec4d::Load(v); }
+HZ_VEC4D_LIBM(exp)
+HZ_VEC4D_LIBM(log)
+HZ_VEC4D_LIBM(sin)
+HZ_VEC4D_LIBM(cos)
+HZ_VEC4D_LIBM(atan)
+#undef HZ_VEC4D_LIBM
+
+} // namespace Hamzstlab
@@ -0,0 +1,423 @@
+// Hamzstlab Mathematics: implicit integrators for stiff systems y' = f(t, y)
+//
+// Same right-hand side, options and result as hamzstlab_ode.h:
+//
+//   Hamzstlab::OdeResult r = Hamzstlab::SolveStiff(Hamzstlab::StiffMethod_BDF, Rhs(), 0.0, y0, n, 3000.0, opt);
+//
+// Methods:
+//   ImplicitEuler  backward Euler with step-size control (BDF of order 1)
+//   BDF            variable-order (1..5), variable-step backward differentiation
+//                  formulas in the quasi-constant step form of Shampine & Reichelt
+//                  (the scheme of MATLAB ode15s / SciPy BDF, without the NDF terms)
+//   Rosenbrock     linearly implicit 2(3) pair of MATLAB ode23s
+//
+// Jacobians are taken by finite differences of f (n extra calls). The BDF
+// solver keeps the Jacobian and the LU factors of I - c J for as long as the
+// simplified Newton iteration converges: it refactors only when the step or
+// order changes and evaluates a new Jacobian only when Newton fails with the
+// old one. The Rosenbrock solver needs J at the start of every step but reuses
+// it when a step is rejected. OdeResult::Jacobians and ::Factorizations count
+// both. With OdeOptions::Dense both keep f(t, y) per step for the Hermite
+// interpolant of OdeResult::Eval (one extra call of f per BDF step).
+
+#pragma once
+
+#include "hamzstlab_ode.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace Hamzstlab {
+
+enum StiffMethod {
+    StiffMethod_ImplicitEuler,
+    StiffMethod_BDF,
+    StiffMethod_Rosenbrock,
+    StiffMethod_COUNT
+};
+
+inline const char* StiffMethodName(int method) {
+    static const char* names[] = { "Implicit Euler", "BDF 1-5", "Rosenbrock 2(3)" };
+    return method >= 0 && method < StiffMethod_COUNT ? names[method] : "";
+}
+
+namespace detail {
+
+// In-place LU factorization with partial pivoting of the row-major n x n matrix a.
+inline bool LUFactor(double* a, int* piv, int n) {
+    for (int k = 0; k < n; ++k) {
+        int p = k;
+        double best = std::fabs(a[k * n + k]);
+        for (int i = k + 1; i < n; ++i)
+            if (std::fabs(a[i * n + k]) > best) { best = std::fabs(a[i * n + k]); p = i; }
+        piv[k] = p;
+        if (best == 0 || !std::isfinite(best))
+            return false;
+        if (p != k)
+            for (int j = 0; j < n; ++j) std::swap(a[k * n + j], a[p * n + j]);
+        for (int i = k + 1; i < n; ++i) {
+            double m = a[i * n + k] /= a[k * n + k];
+            if (m != 0)
+                for (int j = k + 1; j < n; ++j) a[i * n + j] -= m * a[k * n + j];
+        }
+    }
+    return true;
+}
+
+// Solves A x = b in place with the factors of LUFactor.
+inline void LUSolve(const double* a, const int* piv, int n, double* b) {
+    for (int k = 0; k < n; ++k)
+        if (piv[k] != k) std::swap(b[k], b[piv[k]]);
+    for (int i = 1; i < n; ++i)
+        for (int j = 0; j < i; ++j) b[i] -= a[i * n + j] * b[j];
+    for (int i = n - 1; i >= 0; --i) {
+        for (int j = i + 1; j < n; ++j) b[i] -= a[i * n + j] * b[j];
+        b[i] /= a[i * n + i];
+    }
+}
+
+// Factors I - c J into lu. Returns false if it is singular.
+inline bool FactorNewtonMatrix(const std::vector<double>& jac, double c, int n, std::vector<double>& lu, std::vector<int>& piv, int& count) {
+    for (int i = 0; i < n * n; ++i)
+        lu[i] = -c * jac[i];
+    for (int i = 0; i < n; ++i)
+        lu[i * n + i] += 1;
+    ++count;
+    return LUFactor(lu.data(), piv.data(), n);
+}
+
+inline double RmsNorm(const double* v, const double* scale, int n) {
+    double sum = 0;
+    for (int i = 0; i < n; ++i)
+        sum += (v[i] / scale[i]) * (v[i] / scale[i]);
+    return std::sqrt(sum / n);
+}
+
+// Rescales the backward differences D (rows 0..order) of the BDF interpolating
+// polynomial from step h to factor * h.
+inline void BDFChangeStep(std::vector<double>& D, int n, int order, double factor) {
+    double R[6][6], U[6][6], RU[6][6];
+    for (int j = 0; j <= order; ++j) { R[0][j] = 1; U[0][j] = 1; }
+    for (int i = 1; i <= order; ++i) {
+        R[i][0] = U[i][0] = 0;
+        for (int j = 1; j <= order; ++j) {
+            R[i][j] = R[i - 1][j] * (i - 1 - factor * j) / i;
+            U[i][j] = U[i - 1][j] * (i - 1 - 1.0 * j) / i;
+        }
+    }
+    for (int i = 0; i <= order; ++i)
+        for (int j = 0; j <= order; ++j) {
+            double acc = 0;
+            for (int k = 0; k <= order; ++k) acc += R[i][k] * U[k][j];
+            RU[i][j] = acc;
+        }
+    std::vector<double> out((size_t)(order + 1) * n, 0.0);
+    for (int i = 0; i <= order; ++i)
+        for (int k = 0; k <= order; ++k) {
+            const double w = RU[k][i];
+            if (w == 0) continue;
+            for (int m = 0; m < n; ++m) out[(size_t)i * n + m] += w * D[(size_t)k * n + m];
+        }
+    std::copy(out.begin(), out.end(), D.begin());
+}
+
+inline double Elapsed(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace detail
+
+// Forward-difference Jacobian J[i*n+j] = df_i/dy_j at (t, y), given fy = f(t, y).
+template <class F>
+void OdeJacobian(const F& f, double t, const double* y, const double* fy, int n, double* jac, int& evals) {
+    const double eps = std::sqrt(std::numeric_limits<double>::epsilon());
+    std::vector<double> yp(y, y + n), fp(n);
+    for (int j = 0; j < n; ++j) {
+        yp[j] = y[j] + eps * std::fmax(std::fabs(y[j]), 1.0);
+        const double d = yp[j] - y[j];
+        f(t, yp.data(), fp.data());
+        ++evals;
+        for (int i = 0; i < n; ++i)
+            jac[i * n + j] = (fp[i] - fy[i]) / d;
+        yp[j] = y[j];
+    }
+}
+
+// Variable-order BDF up to max_order (1 = implicit Euler).
+template <class F, class Observer>
+OdeResult SolveBDF(const F& f, double t0, const double* y0, int n, double t1, const OdeOptions& opt, int max_order, Observer& observe) {
+    const int    MaxOrder = 5, NewtonMaxIter = 4;
+    const double MinFactor = 0.2, MaxFactor = 10;
+    OdeResult res;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    max_order = std::max(1, std::min(max_order, MaxOrder));
+    const double dir  = t1 >= t0 ? 1.0 : -1.0;
+    const double hmax = opt.HMax > 0 ? opt.HMax : std::fabs(t1 - t0);
+    const double newton_tol = std::fmax(10 * std::numeric_limits<double>::epsilon() / opt.RelTol, std::fmin(0.03, std::sqrt(opt.RelTol)));
+    // gamma_k = sum_{j<=k} 1/j; error constant of order k is 1/(k+1)
+    double gamma[MaxOrder + 2], error_const[MaxOrder + 2];
+    gamma[0] = 0;
+    for (int k = 1; k <= MaxOrder + 1; ++k) gamma[k] = gamma[k - 1] + 1.0 / k;
+    for (int k = 0; k <= MaxOrder + 1; ++k) error_const[k] = 1.0 / (k + 1);
+
+    res.Dim = n;
+    res.Ts.push_back(t0);
+    res.Ys.insert(res.Ys.end(), y0, y0 + n);
+    std::vector<double> f0(n), jac((size_t)n * n), lu((size_t)n * n), D((size_t)(MaxOrder + 3) * n);
+    std::vector<double> ypred(n), ynew(n), psi(n), d(n), dy(n), scale(n), fv(n), err(n);
+    std::vector<int> piv(n);
+    f(t0, y0, f0.data());
+    res.Evaluations = 1;
+    if (opt.Dense)
+        res.Dys.insert(res.Dys.end(), f0.begin(), f0.end());
+    double h_abs = opt.H > 0 ? opt.H : OdeInitialStep(f, t0, y0, f0.data(), n, 1, dir, opt, res.Evaluations);
+    h_abs = std::fmin(h_abs, hmax);
+    OdeJacobian(f, t0, y0, f0.data(), n, jac.data(), res.Evaluations);
+    ++res.Jacobians;
+    for (int i = 0; i < n; ++i) {
+        D[i] = y0[i];
+        D[n + i] = f0[i] * h_abs * dir;
+    }
+    double t = t0;
+    int  order = 1, equal_steps = 0;
+    bool have_lu = false;
+
+    while (dir * (t1 - t) > 0) {
+        bool current_jac = false, accepted = false;
+        double h = 0, t_new = t, safety = 0.9, error_norm = 0;
+        while (!accepted) {
+            if (res.Steps + res.Rejected >= opt.MaxSteps || h_abs < opt.HMin) { res.Seconds = detail::Elapsed(start); return res; }
+            t_new = t + dir * h_abs;
+            if (dir * (t_new - t1) >= 0 || std::fabs(t1 - t_new) < 1e-9 * h_abs) {
+                t_new = t1;
+                detail::BDFChangeStep(D, n, order, std::fabs(t_new - t) / h_abs);
+                equal_steps = 0;
+                have_lu = false;
+            }
+            h = t_new - t;
+            h_abs = std::fabs(h);
+            // predictor from the interpolating polynomial, psi from the history
+            for (int i = 0; i < n; ++i) {
+                double p = 0, q = 0;
+                for (int k = 0; k <= order; ++k) p += D[(size_t)k * n + i];
+                for (int k = 1; k <= order; ++k) q += gamma[k] * D[(size_t)k * n + i];
+                ypred[i] = p;
+                psi[i] = q / gamma[order];
+                scale[i] = opt.AbsTol + opt.RelTol * std::fabs(p);
+            }
+            const double c = h / gamma[order];
+            bool converged = false;
+            int  iters = 0;
+            for (;;) {
+                if (!have_lu)
+                    have_lu = detail::FactorNewtonMatrix(jac, c, n, lu, piv, res.Factorizations);
+                // simplified Newton on y = ypred + d, with c f(t_new, y) - psi - d = 0
+                if (have_lu) {
+                    ynew = ypred;
+                    std::fill(d.begin(), d.end(), 0.0);
+                    double dy_norm_old = -1;
+                    for (iters = 1; iters <= NewtonMaxIter; ++iters) {
+                        f(t_new, ynew.data(), fv.data());
+                        ++res.Evaluations;
+                        bool finite = true;
+                        for (int i = 0; i < n; ++i) finite = finite && std::isfinite(fv[i]);
+                        if (!finite) break;
+                        for (int i = 0; i < n; ++i) dy[i] = c * fv[i] - psi[i] - d[i];
+                        detail::LUSolve(lu.data(), piv.data(), n, dy.data());
+                        const double dy_norm = detail::RmsNorm(dy.data(), scale.data(), n);
+                        const double rate = dy_norm_old < 0 ? -1 : dy_norm / dy_norm_old;
+                        if (rate >= 0 && (rate >= 1 || std::pow(rate, NewtonMaxIter - iters + 1) / (1 - rate) * dy_norm > newton_tol))
+                            break;
+                        for (int i = 0; i < n; ++i) { ynew[i] += dy[i]; d[i] += dy[i]; }
+                        if (dy_norm == 0 || (rate >= 0 && rate / (1 - rate) * dy_norm < newton_tol)) { converged = true; break; }
+                        dy_norm_old = dy_norm;
+                    }
+                }
+                if (converged || current_jac)
+                    break;
+                // the old Jacobian is the likely culprit: refresh it before shrinking h
+                f(t_new, ypred.data(), fv.data());
+                ++res.Evaluations;
+                OdeJacobian(f, t_new, ypred.data(), fv.data(), n, jac.data(), res.Evaluations);
+                ++res.Jacobians;
+                have_lu = false;
+                current_jac = true;
+            }
+            if (!converged) {
+                ++res.Rejected;
+                h_abs *= 0.5;
+                detail::BDFChangeStep(D, n, order, 0.5);
+                equal_steps = 0;
+                have_lu = false;
+                continue;
+            }
+            safety = 0.9 * (2 * NewtonMaxIter + 1) / (2 * NewtonMaxIter + std::min(iters, NewtonMaxIter));
+            for (int i = 0; i < n; ++i) {
+                scale[i] = opt.AbsTol + opt.RelTol * std::fabs(ynew[i]);
+                err[i] = error_const[order] * d[i];
+            }
+            error_norm = detail::RmsNorm(err.data(), scale.data(), n);
+            if (error_norm > 1) {
+                ++res.Rejected;
+                const double factor = std::fmax(MinFactor, safety * std::pow(error_norm, -1.0 / (order + 1)));
+                h_abs *= factor;
+                detail::BDFChangeStep(D, n, order, factor);
+                equal_steps = 0;
+                // Newton converged, so the LU factors are kept for the smaller step
+            }
+            else
+                accepted = true;
+        }
+        ++res.Steps;
+        ++equal_steps;
+        t = t_new;
+        res.Ts.push_back(t);
+        res.Ys.insert(res.Ys.end(), ynew.begin(), ynew.end());
+        if (opt.Dense) {
+            f(t, ynew.data(), fv.data());
+            ++res.Evaluations;
+            res.Dys.insert(res.Dys.end(), fv.begin(), fv.end());
+        }
+        if (!observe(res)) {
+            res.Stopped = true;
+            break;
+        }
+        // D^{j+1} y_n = D^j y_n - D^j y_{n-1}, with d = D^{order+1} y_n
+        for (int i = 0; i < n; ++i) {
+            D[(size_t)(order + 2) * n + i] = d[i] - D[(size_t)(order + 1) * n + i];
+            D[(size_t)(order + 1) * n + i] = d[i];
+        }
+        for (int k = order; k >= 0; --k)
+            for (int i = 0; i < n; ++i) D[(size_t)k * n + i] += D[(size_t)(k + 1) * n + i];
+        if (equal_steps < order + 1)
+            continue;
+        // after order + 1 equal steps, pick the order (k-1, k, k+1) allowing the largest step
+        const double inf = std::numeric_limits<double>::infinity();
+        double norm_m = inf, norm_p = inf;
+        if (order > 1) {
+            for (int i = 0; i < n; ++i) err[i] = error_const[order - 1] * D[(size_t)order * n + i];
+            norm_m = detail::RmsNorm(err.data(), scale.data(), n);
+        }
+        if (order < max_order) {
+            for (int i = 0; i < n; ++i) err[i] = error_const[order + 1] * D[(size_t)(order + 2) * n + i];
+            norm_p = detail::RmsNorm(err.data(), scale.data(), n);
+        }
+        const double fm = norm_m == inf ? 0 : (norm_m == 0 ? inf : std::pow(norm_m, -1.0 / order));
+        const double fk = error_norm == 0 ? inf : std::pow(error_norm, -1.0 / (order + 1));
+        const double fp = norm_p == inf ? 0 : (norm_p == 0 ? inf : std::pow(norm_p, -1.0 / (order + 2)));
+        double best = fk;
+        int delta = 0;
+        if (fm > best) { best = fm; delta = -1; }
+        if (fp > best) { best = fp; delta = 1; }
+        order += delta;
+        const double factor = std::fmin(std::fmin(MaxFactor, safety * best), hmax / h_abs);
+        h_abs *= factor;
+        detail::BDFChangeStep(D, n, order, factor);
+        equal_steps = 0;
+        have_lu = false;
+    }
+    res.Success = !res.Stopped;
+    res.Seconds = detail::Elapsed(start);
+    return res;
+}
+
+// Rosenbrock 2(3) pair of Shampine & Reichelt (MATLAB ode23s). W = I - h d J is
+// factored once per attempt; J and df/dt are evaluated once per accepted step.
+template <class F, class Observer>
+OdeResult SolveRosenbrock(const F& f, double t0, const double* y0, int n, double t1, const OdeOptions& opt, Observer& observe) {
+    OdeResult res;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const double d = 1.0 / (2.0 + std::sqrt(2.0)), e32 = 6.0 + std::sqrt(2.0);
+    const double dir  = t1 >= t0 ? 1.0 : -1.0;
+    const double hmax = opt.HMax > 0 ? opt.HMax : std::fabs(t1 - t0);
+    res.Dim = n;
+    res.Ts.push_back(t0);
+    res.Ys.insert(res.Ys.end(), y0, y0 + n);
+    std::vector<double> y(y0, y0 + n), f0(n), f1(n), f2(n), ft(n), dfdt(n), jac((size_t)n * n), lu((size_t)n * n);
+    std::vector<double> k1(n), k2(n), k3(n), tmp(n), ynew(n), err(n);
+    std::vector<int> piv(n);
+    f(t0, y0, f0.data());
+    res.Evaluations = 1;
+    if (opt.Dense)
+        res.Dys.insert(res.Dys.end(), f0.begin(), f0.end());
+    double h = opt.H > 0 ? opt.H : OdeInitialStep(f, t0, y0, f0.data(), n, 2, dir, opt, res.Evaluations);
+    h = std::fmin(h, hmax);
+    double t = t0;
+    bool need_jac = true;
+
+    while (dir * (t1 - t) > 0) {
+        if (res.Steps + res.Rejected >= opt.MaxSteps || h < opt.HMin) { res.Seconds = detail::Elapsed(start); return res; }
+        if (need_jac) {
+            OdeJacobian(f, t, y.data(), f0.data(), n, jac.data(), res.Evaluations);
+            ++res.Jacobians;
+            const double dt = std::sqrt(std::numeric_limits<double>::epsilon()) * std::fmax(std::fabs(t), 1.0);
+            f(t + dt, y.data(), ft.data());
+            ++res.Evaluations;
+            for (int i = 0; i < n; ++i) dfdt[i] = (ft[i] - f0[i]) / dt;
+            need_jac = false;
+        }
+        bool last = false;
+        if (h * (1 + 1e-9) >= std::fabs(t1 - t)) { h = std::fabs(t1 - t); last = true; }
+        const double hs = dir * h;
+        if (!detail::FactorNewtonMatrix(jac, hs * d, n, lu, piv, res.Factorizations)) {
+            ++res.Rejected;
+            h *= 0.5;
+            continue;
+        }
+        for (int i = 0; i < n; ++i) k1[i] = f0[i] + hs * d * dfdt[i];
+        detail::LUSolve(lu.data(), piv.data(), n, k1.data());
+        for (int i = 0; i < n; ++i) tmp[i] = y[i] + 0.5 * hs * k1[i];
+        f(t + 0.5 * hs, tmp.data(), f1.data());
+        for (int i = 0; i < n; ++i) k2[i] = f1[i] - k1[i];
+        detail::LUSolve(lu.data(), piv.data(), n, k2.data());
+        for (int i = 0; i < n; ++i) { k2[i] += k1[i]; ynew[i] = y[i] + hs * k2[i]; }
+        f(t + hs, ynew.data(), f2.data());
+        res.Evaluations += 2;
+        for (int i = 0; i < n; ++i) k3[i] = f2[i] - e32 * (k2[i] - f1[i]) - 2 * (k1[i] - f0[i]) + hs * d * dfdt[i];
+        detail::LUSolve(lu.data(), piv.data(), n, k3.data());
+        for (int i = 0; i < n; ++i) err[i] = hs / 6 * (k1[i] - 2 * k2[i] + k3[i]);
+        const double e = OdeErrorNorm(y.data(), ynew.data(), err.data(), n, opt);
+        const double fac = e == 0 ? 5.0 : std::fmin(5.0, std::fmax(0.2, 0.9 * std::pow(e, -1.0 / 3)));
+        if (!(e <= 1)) {
+            ++res.Rejected;
+            h *= std::isfinite(e) ? std::fmin(1.0, fac) : 0.5;
+            continue;
+        }
+        t = last ? t1 : t + hs;
+        y.swap(ynew);
+        f0.swap(f2);
+        ++res.Steps;
+        res.Ts.push_back(t);
+        res.Ys.insert(res.Ys.end(), y.begin(), y.end());
+        if (opt.Dense)
+            res.Dys.insert(res.Dys.end(), f0.begin(), f0.end());
+        if (!observe(res)) {
+            res.Stopped = true;
+            break;
+        }
+        h = std::fmin(h * fac, hmax);
+        need_jac = true;
+    }
+    res.Success = !res.Stopped;
+    res.Seconds = detail::Elapsed(start);
+    return res;
+}
+
+template <class F, class Observer>
+OdeResult SolveStiff(int method, const F& f, double t0, const double* y0, int n, double t1, const OdeOptions& opt, Observer& observe) {
+    switch (method) {
+    case StiffMethod_ImplicitEuler: return SolveBDF(f, t0, y0, n, t1, opt, 1, observe);
+    case StiffMethod_Rosenbrock:    return SolveRosenbrock(f, t0, y0, n, t1, opt, observe);
+    default:                        return SolveBDF(f, t0, y0, n, t1, opt, 5, observe);
+    }
+}
+
+template <class F>
+OdeResult SolveStiff(int method, const F& f, double t0, const double* y0, int n, double t1, const OdeOptions& opt = OdeOptions()) {
+    OdeNoObserver none;
+    return SolveStiff(method, f, t0, y0, n, t1, opt, none);
+}
+
+} // namespace Hamzstlab
@@ -0,0 +1,154 @@
+// Hamzstlab Mathematics: symplectic integrators for separable Hamiltonians
+//
+// H(q, p) = T(p) + V(q) is described by a system object
+//
+//   struct System {
+//       void   Velocity(const double* p, double* dq) const;       // dq/dt =  dT/dp
+//       void   Force(const double* q, double* dp) const;          // dp/dt = -dV/dq
+//       double Energy(const double* q, const double* p) const;    // H, for drift plots
+//   };
+//
+// and advanced with a fixed step by a SymplecticIntegrator:
+//
+//   Hamzstlab::SymplecticIntegrator<Pendulum> s;
+//   s.Init(Hamzstlab::SymplecticMethod_Yoshida4, Pendulum(), q0, p0, 1);
+//   s.Step(0.05, 1000);                   // 1000 steps; s.T, s.Q, s.P follow
+//   double drift = s.Energy() - s.Energy0;
+//
+// Leapfrog is the drift-kick-drift form and Stormer-Verlet the kick-drift-kick
+// (velocity Verlet) form of the same second order method. Yoshida 4 and 6
+// compose Verlet substeps with the weights of Yoshida (1990). All of them are
+// time-reversible and symplectic, so on a bounded orbit the energy error
+// oscillates instead of growing with the step count: 1e7 cheap fixed steps keep
+// H within O(h^order) where an explicit Runge-Kutta method slowly drifts away.
+// Verlet reuses the force of the previous step, so every substep costs one
+// Force call. SymplecticRhs wraps a system as y' = f(t, y) with y = (q, p) for
+// comparisons with hamzstlab_ode.h.
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+namespace Hamzstlab {
+
+enum SymplecticMethod {
+    SymplecticMethod_Leapfrog,
+    SymplecticMethod_Verlet,
+    SymplecticMethod_Yoshida4,
+    SymplecticMethod_Yoshida6,
+    SymplecticMethod_COUNT
+};
+
+inline const char* SymplecticMethodName(int method) {
+    static const char* names[] = { "Leapfrog", "Stormer-Verlet", "Yoshida 4", "Yoshida 6" };
+    return method >= 0 && method < SymplecticMethod_COUNT ? names[method] : "";
+}
+
+inline int SymplecticMethodOrder(int method) {
+    static const int orders[] = { 2, 2, 4, 6 };
+    return method >= 0 && method < SymplecticMethod_COUNT ? orders[method] : 0;
+}
+
+// Verlet substep weights of a method; they sum to one.
+inline int SymplecticWeights(int method, const double** w) {
+    static const double verlet[] = { 1 };
+    // x1 = 1 / (2 - 2^(1/3)), x0 = 1 - 2 x1
+    static const double yoshida4[] = { 1.3512071919596578, -1.7024143839193153, 1.3512071919596578 };
+    // solution A of Yoshida (1990), w0 = 1 - 2 (w1 + w2 + w3)
+    static const double yoshida6[] = { 0.784513610477560, 0.235573213359357, -1.17767998417887, 1.31518632068391,
+                                       -1.17767998417887, 0.235573213359357, 0.784513610477560 };
+    switch (method) {
+    case SymplecticMethod_Yoshida4: *w = yoshida4; return 3;
+    case SymplecticMethod_Yoshida6: *w = yoshida6; return 7;
+    default:                        *w = verlet;   return 1;
+    }
+}
+
+template <class S>
+class SymplecticIntegrator {
+public:
+    int                 Method;
+    int                 Dim;          // degrees of freedom: q and p have Dim entries each
+    double              T;
+    std::vector<double> Q, P;
+    double              Energy0;      // H at the initial state
+    long long           Steps, Evaluations;   // Force calls
+
+    SymplecticIntegrator() { Method = SymplecticMethod_Verlet; Dim = 0; T = 0; Energy0 = 0; Steps = Evaluations = 0; HaveForce = false; }
+
+    void Init(int method, const S& sys, const double* q0, const double* p0, int n, double t0 = 0) {
+        Method = method;
+        Sys = sys;
+        Dim = n;
+        T = t0;
+        Q.assign(q0, q0 + n);
+        P.assign(p0, p0 + n);
+        F.resize(n);
+        V.resize(n);
+        Steps = Evaluations = 0;
+        HaveForce = false;
+        Energy0 = Energy();
+    }
+
+    double Energy() const { return Sys.Energy(Q.data(), P.data()); }
+
+    // Advances `count` steps of size h.
+    void Step(double h, int count = 1) {
+        const int n = Dim;
+        double* q = Q.data();
+        double* p = P.data();
+        if (Method == SymplecticMethod_Leapfrog) {
+            for (int s = 0; s < count; ++s) {
+                Sys.Velocity(p, V.data());
+                for (int i = 0; i < n; ++i) q[i] += 0.5 * h * V[i];
+                Sys.Force(q, F.data());
+                for (int i = 0; i < n; ++i) p[i] += h * F[i];
+                Sys.Velocity(p, V.data());
+                for (int i = 0; i < n; ++i) q[i] += 0.5 * h * V[i];
+            }
+            Evaluations += count;
+            // F belongs to the midpoint, not to the current q
+            HaveForce = false;
+        }
+        else {
+            const double* w;
+            const int stages = SymplecticWeights(Method, &w);
+            if (!HaveForce) {
+                Sys.Force(q, F.data());
+                ++Evaluations;
+                HaveForce = true;
+            }
+            for (int s = 0; s < count; ++s)
+                for (int k = 0; k < stages; ++k) {
+                    const double hk = w[k] * h;
+                    for (int i = 0; i < n; ++i) p[i] += 0.5 * hk * F[i];
+                    Sys.Velocity(p, V.data());
+                    for (int i = 0; i < n; ++i) q[i] += hk * V[i];
+                    Sys.Force(q, F.data());
+                    for (int i = 0; i < n; ++i) p[i] += 0.5 * hk * F[i];
+                }
+            Evaluations += (long long)count * stages;
+        }
+        Steps += count;
+        T += count * h;
+    }
+
+private:
+    S                   Sys;
+    std::vector<double> F, V;
+    bool                HaveForce;    // F holds the force at the current q
+};
+
+// y' = f(t, y) form of a separable Hamiltonian with y = (q_1..q_n, p_1..p_n).
+template <class S>
+struct SymplecticRhs {
+    S   Sys;
+    int Dim;
+    void operator()(double, const double* y, double* dydt) const {
+        Sys.Velocity(y + Dim, dydt);
+        Sys.Force(y, dydt + Dim);
+    }
+};
+
+} // namespace Hamzstlab